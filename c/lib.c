@@ -60,6 +60,9 @@ SZ_DYNAMIC sz_capability_t sz_capabilities(void) {
     // Check for AVX512F (Function ID 7, EBX register)
     // https://github.com/llvm/llvm-project/blob/50598f0ff44f3a4e75706f8c53f3380fe7faa896/clang/lib/Headers/cpuid.h#L155
     unsigned supports_avx512f = (info7.named.ebx & 0x00010000) != 0;
+    // Check for AVX512DQ (Function ID 7, EBX register)
+    // https://github.com/llvm/llvm-project/blob/50598f0ff44f3a4e75706f8c53f3380fe7faa896/clang/lib/Headers/cpuid.h#L156
+    unsigned supports_avx512dq = (info7.named.ebx & 0x00020000) != 0;
     // Check for AVX512BW (Function ID 7, EBX register)
     // https://github.com/llvm/llvm-project/blob/50598f0ff44f3a4e75706f8c53f3380fe7faa896/clang/lib/Headers/cpuid.h#L166
     unsigned supports_avx512bw = (info7.named.ebx & 0x40000000) != 0;
@@ -78,6 +81,7 @@ SZ_DYNAMIC sz_capability_t sz_capabilities(void) {
         (sz_cap_x86_avx512f_k * supports_avx512f) |       //
         (sz_cap_x86_avx512vl_k * supports_avx512vl) |     //
         (sz_cap_x86_avx512bw_k * supports_avx512bw) |     //
+        (sz_cap_x86_avx512dq_k * supports_avx512dq) |     //
         (sz_cap_x86_avx512vbmi_k * supports_avx512vbmi) | //
         (sz_cap_x86_gfni_k * (supports_gfni)) |           //
         (sz_cap_serial_k));
@@ -120,6 +124,12 @@ typedef struct sz_implementations_t {
     sz_edit_distance_t edit_distance;
     sz_alignment_score_t alignment_score;
     sz_hashes_t hashes;
+    sz_hashes_t hashes_mersenne;
+    sz_hashes_into_t hashes_into;
+    sz_hashes_minhash_t hashes_minhash;
+    sz_hashes_simhash_t hashes_simhash;
+    sz_minhash_matches_t minhash_matches;
+    sz_hash_tape_t hash_tape;
 
 } sz_implementations_t;
 static sz_implementations_t sz_dispatch_table;
@@ -149,6 +159,12 @@ static void sz_dispatch_table_init(void) {
     impl->edit_distance = sz_edit_distance_serial;
     impl->alignment_score = sz_alignment_score_serial;
     impl->hashes = sz_hashes_serial;
+    impl->hashes_mersenne = sz_hashes_mersenne_serial;
+    impl->hashes_into = sz_hashes_into_serial;
+    impl->hashes_minhash = sz_hashes_minhash_serial;
+    impl->hashes_simhash = sz_hashes_simhash_serial;
+    impl->minhash_matches = sz_minhash_matches_serial;
+    impl->hash_tape = sz_hash_tape_serial;
 
 #if SZ_USE_X86_AVX2
     if (caps & sz_cap_x86_avx2_k) {
@@ -159,6 +175,9 @@ static void sz_dispatch_table_init(void) {
         impl->rfind_byte = sz_rfind_byte_avx2;
         impl->find = sz_find_avx2;
         impl->rfind = sz_rfind_avx2;
+        impl->hashes_mersenne = sz_hashes_mersenne_avx2;
+        impl->hashes_into = sz_hashes_into_avx2;
+        impl->hash_tape = sz_hash_tape_avx2;
     }
 #endif
 
@@ -178,6 +197,16 @@ static void sz_dispatch_table_init(void) {
         impl->edit_distance = sz_edit_distance_avx512;
     }
 
+    if ((caps & sz_cap_x86_avx512f_k) && (caps & sz_cap_x86_avx512vl_k) && (caps & sz_cap_x86_avx512bw_k) &&
+        (caps & sz_cap_x86_avx512dq_k)) {
+        impl->hashes_mersenne = sz_hashes_mersenne_avx512;
+        impl->hashes_into = sz_hashes_into_avx512;
+        impl->hashes_minhash = sz_hashes_minhash_avx512;
+        impl->hashes_simhash = sz_hashes_simhash_avx512;
+        impl->minhash_matches = sz_minhash_matches_avx512;
+        impl->hash_tape = sz_hash_tape_avx512;
+    }
+
     if ((caps & sz_cap_x86_avx512f_k) && (caps & sz_cap_x86_avx512vl_k) && (caps & sz_cap_x86_gfni_k) &&
         (caps & sz_cap_x86_avx512bw_k) && (caps & sz_cap_x86_avx512vbmi_k)) {
         impl->find_from_set = sz_find_charset_avx512;
@@ -194,6 +223,7 @@ static void sz_dispatch_table_init(void) {
         impl->rfind_byte = sz_rfind_byte_neon;
         impl->find_from_set = sz_find_charset_neon;
         impl->rfind_from_set = sz_rfind_charset_neon;
+        impl->hash_tape = sz_hash_tape_neon;
     }
 #endif
 }
@@ -273,6 +303,36 @@ SZ_DYNAMIC void sz_hashes(sz_cptr_t text, sz_size_t length, sz_size_t window_len
     sz_dispatch_table.hashes(text, length, window_length, step, callback, callback_handle);
 }
 
+SZ_DYNAMIC void sz_hashes_mersenne(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                   sz_hash_callback_t callback, void *callback_handle) {
+    sz_dispatch_table.hashes_mersenne(text, length, window_length, step, callback, callback_handle);
+}
+
+SZ_DYNAMIC sz_size_t sz_hashes_into(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                    sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                    sz_size_t capacity) {
+    return sz_dispatch_table.hashes_into(text, length, window_length, step, family, hashes, positions, capacity);
+}
+
+SZ_DYNAMIC void sz_hashes_minhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_hash_family_t family,
+                                  sz_u64_t *signature, sz_size_t signature_length) {
+    sz_dispatch_table.hashes_minhash(text, length, window_length, family, signature, signature_length);
+}
+
+SZ_DYNAMIC sz_u64_t sz_hashes_simhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                      sz_hash_family_t family) {
+    return sz_dispatch_table.hashes_simhash(text, length, window_length, family);
+}
+
+SZ_DYNAMIC void sz_minhash_matches(sz_u64_t const *query, sz_u64_t const *signatures, sz_size_t signatures_count,
+                                   sz_size_t signature_length, sz_size_t *matches) {
+    sz_dispatch_table.minhash_matches(query, signatures, signatures_count, signature_length, matches);
+}
+
+SZ_DYNAMIC void sz_hash_tape(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
+    sz_dispatch_table.hash_tape(start, offsets, count, hashes);
+}
+
 SZ_DYNAMIC sz_cptr_t sz_find_char_from(sz_cptr_t h, sz_size_t h_length, sz_cptr_t n, sz_size_t n_length) {
     sz_charset_t set;
     sz_charset_init(&set);
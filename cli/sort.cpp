@@ -0,0 +1,137 @@
+/**
+ *  @brief  External-memory `sort` for newline-delimited files larger than the RAM.
+ *  @file   sort.cpp
+ *
+ *  Sorts the records lexicographically by their bytes, like `LC_ALL=C sort`, spilling sorted runs
+ *  to temporary files and merging them. Compile with:
+ *
+ *      cmake -D STRINGZILLA_BUILD_CLI=1 -B build_release
+ *      cmake --build build_release --target sz_sort
+ *      build_release/sz_sort -S 4G -o sorted.txt input.txt
+ */
+#include <cstdio>  // `std::fopen`
+#include <cstdlib> // `std::strtoull`, `realpath`
+#include <cstring> // `std::strcmp`
+#include <string>  // `std::string`
+
+#include <sys/stat.h> // `stat`
+
+#include <stringzilla/stringzilla.hpp>
+
+namespace sz = ashvardanian::stringzilla;
+
+static void print_usage(char const *name) {
+    std::fprintf(stderr,
+                 "Usage: %s [-S SIZE] [-t SEP] [-o OUTPUT] [FILE]\n"
+                 "Sort the lines of FILE, or of the standard input, by their bytes.\n\n"
+                 "  -S SIZE    memory for a single sorted run, with an optional K, M, or G suffix, default 1G\n"
+                 "  -t SEP     use the character SEP instead of newline as the record separator, '\\0' for NUL\n"
+                 "  -o OUTPUT  write the result to OUTPUT instead of the standard output\n",
+                 name);
+}
+
+static bool parse_size(char const *text, std::size_t &size) {
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (end == text) return false;
+    switch (*end) {
+    case 'K': case 'k': value <<= 10, ++end; break;
+    case 'M': case 'm': value <<= 20, ++end; break;
+    case 'G': case 'g': value <<= 30, ++end; break;
+    default: break;
+    }
+    size = static_cast<std::size_t>(value);
+    return *end == '\0' && value != 0;
+}
+
+int main(int argc, char const **argv) {
+    sz::external_sort_config config;
+    char const *input_path = nullptr;
+    char const *output_path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "-S") == 0 && has_value) {
+            if (!parse_size(argv[++i], config.memory_limit)) {
+                std::fprintf(stderr, "Invalid memory size: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && has_value) {
+            char const *separator = argv[++i];
+            if (std::strcmp(separator, "\\0") == 0) { config.separator = '\0'; }
+            else if (separator[0] != '\0' && separator[1] == '\0') { config.separator = separator[0]; }
+            else {
+                std::fprintf(stderr, "The separator must be a single character: '%s'\n", separator);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "-o") == 0 && has_value) { output_path = argv[++i]; }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else if (!input_path) { input_path = argv[i]; }
+        else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::FILE *input = input_path && std::strcmp(input_path, "-") != 0 ? std::fopen(input_path, "rb") : stdin;
+    if (!input) {
+        std::fprintf(stderr, "No such file: %s\n", input_path);
+        return EXIT_FAILURE;
+    }
+    // Regular output files are written into a temporary file next to them, renamed over the output only once
+    // it's complete. So a failure never truncates the output, which may be the input under another path or link.
+    // Other outputs, like devices and pipes, can't be replaced, so those are written directly.
+    // Symbolic links are resolved to replace their targets, but hard links to the output are detached from it.
+    struct stat output_stat;
+    bool const output_exists = output_path && ::stat(output_path, &output_stat) == 0;
+    bool const is_replaced = output_path && (!output_exists || (output_stat.st_mode & S_IFMT) == S_IFREG);
+    std::string replaced_path = is_replaced ? std::string(output_path) : std::string();
+#if !defined(_WIN32)
+    if (is_replaced && output_exists) {
+        if (char *resolved = ::realpath(output_path, nullptr)) replaced_path = resolved, std::free(resolved);
+    }
+#endif
+    std::string const temporary_path = is_replaced ? replaced_path + ".sz_sort.tmp" : std::string();
+    bool keep_temporary = false;
+    int result = EXIT_SUCCESS;
+    std::FILE *output = stdout;
+    try {
+        if (output_path && !(output = std::fopen(is_replaced ? temporary_path.c_str() : output_path, "wb")))
+            throw std::runtime_error("Failed to open the output file");
+        sz::external_sort(input, output, config);
+        if (std::fflush(output) != 0 || std::ferror(output)) throw std::runtime_error("Failed to write the output");
+        if (output != stdout) {
+            std::FILE *closed = output;
+            output = nullptr;
+            if (std::fclose(closed) != 0) throw std::runtime_error("Failed to write the output");
+        }
+        if (is_replaced) {
+            if (input != stdin) std::fclose(input), input = stdin;
+#if !defined(_WIN32)
+            if (output_exists) ::chmod(temporary_path.c_str(), output_stat.st_mode & 07777);
+#endif
+            if (std::rename(temporary_path.c_str(), replaced_path.c_str()) != 0) {
+                // Unlike POSIX, Windows doesn't replace existing files on rename.
+                if (std::remove(replaced_path.c_str()) != 0)
+                    throw std::runtime_error("Failed to replace the output file");
+                if (std::rename(temporary_path.c_str(), replaced_path.c_str()) != 0) {
+                    keep_temporary = true;
+                    throw std::runtime_error("Failed to rename the sorted " + temporary_path);
+                }
+            }
+        }
+    }
+    catch (std::exception const &e) {
+        std::fprintf(stderr, "Sorting failed: %s\n", e.what());
+        result = EXIT_FAILURE;
+        if (output && output != stdout) std::fclose(output);
+        if (is_replaced && !keep_temporary) std::remove(temporary_path.c_str());
+    }
+    if (input != stdin) std::fclose(input);
+    return result;
+}
@@ -78,6 +78,7 @@
 #define SZ_SIZE_MAX (0xFFFFFFFFu)  // Largest unsigned integer that fits into 32 bits.
 #define SZ_SSIZE_MAX (0x7FFFFFFFu) // Largest signed integer that fits into 32 bits.
 #endif
+#define SZ_U64_MAX (0xFFFFFFFFFFFFFFFFull) // Largest unsigned 64-bit integer, independent of the pointer size.
 
 /**
  *  @brief  On Big-Endian machines StringZilla will work in compatibility mode.
@@ -234,6 +235,7 @@ typedef enum sz_capability_t {
     sz_cap_x86_avx512vl_k = 1 << 23,   /// x86 AVX512 VL instruction capability
     sz_cap_x86_avx512vbmi_k = 1 << 24, /// x86 AVX512 VBMI instruction capability
     sz_cap_x86_gfni_k = 1 << 25,       /// x86 AVX512 GFNI instruction capability
+    sz_cap_x86_avx512dq_k = 1 << 26,   /// x86 AVX512 DQ instruction capability
 
 } sz_capability_t;
 
@@ -379,6 +381,7 @@ typedef union sz_string_t {
 } sz_string_t;
 
 typedef sz_u64_t (*sz_hash_t)(sz_cptr_t, sz_size_t);
+typedef void (*sz_hash_tape_t)(sz_cptr_t, sz_u32_t const *, sz_size_t, sz_u64_t *);
 typedef sz_bool_t (*sz_equal_t)(sz_cptr_t, sz_cptr_t, sz_size_t);
 typedef sz_ordering_t (*sz_order_t)(sz_cptr_t, sz_size_t, sz_cptr_t, sz_size_t);
 typedef void (*sz_to_converter_t)(sz_cptr_t, sz_size_t, sz_ptr_t);
@@ -399,6 +402,23 @@ SZ_PUBLIC sz_u64_t sz_hash(sz_cptr_t text, sz_size_t length);
 /** @copydoc sz_hash */
 SZ_PUBLIC sz_u64_t sz_hash_serial(sz_cptr_t text, sz_size_t length);
 
+/**
+ *  @brief  Computes the `sz_hash` of every string in an Arrow-like "tape" of concatenated strings.
+ *          Interleaves several short strings per SIMD register, hiding the latency of the multiply-add
+ *          chain and avoiding the per-call overhead, when hashing millions of small keys.
+ *
+ *  @param start    Pointer to the first byte of the tape.
+ *  @param offsets  Array of `count + 1` offsets, with the i-th string spanning `[offsets[i], offsets[i + 1])`.
+ *  @param count    Number of strings in the tape.
+ *  @param hashes   Output array of `count` hashes, bit-identical to calling `sz_hash` on every string.
+ *
+ *  @see    sz_hash
+ */
+SZ_DYNAMIC void sz_hash_tape(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes);
+
+/** @copydoc sz_hash_tape */
+SZ_PUBLIC void sz_hash_tape_serial(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes);
+
 /**
  *  @brief  Checks if two string are equal.
  *          Similar to `memcmp(a, b, length) == 0` in LibC and `a == b` in STL.
@@ -912,6 +932,96 @@ SZ_PUBLIC void sz_hashes_serial(sz_cptr_t text, sz_size_t length, sz_size_t wind
 
 typedef void (*sz_hashes_t)(sz_cptr_t, sz_size_t, sz_size_t, sz_size_t, sz_hash_callback_t, void *);
 
+/**
+ *  @brief  Computes the rolling hashes of a string, similar to `sz_hashes`, but modulo the `2^61 - 1` Mersenne prime.
+ *          Modulo reduction by it only needs shifts and additions, and the removal of the oldest character
+ *          only needs 32-bit multiplications, so the hashes are much cheaper to compute with and without SIMD.
+ *          Every backend reports identical hashes, but the order of callbacks may differ.
+ *
+ *  @param text             String to hash.
+ *  @param length           Number of bytes in the string.
+ *  @param window_length    Length of the rolling window in bytes.
+ *  @param window_step      Step of reported hashes. @b Must be power of two. Should be smaller than `window_length`.
+ *  @param callback         Function receiving the start & length of a substring, the hash, and the `callback_handle`.
+ *  @param callback_handle  Optional user-provided pointer to be passed to the `callback`.
+ *  @see                    sz_hashes, sz_hashes_with_family
+ */
+SZ_DYNAMIC void sz_hashes_mersenne(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step, //
+                                   sz_hash_callback_t callback, void *callback_handle);
+
+/** @copydoc sz_hashes_mersenne */
+SZ_PUBLIC void sz_hashes_mersenne_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                         sz_size_t window_step, sz_hash_callback_t callback, void *callback_handle);
+
+/**
+ *  @brief  Families of rolling hash functions, that can be selected for every `sz_hashes_with_family` call.
+ */
+typedef enum sz_hash_family_t {
+    /** Default family matching `sz_hashes`, with polynomials modulo the largest 64-bit prime. */
+    sz_hash_family_prime_k = 0,
+    /** Division-free family matching `sz_hashes_mersenne`, with polynomials modulo `2^61 - 1`. */
+    sz_hash_family_mersenne_k = 1,
+} sz_hash_family_t;
+
+/**
+ *  @brief  Computes the rolling hashes of a string, using the chosen family of hash functions.
+ *  @see    sz_hashes, sz_hashes_mersenne
+ */
+SZ_PUBLIC void sz_hashes_with_family(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step,
+                                     sz_hash_family_t family, sz_hash_callback_t callback, void *callback_handle);
+
+/**
+ *  @brief  Computes the rolling hashes of a string, similar to `sz_hashes_with_family`, but writing them into
+ *          a caller-provided array instead of invoking a callback per window. The hashes are exported in the
+ *          order of windows, identical for every backend, so a long input can be processed in blocks,
+ *          resuming from `text + count * window_step` with the remaining `length - count * window_step` bytes.
+ *
+ *  @param text             String to hash.
+ *  @param length           Number of bytes in the string.
+ *  @param window_length    Length of the rolling window in bytes.
+ *  @param window_step      Step of reported hashes. @b Must be power of two.
+ *  @param family           Family of hash functions to use.
+ *  @param hashes           Output array for at least ::capacity hashes.
+ *  @param positions        Optional output array for the offsets of windows in the ::text, can be NULL.
+ *  @param capacity         Maximum number of hashes to export.
+ *  @return                 Number of exported hashes.
+ *  @see                    sz_hashes, sz_hashes_winnow
+ */
+SZ_DYNAMIC sz_size_t sz_hashes_into(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step,
+                                    sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                    sz_size_t capacity);
+
+/** @copydoc sz_hashes_into */
+SZ_PUBLIC sz_size_t sz_hashes_into_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                          sz_size_t window_step, sz_hash_family_t family, sz_u64_t *hashes,
+                                          sz_size_t *positions, sz_size_t capacity);
+
+typedef sz_size_t (*sz_hashes_into_t)(sz_cptr_t, sz_size_t, sz_size_t, sz_size_t, sz_hash_family_t, sz_u64_t *,
+                                      sz_size_t *, sz_size_t);
+
+/**
+ *  @brief  Selects the smallest rolling hash in every run of ::winnow_length consecutive windows,
+ *          also known as "winnowing" or "minimizers". Each selected hash is exported once, when it first
+ *          becomes the minimum. Ties are broken in favor of the previously selected window, if it is still in the
+ *          run, and then in favor of the rightmost one, also known as "robust winnowing". If the string has fewer
+ *          than ::winnow_length windows, the minimum of all of them is exported.
+ *
+ *  @param text             String to hash.
+ *  @param length           Number of bytes in the string.
+ *  @param window_length    Length of the rolling window in bytes.
+ *  @param winnow_length    Number of consecutive windows to select the minimum from.
+ *  @param family           Family of hash functions to use.
+ *  @param hashes           Output array for at least ::capacity hashes.
+ *  @param positions        Optional output array for the offsets of selected windows in the ::text, can be NULL.
+ *  @param capacity         Maximum number of hashes to export.
+ *  @param alloc            Temporary memory allocator. Can be NULL.
+ *  @return                 Number of exported hashes, or `SZ_SIZE_MAX` if the memory allocation failed.
+ *  @see                    sz_hashes_into
+ */
+SZ_PUBLIC sz_size_t sz_hashes_winnow(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                     sz_size_t winnow_length, sz_hash_family_t family, sz_u64_t *hashes,
+                                     sz_size_t *positions, sz_size_t capacity, sz_memory_allocator_t *alloc);
+
 /**
  *  @brief  Computes the Karp-Rabin rolling hashes of a string outputting a binary fingerprint.
  *          Such fingerprints can be compared with Hamming or Jaccard (Tanimoto) distance for similarity.
@@ -955,6 +1065,270 @@ SZ_PUBLIC sz_size_t sz_hashes_intersection(sz_cptr_t text, sz_size_t length, sz_
 
 typedef sz_size_t (*sz_hashes_intersection_t)(sz_cptr_t, sz_size_t, sz_size_t, sz_cptr_t, sz_size_t);
 
+/**
+ *  @brief  State of a content-defined chunker, that can be fed with consecutive parts of a stream.
+ *          Initialize it with `sz_chunker_init` and pass to `sz_chunk_boundaries`.
+ */
+typedef struct sz_chunker_t {
+    sz_size_t min_length;
+    sz_size_t average_length;
+    sz_size_t max_length;
+    sz_u64_t mask_strict;   // Applied to chunks shorter than the `average_length`.
+    sz_u64_t mask_relaxed;  // Applied to chunks longer than the `average_length`.
+    sz_u64_t hash;          // Gear hash of the last 64 bytes of the stream.
+    sz_size_t chunk_length; // Number of bytes in the current unfinished chunk.
+} sz_chunker_t;
+
+/**
+ *  @brief  Initializes the state of a FastCDC content-defined chunker.
+ *
+ *  Chunk boundaries are placed after bytes, where the Gear hash of the last 64 bytes has all of the top bits
+ *  of a mask set to zero. Following the "normalized chunking" of FastCDC, a stricter mask is used until
+ *  the chunk reaches the ::average_length, and a more relaxed one after, concentrating the lengths around it.
+ *  Unlike the original FastCDC, the hash doesn't restart on every boundary, so the boundaries only depend on
+ *  the last 64 bytes, and the streams resynchronize quickly after edits.
+ *
+ *  @param chunker              Chunker state to initialize.
+ *  @param min_length           Minimum length of a chunk in bytes, at least 1.
+ *  @param average_length       Desired average length of a chunk in bytes, rounded down to a power of two.
+ *  @param max_length           Maximum length of a chunk in bytes.
+ *  @param normalization        Normalization level, the number of bits added and removed from the masks, from 0 to 3.
+ *  @see                        sz_chunk_boundaries
+ */
+SZ_PUBLIC void sz_chunker_init(sz_chunker_t *chunker, sz_size_t min_length, sz_size_t average_length,
+                               sz_size_t max_length, sz_size_t normalization);
+
+/**
+ *  @brief  Finds content-defined chunk boundaries in the next part of a stream.
+ *          Can be used for deduplication, incremental backups, and synchronization of large files.
+ *
+ *  The input may be split into parts of any size, producing the same boundaries as if it was passed at once.
+ *  After the end of the stream, the remaining `chunker->chunk_length` bytes form the last chunk.
+ *
+ *  @param chunker          Initialized chunker state, updated after the call.
+ *  @param text             Next part of the stream.
+ *  @param length           Number of bytes in the part.
+ *  @param boundaries       Output array for the exclusive end offsets of chunks, relative to the ::text.
+ *  @param capacity         Maximum number of boundaries to export. If it's reached, the scan stops right after
+ *                          the last boundary, and the caller can resume from `text + boundaries[capacity - 1]`.
+ *  @return                 Number of exported boundaries.
+ *  @see                    sz_chunker_init
+ */
+SZ_PUBLIC sz_size_t sz_chunk_boundaries(sz_chunker_t *chunker, sz_cptr_t text, sz_size_t length,
+                                        sz_size_t *boundaries, sz_size_t capacity);
+
+/**
+ *  @brief  Updates a k-permutation MinHash signature of a string with the rolling hashes of its windows.
+ *          Every slot of the signature keeps the minimum of a different permutation of the window hashes,
+ *          and the share of equal slots in two signatures estimates the Jaccard similarity of the documents.
+ *
+ *  The algorithm doesn't clear the signature on start, so it must be initialized with `SZ_U64_MAX` values
+ *  for a new document, or can be reused to update the signature of a longer document with more parts.
+ *  Every backend produces identical signatures.
+ *
+ *  @param text             String to hash.
+ *  @param length           Number of bytes in the string.
+ *  @param window_length    Length of the rolling window in bytes.
+ *  @param family           Family of hash functions to use.
+ *  @param signature        Signature to update, with one slot per permutation.
+ *  @param signature_length Number of permutations and slots in the signature.
+ *  @see                    sz_minhash_matches, sz_minhash_bands, sz_hashes_simhash
+ */
+SZ_DYNAMIC void sz_hashes_minhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_hash_family_t family,
+                                  sz_u64_t *signature, sz_size_t signature_length);
+
+/** @copydoc sz_hashes_minhash */
+SZ_PUBLIC void sz_hashes_minhash_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                        sz_hash_family_t family, sz_u64_t *signature, sz_size_t signature_length);
+
+typedef void (*sz_hashes_minhash_t)(sz_cptr_t, sz_size_t, sz_size_t, sz_hash_family_t, sz_u64_t *, sz_size_t);
+
+/**
+ *  @brief  Computes the 64-bit SimHash of a string, where every bit is set if it's set in the majority
+ *          of rolling hashes of the windows. The Hamming distance between two SimHashes estimates
+ *          the cosine distance of the documents, and can be computed with a single `popcount`.
+ *
+ *  @param text             String to hash.
+ *  @param length           Number of bytes in the string.
+ *  @param window_length    Length of the rolling window in bytes.
+ *  @param family           Family of hash functions to use.
+ *  @return                 64-bit SimHash, zero if the string is shorter than the window.
+ *  @see                    sz_hashes_minhash
+ */
+SZ_DYNAMIC sz_u64_t sz_hashes_simhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                      sz_hash_family_t family);
+
+/** @copydoc sz_hashes_simhash */
+SZ_PUBLIC sz_u64_t sz_hashes_simhash_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                            sz_hash_family_t family);
+
+typedef sz_u64_t (*sz_hashes_simhash_t)(sz_cptr_t, sz_size_t, sz_size_t, sz_hash_family_t);
+
+/**
+ *  @brief  Compares one MinHash signature against a batch of others, counting the number of equal slots.
+ *          Dividing the counts by the ::signature_length gives the estimated Jaccard similarities.
+ *
+ *  @param query            Signature to compare against.
+ *  @param signatures       Contiguous array of ::signatures_count signatures, each ::signature_length long.
+ *  @param signatures_count Number of signatures in the batch.
+ *  @param signature_length Number of slots in every signature.
+ *  @param matches          Output array for ::signatures_count numbers of matching slots.
+ *  @see                    sz_hashes_minhash
+ */
+SZ_DYNAMIC void sz_minhash_matches(sz_u64_t const *query, sz_u64_t const *signatures, sz_size_t signatures_count,
+                                   sz_size_t signature_length, sz_size_t *matches);
+
+/** @copydoc sz_minhash_matches */
+SZ_PUBLIC void sz_minhash_matches_serial(sz_u64_t const *query, sz_u64_t const *signatures,
+                                         sz_size_t signatures_count, sz_size_t signature_length, sz_size_t *matches);
+
+typedef void (*sz_minhash_matches_t)(sz_u64_t const *, sz_u64_t const *, sz_size_t, sz_size_t, sz_size_t *);
+
+/**
+ *  @brief  Splits a MinHash signature into bands of ::band_length slots and hashes each band for
+ *          Locality Sensitive Hashing. Documents sharing any band hash are candidates for near-duplicates,
+ *          so they can be grouped with a hash-table instead of comparing all pairs of signatures.
+ *          The band index is mixed into its hash, so all bands of all documents can share one table.
+ *
+ *  @param signature        MinHash signature.
+ *  @param signature_length Number of slots in the signature.
+ *  @param band_length      Number of slots in every band. Trailing slots, not forming a full band, are ignored.
+ *  @param band_hashes      Output array for `signature_length / band_length` band hashes.
+ *  @see                    sz_hashes_minhash
+ */
+SZ_PUBLIC void sz_minhash_bands(sz_u64_t const *signature, sz_size_t signature_length, sz_size_t band_length,
+                                sz_u64_t *band_hashes);
+
+/**
+ *  @brief  Extracts the k-mers of a DNA sequence, packed into 64-bit integers with 2 bits per nucleotide.
+ *          The nucleotides 'A', 'C', 'G', 'T' are encoded as 0, 1, 2, 3 respectively, ignoring the case.
+ *          Any other character, like 'N', breaks the sequence, and no k-mer containing it is exported.
+ *
+ *  @param text         DNA sequence.
+ *  @param length       Number of bytes in the sequence.
+ *  @param k            Number of nucleotides in a k-mer, from 1 to 32.
+ *  @param canonical    If set, the smaller of the k-mer and its reverse complement is exported.
+ *  @param kmers        Output array for the packed k-mers.
+ *  @param positions    Optional output array for the offsets of k-mers in the ::text, can be NULL.
+ *  @param capacity     Maximum number of k-mers to export.
+ *  @return             Number of exported k-mers.
+ *  @see                sz_kmers_count, sz_minimizers
+ */
+SZ_PUBLIC sz_size_t sz_kmers(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_bool_t canonical, sz_u64_t *kmers,
+                             sz_size_t *positions, sz_size_t capacity);
+
+/**
+ *  @brief  Counts the distinct k-mers of a DNA sequence, using an open-addressing hash-table.
+ *          The k-mers are exported packed, like in `sz_kmers`, in the order of their first occurrence.
+ *          If there are more than ::capacity distinct k-mers, the following ones are ignored.
+ *
+ *  @param text         DNA sequence.
+ *  @param length       Number of bytes in the sequence.
+ *  @param k            Number of nucleotides in a k-mer, from 1 to 32.
+ *  @param canonical    If set, the k-mers and their reverse complements are counted together.
+ *  @param kmers        Output array for the distinct packed k-mers.
+ *  @param counts       Output array for the number of occurrences of every k-mer.
+ *  @param capacity     Maximum number of distinct k-mers to export.
+ *  @param alloc        Temporary memory allocator. Can be NULL.
+ *  @return             Number of distinct k-mers, or `SZ_SIZE_MAX` if the memory allocation failed.
+ *  @see                sz_kmers
+ */
+SZ_PUBLIC sz_size_t sz_kmers_count(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_bool_t canonical,
+                                   sz_u64_t *kmers, sz_size_t *counts, sz_size_t capacity,
+                                   sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Selects the minimizers of a DNA sequence - the k-mers with the smallest hash in every run of
+ *          ::w consecutive k-mers, following the same robust winnowing rules as `sz_hashes_winnow`.
+ *          The k-mers are packed, like in `sz_kmers`, and mixed with an invertible hash function,
+ *          to avoid preferring low-complexity k-mers, like "AAAA...". Sequences separated by non-ACGT
+ *          characters are processed independently, and the ones with fewer than ::w k-mers export
+ *          the minimum of all their k-mers.
+ *
+ *          There is no SIMD backend. Rolling the 2-bit k-mers is a serial dependency chain, and which of
+ *          the equal hashes gets selected depends on the earlier windows, so the selection stays serial too.
+ *
+ *  @param text         DNA sequence.
+ *  @param length       Number of bytes in the sequence.
+ *  @param k            Number of nucleotides in a k-mer, from 1 to 32.
+ *  @param w            Number of consecutive k-mers to select the minimizer from.
+ *  @param canonical    If set, the smaller of the k-mer and its reverse complement is hashed, so the minimizers
+ *                      of a sequence and its reverse complement match.
+ *  @param hashes       Output array for the hashes of minimizers.
+ *  @param positions    Optional output array for the offsets of minimizers in the ::text, can be NULL.
+ *  @param capacity     Maximum number of minimizers to export.
+ *  @param alloc        Temporary memory allocator. Can be NULL.
+ *  @return             Number of exported minimizers, or `SZ_SIZE_MAX` if the memory allocation failed.
+ *  @see                sz_kmers, sz_hashes_winnow
+ */
+SZ_PUBLIC sz_size_t sz_minimizers(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_size_t w, sz_bool_t canonical,
+                                  sz_u64_t *hashes, sz_size_t *positions, sz_size_t capacity,
+                                  sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Packs a DNA sequence into 2 bits per nucleotide, mapping 'A', 'C', 'G', 'T' to 0, 1, 2, 3,
+ *          ignoring the case. The first nucleotide occupies the lowest bits of the first byte.
+ *          Other characters, like 'N', are packed as 'A' and marked in the optional ::n_mask bitset.
+ *
+ *  @param text         DNA sequence.
+ *  @param length       Number of bytes in the sequence.
+ *  @param packed       Output buffer for at least `(length + 3) / 4` bytes.
+ *  @param n_mask       Optional output bitset for at least `(length + 7) / 8` bytes, can be NULL.
+ *  @return             Number of non-ACGT characters in the sequence.
+ *  @see                sz_nucleotides_unpack
+ */
+SZ_PUBLIC sz_size_t sz_nucleotides_pack(sz_cptr_t text, sz_size_t length, sz_ptr_t packed, sz_ptr_t n_mask);
+
+/**
+ *  @brief  Unpacks a 2-bit packed DNA sequence into uppercase 'A', 'C', 'G', 'T' characters,
+ *          and 'N' for the nucleotides marked in the optional ::n_mask bitset.
+ *
+ *  @param packed       Packed sequence, produced by `sz_nucleotides_pack`.
+ *  @param n_mask       Optional bitset of unknown nucleotides, can be NULL.
+ *  @param length       Number of nucleotides in the sequence.
+ *  @param text         Output buffer for ::length characters.
+ *  @see                sz_nucleotides_pack
+ */
+SZ_PUBLIC void sz_nucleotides_unpack(sz_cptr_t packed, sz_cptr_t n_mask, sz_size_t length, sz_ptr_t text);
+
+/**
+ *  @brief  Counts the number of different nucleotides in two 2-bit packed sequences of equal length,
+ *          comparing 32 nucleotides at a time. Nucleotides marked as unknown are compared as 'A'.
+ *
+ *  @param a            First packed sequence.
+ *  @param b            Second packed sequence.
+ *  @param length       Number of nucleotides in both sequences.
+ *  @return             Number of mismatching nucleotides.
+ *  @see                sz_hamming_distance
+ */
+SZ_PUBLIC sz_size_t sz_nucleotides_hamming(sz_cptr_t a, sz_cptr_t b, sz_size_t length);
+
+/**
+ *  @brief  Computes the reverse complement of a 2-bit packed sequence, 32 nucleotides at a time.
+ *          The ::n_mask of the result, if needed, is the bit-reversed mask of the input.
+ *
+ *  @param packed       Packed sequence.
+ *  @param length       Number of nucleotides in the sequence.
+ *  @param result       Output buffer for `(length + 3) / 4` bytes, must not overlap with the input.
+ *  @see                sz_nucleotides_pack
+ */
+SZ_PUBLIC void sz_nucleotides_reverse_complement(sz_cptr_t packed, sz_size_t length, sz_ptr_t result);
+
+/**
+ *  @brief  Finds the first occurrence of a packed needle in a packed haystack, comparing up to
+ *          32 nucleotides of the needle at every offset with a single 64-bit operation.
+ *
+ *  @param haystack     Packed haystack.
+ *  @param h_length     Number of nucleotides in the haystack.
+ *  @param h_mask       Optional bitset of unknown nucleotides in the haystack, that never match, can be NULL.
+ *  @param needle       Packed needle.
+ *  @param n_length     Number of nucleotides in the needle.
+ *  @return             Offset of the match in nucleotides, or `SZ_SIZE_MAX` if there is none.
+ *  @see                sz_find
+ */
+SZ_PUBLIC sz_size_t sz_nucleotides_find(sz_cptr_t haystack, sz_size_t h_length, sz_cptr_t h_mask, sz_cptr_t needle,
+                                        sz_size_t n_length);
+
 #pragma endregion
 
 #pragma region Convenience API
@@ -1031,13 +1405,47 @@ SZ_PUBLIC void sz_sequence_from_u64tape(sz_cptr_t *start, sz_u64_t const *offset
 SZ_PUBLIC sz_size_t sz_partition(sz_sequence_t *sequence, sz_sequence_predicate_t predicate);
 
 /**
- *  @brief  Inplace `std::set_union` for two consecutive chunks forming the same continuous `sequence`.
+ *  @brief  Inplace stable `std::inplace_merge` for two consecutive sorted chunks forming the same `sequence`.
+ *          Uses `sz_merge_buffered` with the default allocator, falling back to the quadratic
+ *          element-shifting merge, if the memory allocation fails.
  *
  *  @param partition The number of elements in the first sub-sequence in `sequence`.
  *  @param less Comparison function, to determine the lexicographic ordering.
  */
 SZ_PUBLIC void sz_merge(sz_sequence_t *sequence, sz_size_t partition, sz_sequence_comparator_t less);
 
+/**
+ *  @brief  Linear-time stable merge of two consecutive sorted chunks forming the same `sequence`.
+ *          Moves the shorter chunk into a scratch buffer and merges towards the other end, performing
+ *          at most `sequence->count - 1` comparisons.
+ *
+ *  @param sequence     Sequence with two sorted chunks in its `order`.
+ *  @param partition    The number of elements in the first sub-sequence in `sequence`.
+ *  @param less         Comparison function, to determine the lexicographic ordering.
+ *  @param buffer       Optional scratch space for `min(partition, sequence->count - partition)` entries, can be NULL.
+ *  @param alloc        Allocator for the scratch space, if no ::buffer is provided. Can be NULL.
+ *  @return             Whether the merge succeeded, or failed to allocate the scratch space.
+ */
+SZ_PUBLIC sz_bool_t sz_merge_buffered(sz_sequence_t *sequence, sz_size_t partition, sz_sequence_comparator_t less,
+                                      sz_sorted_idx_t *buffer, sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Stable k-way merge of many consecutive sorted chunks of the same `sequence` into a separate output,
+ *          using a binary heap of chunk heads, performing O(N * logK) comparisons. Equal elements keep
+ *          the order of their chunks. The building block for parallel and external sorting.
+ *
+ *  @param sequence     Sequence with sorted chunks in its `order`.
+ *  @param offsets      Offsets of the chunks in the `sequence->order`, with `count + 1` entries.
+ *  @param count        Number of sorted chunks.
+ *  @param less         Comparison function, to determine the lexicographic ordering.
+ *  @param output       Output array for the `offsets[count] - offsets[0]` merged `order` entries.
+ *  @param alloc        Allocator for the heap of ::count entries. Can be NULL.
+ *  @return             Whether the merge succeeded, or failed to allocate the heap.
+ */
+SZ_PUBLIC sz_bool_t sz_merge_many(sz_sequence_t const *sequence, sz_size_t const *offsets, sz_size_t count,
+                                  sz_sequence_comparator_t less, sz_sorted_idx_t *output,
+                                  sz_memory_allocator_t *alloc);
+
 /**
  *  @brief  Sorting algorithm, combining Radix Sort for the first 32 bits of every word
  *          and a follow-up by a more conventional sorting procedure on equally prefixed parts.
@@ -1045,16 +1453,263 @@ SZ_PUBLIC void sz_merge(sz_sequence_t *sequence, sz_size_t partition, sz_sequenc
 SZ_PUBLIC void sz_sort(sz_sequence_t *sequence);
 
 /**
- *  @brief  Partial sorting algorithm, combining Radix Sort for the first 32 bits of every word
- *          and a follow-up by a more conventional sorting procedure on equally prefixed parts.
+ *  @brief  Partial sorting algorithm, similar to `std::partial_sort`, placing the ::n smallest strings
+ *          in the head of the `sequence->order` in sorted order, and the rest after them in arbitrary order.
+ *          Combines Radix Sort for the first 32 bits of every word, skipping the buckets beyond the head,
+ *          and a heap-selection on the bucket crossing its boundary, costing O(N * logK) comparisons.
  */
 SZ_PUBLIC void sz_sort_partial(sz_sequence_t *sequence, sz_size_t n);
 
+/**
+ *  @brief  Stable sorting algorithm, similar to `std::stable_sort`, keeping the equal strings in the relative
+ *          order of their incoming `sequence->order` entries. So a permutation, sorted by one column, can be
+ *          re-sorted by the next one for multi-column ordering. Sorts the incoming positions with `sz_sort`,
+ *          reading the strings through a copy of the incoming order, and then takes a single pass over the
+ *          neighboring entries, sorting the positions within every run of equal strings.
+ *
+ *  @param sequence     Sequence to sort, with any initial `order`.
+ *  @param alloc        Allocator for the copy of the incoming `order`. Can be NULL.
+ *  @return             Whether the sort succeeded, or failed to allocate memory.
+ */
+SZ_PUBLIC sz_bool_t sz_sort_stable(sz_sequence_t *sequence, sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Collation rules for `sz_order_collated` and `sz_sort_collated`, altering the binary byte order.
+ *  @see    sz_collation_ranks_case_fold
+ */
+typedef struct sz_collation_t {
+    /**
+     *  @brief  Optional table of 256 ranks, compared instead of the bytes themselves, like a case-folding one.
+     *          Bytes with equal ranks are considered equal. If NULL, the bytes are compared as unsigned integers.
+     */
+    sz_u8_t const *ranks;
+    /**
+     *  @brief  Whether the runs of decimal digits are compared by their numeric values, as in "file2" < "file10".
+     *          Leading zeros are ignored. Against other characters, a run of digits is ranked as its lowest-ranked
+     *          digit, preceding the characters of the same rank.
+     */
+    sz_bool_t natural;
+} sz_collation_t;
+
+/**
+ *  @brief  Populates a table of 256 ranks for the ASCII case-insensitive `sz_collation_t`,
+ *          mapping the uppercase letters to lowercase ones, and leaving all other bytes intact.
+ */
+SZ_PUBLIC void sz_collation_ranks_case_fold(sz_u8_t *ranks);
+
+/**
+ *  @brief  Estimates the relative order of two strings under the given collation rules,
+ *          similar to `sz_order`, but without copying or normalizing the strings.
+ *
+ *  @param collation    Collation rules, or NULL for the binary order.
+ *  @return             Negative if (a < b), positive if (a > b), zero if they are equal under the collation.
+ */
+SZ_PUBLIC sz_ordering_t sz_order_collated(sz_cptr_t a, sz_size_t a_length, sz_cptr_t b, sz_size_t b_length,
+                                          sz_collation_t const *collation);
+
+/**
+ *  @brief  Sorting algorithm, similar to `sz_sort`, following the given collation rules.
+ *          Packs the ranks of the first 4 bytes into the `sequence->order` entries for the Radix Sort,
+ *          stopping at the first digit in the natural order, and applies the rules in the comparator,
+ *          avoiding temporary normalized copies of strings. Strings equal under the collation come in any order.
+ *
+ *  @param collation    Collation rules, or NULL for the binary order.
+ */
+SZ_PUBLIC void sz_sort_collated(sz_sequence_t *sequence, sz_collation_t const *collation);
+
 /**
  *  @brief  Intro-Sort algorithm that supports custom comparators.
  */
 SZ_PUBLIC void sz_sort_intro(sz_sequence_t *sequence, sz_sequence_comparator_t less);
 
+/**
+ *  @brief  Builds the suffix array of a text - the offsets of all of its suffixes in lexicographic order,
+ *          using the linear-time SA-IS algorithm by Nong, Zhang & Chan. Optionally, exports the LCP array
+ *          with the lengths of common prefixes of consecutive suffixes, using Kasai's algorithm.
+ *          Beyond the output, takes a bit per byte and a bucket table for every level of recursion.
+ *
+ *  @param text         Text to index.
+ *  @param length       Number of bytes in the text.
+ *  @param suffixes     Output array for ::length suffix offsets.
+ *  @param lcp          Optional output array for ::length common prefix lengths, can be NULL.
+ *                      The first entry is zero, and the i-th one compares the i-th suffix with the previous one.
+ *  @param alloc        Temporary memory allocator. Can be NULL.
+ *  @return             Whether the construction succeeded, or failed to allocate temporary memory.
+ *  @see                sz_suffix_array_u32tape, sz_suffix_array_u64tape
+ */
+SZ_PUBLIC sz_bool_t sz_suffix_array(sz_cptr_t text, sz_size_t length, sz_size_t *suffixes, sz_size_t *lcp,
+                                    sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Builds the generalized suffix array of a tape of concatenated strings, like `sz_suffix_array`,
+ *          but comparing suffixes only until the end of the string they belong to. Suffixes, equal up to
+ *          the end of their strings, are ordered by the content of the strings following them.
+ *          Expects ::offsets to contain `count + 1` entries, like `sz_sequence_from_u32tape`.
+ *
+ *  @param start        Pointer to the first byte of the tape.
+ *  @param offsets      Offsets of the strings in the tape, with `count + 1` entries.
+ *  @param count        Number of strings in the tape.
+ *  @param suffixes     Output array for `offsets[count] - offsets[0]` suffix offsets, relative to ::start.
+ *  @param lcp          Optional output array for the common prefix lengths, limited to string ends, can be NULL.
+ *  @param alloc        Temporary memory allocator. Can be NULL.
+ *  @return             Whether the construction succeeded, or failed to allocate temporary memory.
+ */
+SZ_PUBLIC sz_bool_t sz_suffix_array_u32tape(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count,
+                                            sz_size_t *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc);
+
+/** @copydoc sz_suffix_array_u32tape */
+SZ_PUBLIC sz_bool_t sz_suffix_array_u64tape(sz_cptr_t start, sz_u64_t const *offsets, sz_size_t count,
+                                            sz_size_t *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  FM-index of a static text, answering substring count and locate queries in time proportional to the
+ *          pattern length, rather than the text length. Keeps the Burrows-Wheeler transform of the text,
+ *          two-level occurrence counters, and a sample of suffix array entries, trading locate speed for space.
+ *
+ *  All of the state lives in a single ::blob of ::blob_length bytes, referenced by offsets rather than pointers.
+ *  It can be persisted as is, and later memory-mapped and reused with `sz_fm_index_view` without rebuilding.
+ *  The blob layout depends on the machine endianness.
+ */
+typedef struct sz_fm_index_t {
+    sz_cptr_t blob;
+    sz_size_t blob_length;
+    sz_size_t length;      // Number of bytes in the indexed text.
+    sz_size_t primary;     // Row of the whole text in the sorted rotations, holding the sentinel in the BWT.
+    sz_size_t sample_rate; // Every text offset divisible by this is sampled.
+
+    sz_u64_t const *counts;      // 257 entries - the first row of every character in the sorted rotations.
+    sz_u64_t const *superblocks; // 256 character counts for every 64K rows of the BWT.
+    sz_u16_t const *blocks;      // 256 character counts for every 1K rows, relative to the superblock.
+    sz_u64_t const *marks;       // Bitset of rows with sampled suffix array entries.
+    sz_u64_t const *marks_ranks; // Number of marked rows before every 512 rows.
+    sz_u64_t const *samples;     // Sampled suffix array entries in the order of rows.
+    sz_u8_t const *bwt;          // Burrows-Wheeler transform of the text, with `length + 1` rows.
+} sz_fm_index_t;
+
+/**
+ *  @brief  Builds the FM-index of a text, constructing its suffix array with `sz_suffix_array` first.
+ *          The text itself isn't referenced afterwards. Free the index with `sz_fm_index_free`.
+ *
+ *  @param index        Index to initialize.
+ *  @param text         Text to index.
+ *  @param length       Number of bytes in the text.
+ *  @param sample_rate  Distance between sampled suffix array entries, bounding the cost of a locate step.
+ *                      Pass zero for the default of 32, costing 2 bits per byte of the text.
+ *  @param alloc        Memory allocator for the index and temporary buffers. Can be NULL.
+ *  @return             Whether the construction succeeded, or failed to allocate memory.
+ */
+SZ_PUBLIC sz_bool_t sz_fm_index_init(sz_fm_index_t *index, sz_cptr_t text, sz_size_t length, sz_size_t sample_rate,
+                                     sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Initializes a non-owning FM-index from a serialized ::blob, like a memory-mapped file,
+ *          previously exported from the `blob` and `blob_length` members of a built index.
+ *
+ *  @param index        Index to initialize.
+ *  @param blob         Serialized index, aligned to 8 bytes.
+ *  @param blob_length  Number of bytes in the blob.
+ *  @return             Whether the blob is a valid serialized index.
+ */
+SZ_PUBLIC sz_bool_t sz_fm_index_view(sz_fm_index_t *index, sz_cptr_t blob, sz_size_t blob_length);
+
+/**
+ *  @brief  Releases the memory of an index, built with `sz_fm_index_init`, with the same allocator.
+ */
+SZ_PUBLIC void sz_fm_index_free(sz_fm_index_t *index, sz_memory_allocator_t *alloc);
+
+/**
+ *  @brief  Counts the occurrences of a pattern in the indexed text, including overlapping ones,
+ *          with a backward search, taking two rank queries per pattern byte.
+ *
+ *  @param index        Built or viewed index.
+ *  @param pattern      Pattern to search for.
+ *  @param length       Number of bytes in the pattern.
+ *  @return             Number of occurrences, or `length + 1` of the text for an empty pattern.
+ */
+SZ_PUBLIC sz_size_t sz_fm_index_count(sz_fm_index_t const *index, sz_cptr_t pattern, sz_size_t length);
+
+/**
+ *  @brief  Locates the occurrences of a pattern in the indexed text, in no particular order.
+ *          Every location takes less than `sample_rate` steps, walking the text backwards.
+ *
+ *  @param index        Built or viewed index.
+ *  @param pattern      Non-empty pattern to search for.
+ *  @param length       Number of bytes in the pattern.
+ *  @param positions    Output array for the offsets of occurrences in the text.
+ *  @param capacity     Maximum number of offsets to export.
+ *  @return             Number of exported offsets.
+ */
+SZ_PUBLIC sz_size_t sz_fm_index_locate(sz_fm_index_t const *index, sz_cptr_t pattern, sz_size_t length,
+                                       sz_size_t *positions, sz_size_t capacity);
+
+/**
+ *  @brief  Persisted tape of concatenated strings, like an Apache Arrow string array, that can be written once,
+ *          and later memory-mapped and reused with `sz_tape_view` without parsing.
+ *
+ *  The blob starts with a header of 8 words: a magic number with the format version, the number of strings,
+ *  the size of every offset, the offset of the data section, and the blob length. The remaining words are zeros.
+ *  The header is followed by `count + 1` offsets, starting with zero, and padded with zeros to a multiple of 8 bytes.
+ *  The data section with the concatenated strings closes the blob. The blob layout depends on the machine endianness.
+ */
+typedef struct sz_tape_t {
+    sz_cptr_t blob;
+    sz_size_t blob_length;
+    sz_size_t count;       // Number of strings in the tape.
+    sz_size_t offset_size; // Either 4 or 8 bytes, for 32-bit and 64-bit offsets.
+    void const *offsets;   // `count + 1` offsets of the strings in the ::data, starting with zero.
+    sz_cptr_t data;        // Concatenated strings.
+} sz_tape_t;
+
+/**
+ *  @brief  Populates the header of a tape blob, that the caller follows with the offsets and the strings.
+ *
+ *  @param header       Output array of 8 words.
+ *  @param count        Number of strings in the tape.
+ *  @param data_length  Total length of all strings in bytes.
+ *  @param offset_size  Either 4 or 8 bytes. The 4-byte offsets require ::data_length under 4 GB.
+ *  @return             Number of bytes in the blob, including the header, or zero for invalid arguments.
+ *                      The data section starts at `header[3]` bytes from the start of the blob.
+ */
+SZ_PUBLIC sz_size_t sz_tape_header(sz_u64_t *header, sz_size_t count, sz_size_t data_length, sz_size_t offset_size);
+
+/**
+ *  @brief  Initializes a non-owning tape from a serialized ::blob, like a memory-mapped file.
+ *          Only the header and the first and last offsets are validated, so the view takes constant time.
+ *
+ *  @param tape         Tape to initialize.
+ *  @param blob         Serialized tape, aligned to 8 bytes.
+ *  @param blob_length  Number of bytes in the blob.
+ *  @return             Whether the blob is a valid serialized tape.
+ */
+SZ_PUBLIC sz_bool_t sz_tape_view(sz_tape_t *tape, sz_cptr_t blob, sz_size_t blob_length);
+
+/**
+ *  @brief  Checks that the offsets of a tape, initialized with `sz_tape_view`, never decrease, so that every
+ *          string lies within the data section. Takes linear time, so untrusted blobs should be validated once.
+ *
+ *  @param tape         Tape, initialized with `sz_tape_view`.
+ *  @return             Whether all of the strings are within the bounds of the blob.
+ */
+SZ_PUBLIC sz_bool_t sz_tape_validate(sz_tape_t const *tape);
+
+/**
+ *  @brief  Callback for `sz_tape_write`, appending the given bytes to the output, like `fwrite` into a file.
+ *  @return Whether all of the bytes were written.
+ */
+typedef sz_bool_t (*sz_tape_write_t)(sz_cptr_t, sz_size_t, void *user);
+
+/**
+ *  @brief  Serializes a sequence of strings in the layout of `sz_tape_t`, streaming the header, the offsets,
+ *          and the strings through the ::write callback, without materializing the blob. Uses 32-bit offsets,
+ *          unless the strings exceed 4 GB. Neighboring strings, stored back to back, are written at once.
+ *
+ *  @param sequence     Strings to write, in the order of their indices, ignoring the `sequence->order`.
+ *  @param write        Callback, receiving the consecutive parts of the blob.
+ *  @param user         Opaque pointer, passed to the ::write callback, like a file handle.
+ *  @return             Whether all of the ::write calls succeeded.
+ */
+SZ_PUBLIC sz_bool_t sz_tape_write(sz_sequence_t const *sequence, sz_tape_write_t write, void *user);
+
 #pragma endregion
 
 /*
@@ -1143,6 +1798,24 @@ SZ_PUBLIC sz_ssize_t sz_alignment_score_avx512(sz_cptr_t a, sz_size_t a_length,
 /** @copydoc sz_hashes */
 SZ_PUBLIC void sz_hashes_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step, //
                                 sz_hash_callback_t callback, void *callback_handle);
+/** @copydoc sz_hashes_mersenne */
+SZ_PUBLIC void sz_hashes_mersenne_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                         sz_hash_callback_t callback, void *callback_handle);
+/** @copydoc sz_hashes_into */
+SZ_PUBLIC sz_size_t sz_hashes_into_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                            sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                            sz_size_t capacity);
+/** @copydoc sz_hashes_minhash */
+SZ_PUBLIC void sz_hashes_minhash_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                        sz_hash_family_t family, sz_u64_t *signature, sz_size_t signature_length);
+/** @copydoc sz_hashes_simhash */
+SZ_PUBLIC sz_u64_t sz_hashes_simhash_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                            sz_hash_family_t family);
+/** @copydoc sz_minhash_matches */
+SZ_PUBLIC void sz_minhash_matches_avx512(sz_u64_t const *query, sz_u64_t const *signatures,
+                                         sz_size_t signatures_count, sz_size_t signature_length, sz_size_t *matches);
+/** @copydoc sz_hash_tape */
+SZ_PUBLIC void sz_hash_tape_avx512(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes);
 #endif
 
 #if SZ_USE_X86_AVX2
@@ -1163,6 +1836,15 @@ SZ_PUBLIC sz_cptr_t sz_rfind_avx2(sz_cptr_t haystack, sz_size_t h_length, sz_cpt
 /** @copydoc sz_hashes */
 SZ_PUBLIC void sz_hashes_avx2(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step, //
                               sz_hash_callback_t callback, void *callback_handle);
+/** @copydoc sz_hashes_mersenne */
+SZ_PUBLIC void sz_hashes_mersenne_avx2(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                       sz_hash_callback_t callback, void *callback_handle);
+/** @copydoc sz_hashes_into */
+SZ_PUBLIC sz_size_t sz_hashes_into_avx2(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                          sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                          sz_size_t capacity);
+/** @copydoc sz_hash_tape */
+SZ_PUBLIC void sz_hash_tape_avx2(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes);
 #endif
 
 #if SZ_USE_ARM_NEON
@@ -1180,6 +1862,8 @@ SZ_PUBLIC sz_cptr_t sz_rfind_neon(sz_cptr_t haystack, sz_size_t h_length, sz_cpt
 SZ_PUBLIC sz_cptr_t sz_find_charset_neon(sz_cptr_t text, sz_size_t length, sz_charset_t const *set);
 /** @copydoc sz_rfind_charset */
 SZ_PUBLIC sz_cptr_t sz_rfind_charset_neon(sz_cptr_t text, sz_size_t length, sz_charset_t const *set);
+/** @copydoc sz_hash_tape */
+SZ_PUBLIC void sz_hash_tape_neon(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes);
 #endif
 
 #pragma endregion
@@ -1556,25 +2240,6 @@ SZ_INTERNAL void _sz_memory_free_fixed(sz_ptr_t start, sz_size_t length, void *h
     sz_unused(start && length && handle);
 }
 
-/** @brief  An internal callback used to set a bit in a power-of-two length binary fingerprint of a string. */
-SZ_INTERNAL void _sz_hashes_fingerprint_pow2_callback(sz_cptr_t start, sz_size_t length, sz_u64_t hash, void *handle) {
-    sz_string_view_t *fingerprint_buffer = (sz_string_view_t *)handle;
-    sz_u8_t *fingerprint_u8s = (sz_u8_t *)fingerprint_buffer->start;
-    sz_size_t fingerprint_bytes = fingerprint_buffer->length;
-    fingerprint_u8s[(hash / 8) & (fingerprint_bytes - 1)] |= (1 << (hash & 7));
-    sz_unused(start && length);
-}
-
-/** @brief  An internal callback used to set a bit in a @b non power-of-two length binary fingerprint of a string. */
-SZ_INTERNAL void _sz_hashes_fingerprint_non_pow2_callback(sz_cptr_t start, sz_size_t length, sz_u64_t hash,
-                                                          void *handle) {
-    sz_string_view_t *fingerprint_buffer = (sz_string_view_t *)handle;
-    sz_u8_t *fingerprint_u8s = (sz_u8_t *)fingerprint_buffer->start;
-    sz_size_t fingerprint_bytes = fingerprint_buffer->length;
-    fingerprint_u8s[(hash / 8) % fingerprint_bytes] |= (1 << (hash & 7));
-    sz_unused(start && length);
-}
-
 /** @brief  An internal callback, used to mix all the running hashes into one pointer-size value. */
 SZ_INTERNAL void _sz_hashes_fingerprint_scalar_callback(sz_cptr_t start, sz_size_t length, sz_u64_t hash,
                                                         void *scalar_handle) {
@@ -2650,6 +3315,12 @@ SZ_PUBLIC sz_ssize_t sz_alignment_score_serial(       //
  */
 #define SZ_U64_MAX_PRIME (18446744073709551557ull)
 
+/**
+ *  @brief  Largest Mersenne prime that fits into 64 bits, equal to `2^61 - 1`.
+ *          Modulo reduction by it needs only shifts and additions, as `2^61 = 1`.
+ */
+#define SZ_U61_MERSENNE_PRIME (0x1FFFFFFFFFFFFFFFull)
+
 /*
  *  One hardware-accelerated way of mixing hashes can be CRC, but it's only implemented for 32-bit values.
  *  Using a Boost-like mixer works very poorly in such case:
@@ -2662,7 +3333,9 @@ SZ_PUBLIC sz_ssize_t sz_alignment_score_serial(       //
 #define _sz_hash_mix(first, second) ((first * 11400714819323198485ull) ^ (second * 11400714819323198485ull))
 #define _sz_shift_low(x) (x)
 #define _sz_shift_high(x) ((x + 77ull) & 0xFFull)
-#define _sz_prime_mod(x) (x % SZ_U64_MAX_PRIME)
+// Any 64-bit integer is smaller than twice the `SZ_U64_MAX_PRIME`, so the modulo is just a conditional subtraction,
+// avoiding the expensive 64-bit division.
+#define _sz_prime_mod(x) (x >= SZ_U64_MAX_PRIME ? x - SZ_U64_MAX_PRIME : x)
 
 SZ_PUBLIC sz_u64_t sz_hash_serial(sz_cptr_t start, sz_size_t length) {
 
@@ -2775,49 +3448,156 @@ SZ_PUBLIC sz_u64_t sz_hash_serial(sz_cptr_t start, sz_size_t length) {
     return _sz_hash_mix(hash_low, hash_high);
 }
 
-SZ_PUBLIC void sz_hashes_serial(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
-                                sz_hash_callback_t callback, void *callback_handle) {
+SZ_PUBLIC void sz_hash_tape_serial(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
+    for (sz_size_t i = 0; i != count; ++i) hashes[i] = sz_hash_serial(start + offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+/**
+ *  @brief  Reduces a 63-bit integer modulo the `SZ_U61_MERSENNE_PRIME`, using the `2^61 = 1` identity.
+ */
+SZ_INTERNAL sz_u64_t _sz_mersenne_reduce(sz_u64_t x) {
+    x = (x & SZ_U61_MERSENNE_PRIME) + (x >> 61);
+    return x >= SZ_U61_MERSENNE_PRIME ? x - SZ_U61_MERSENNE_PRIME : x;
+}
+
+/**
+ *  @brief  Multiplies a residue by `2^shift` modulo the `SZ_U61_MERSENNE_PRIME`,
+ *          which is just a rotation of the lower 61 bits.
+ */
+SZ_INTERNAL sz_u64_t _sz_mersenne_rotl(sz_u64_t x, int shift) {
+    return ((x << shift) & SZ_U61_MERSENNE_PRIME) | (x >> (61 - shift));
+}
+
+/**
+ *  @brief  Multiplies a byte by a residue modulo the `SZ_U61_MERSENNE_PRIME`, using only 32-bit multiplications,
+ *          available in every SIMD instruction set.
+ */
+SZ_INTERNAL sz_u64_t _sz_mersenne_mul_byte(sz_u64_t byte, sz_u64_t x) {
+    return _sz_mersenne_reduce(byte * (x & 0xFFFFFFFFull) + _sz_mersenne_rotl(byte * (x >> 32), 32));
+}
+
+SZ_INTERNAL sz_u64_t _sz_mersenne_mul_31(sz_u64_t x) {
+    return _sz_mersenne_rotl(x, 5) + (SZ_U61_MERSENNE_PRIME - x); // x * 31 = x * 32 - x
+}
+
+SZ_INTERNAL sz_u64_t _sz_mersenne_mul_257(sz_u64_t x) {
+    return _sz_mersenne_rotl(x, 8) + x; // x * 257 = x * 256 + x
+}
+
+/**
+ *  @brief  Computes the `base ^ (window_length - 1)` values for both hashes of a family,
+ *          used to discard the oldest character of a rolling window.
+ */
+SZ_INTERNAL void _sz_hashes_prime_powers(sz_size_t window_length, sz_hash_family_t family, //
+                                         sz_u64_t *prime_power_low, sz_u64_t *prime_power_high) {
+    sz_u64_t power_low = 1, power_high = 1;
+    if (family == sz_hash_family_mersenne_k)
+        for (sz_size_t i = 0; i + 1 < window_length; ++i)
+            power_low = _sz_mersenne_reduce(_sz_mersenne_mul_31(power_low)),
+            power_high = _sz_mersenne_reduce(_sz_mersenne_mul_257(power_high));
+    else
+        for (sz_size_t i = 0; i + 1 < window_length; ++i)
+            power_low = (power_low * 31ull) % SZ_U64_MAX_PRIME, power_high = (power_high * 257ull) % SZ_U64_MAX_PRIME;
+    *prime_power_low = power_low;
+    *prime_power_high = power_high;
+}
+
+/**
+ *  @brief  Shared implementation of the rolling hashes for all families, reporting the hashes of windows
+ *          either to the `callback`, if provided, or into the `hashes` and optional `positions` arrays.
+ *  @return Number of reported hashes, at most `capacity`.
+ */
+SZ_INTERNAL sz_size_t _sz_hashes_serial(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                        sz_hash_family_t family, sz_hash_callback_t callback, void *callback_handle,
+                                        sz_u64_t *hashes, sz_size_t *positions, sz_size_t capacity) {
 
-    if (length < window_length || !window_length) return;
+    if (length < window_length || !window_length || !capacity) return 0;
     sz_u8_t const *text = (sz_u8_t const *)start;
     sz_u8_t const *text_end = text + length;
+    sz_bool_t const is_mersenne = (sz_bool_t)(family == sz_hash_family_mersenne_k);
 
     // Prepare the `prime ^ window_length` values, that we are going to use for modulo arithmetic.
-    sz_u64_t prime_power_low = 1, prime_power_high = 1;
-    for (sz_size_t i = 0; i + 1 < window_length; ++i)
-        prime_power_low = (prime_power_low * 31ull) % SZ_U64_MAX_PRIME,
-        prime_power_high = (prime_power_high * 257ull) % SZ_U64_MAX_PRIME;
+    sz_u64_t prime_power_low, prime_power_high;
+    _sz_hashes_prime_powers(window_length, family, &prime_power_low, &prime_power_high);
 
     // Compute the initial hash value for the first window.
     sz_u64_t hash_low = 0, hash_high = 0, hash_mix;
-    for (sz_u8_t const *first_end = text + window_length; text < first_end; ++text)
-        hash_low = (hash_low * 31ull + _sz_shift_low(*text)) % SZ_U64_MAX_PRIME,
-        hash_high = (hash_high * 257ull + _sz_shift_high(*text)) % SZ_U64_MAX_PRIME;
+    if (is_mersenne)
+        for (sz_u8_t const *first_end = text + window_length; text < first_end; ++text)
+            hash_low = _sz_mersenne_reduce(_sz_mersenne_mul_31(hash_low) + _sz_shift_low(*text)),
+            hash_high = _sz_mersenne_reduce(_sz_mersenne_mul_257(hash_high) + _sz_shift_high(*text));
+    else
+        for (sz_u8_t const *first_end = text + window_length; text < first_end; ++text)
+            hash_low = hash_low * 31ull + _sz_shift_low(*text), hash_low = _sz_prime_mod(hash_low),
+            hash_high = hash_high * 257ull + _sz_shift_high(*text), hash_high = _sz_prime_mod(hash_high);
 
     // In most cases the fingerprint length will be a power of two.
+    sz_size_t count = 0;
     hash_mix = _sz_hash_mix(hash_low, hash_high);
-    callback((sz_cptr_t)text, window_length, hash_mix, callback_handle);
+    if (callback) callback(start, window_length, hash_mix, callback_handle);
+    else {
+        hashes[0] = hash_mix;
+        if (positions) positions[0] = 0;
+    }
+    ++count;
 
-    // Compute the hash value for every window, exporting into the fingerprint,
-    // using the expensive modulo operation.
+    // Compute the hash value for every window, exporting into the fingerprint.
     sz_size_t cycles = 1;
     sz_size_t const step_mask = step - 1;
-    for (; text < text_end; ++text, ++cycles) {
-        // Discard one character:
-        hash_low -= _sz_shift_low(*(text - window_length)) * prime_power_low;
-        hash_high -= _sz_shift_high(*(text - window_length)) * prime_power_high;
-        // And add a new one:
-        hash_low = 31ull * hash_low + _sz_shift_low(*text);
-        hash_high = 257ull * hash_high + _sz_shift_high(*text);
-        // Wrap the hashes around:
-        hash_low = _sz_prime_mod(hash_low);
-        hash_high = _sz_prime_mod(hash_high);
+    for (; text < text_end && count < capacity; ++text, ++cycles) {
+        sz_u8_t const dropped = *(text - window_length);
+        if (is_mersenne) {
+            // Discard one character:
+            hash_low += SZ_U61_MERSENNE_PRIME - _sz_mersenne_mul_byte(_sz_shift_low(dropped), prime_power_low);
+            hash_high += SZ_U61_MERSENNE_PRIME - _sz_mersenne_mul_byte(_sz_shift_high(dropped), prime_power_high);
+            // And add a new one:
+            hash_low = _sz_mersenne_reduce(_sz_mersenne_mul_31(_sz_mersenne_reduce(hash_low)) + _sz_shift_low(*text));
+            hash_high =
+                _sz_mersenne_reduce(_sz_mersenne_mul_257(_sz_mersenne_reduce(hash_high)) + _sz_shift_high(*text));
+        }
+        else {
+            // Discard one character:
+            hash_low -= _sz_shift_low(dropped) * prime_power_low;
+            hash_high -= _sz_shift_high(dropped) * prime_power_high;
+            // And add a new one:
+            hash_low = 31ull * hash_low + _sz_shift_low(*text);
+            hash_high = 257ull * hash_high + _sz_shift_high(*text);
+            // Wrap the hashes around:
+            hash_low = _sz_prime_mod(hash_low);
+            hash_high = _sz_prime_mod(hash_high);
+        }
         // Mix only if we've skipped enough hashes.
         if ((cycles & step_mask) == 0) {
             hash_mix = _sz_hash_mix(hash_low, hash_high);
-            callback((sz_cptr_t)text, window_length, hash_mix, callback_handle);
+            sz_cptr_t window_start = (sz_cptr_t)text - window_length + 1;
+            if (callback) callback(window_start, window_length, hash_mix, callback_handle);
+            else {
+                hashes[count] = hash_mix;
+                if (positions) positions[count] = (sz_size_t)(window_start - start);
+            }
+            ++count;
         }
     }
+    return count;
+}
+
+SZ_PUBLIC void sz_hashes_serial(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_serial(start, length, window_length, step, sz_hash_family_prime_k, callback, callback_handle, SZ_NULL,
+                      SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC void sz_hashes_mersenne_serial(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                         sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_serial(start, length, window_length, step, sz_hash_family_mersenne_k, callback, callback_handle,
+                      SZ_NULL, SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC sz_size_t sz_hashes_into_serial(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                          sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                          sz_size_t capacity) {
+    return _sz_hashes_serial(start, length, window_length, step, family, SZ_NULL, SZ_NULL, hashes, positions,
+                             capacity);
 }
 
 #undef _sz_shift_low
@@ -2826,13 +3606,560 @@ SZ_PUBLIC void sz_hashes_serial(sz_cptr_t start, sz_size_t length, sz_size_t win
 #undef _sz_prime_mod
 
 /**
- *  @brief  Uses a small lookup-table to convert a lowercase character to uppercase.
+ *  @brief  Uses a lookup-table of 64-bit random values, one per byte, for the Gear rolling hash.
+ *          The values are produced with SplitMix64, so they can be reproduced in other languages.
  */
-SZ_INTERNAL sz_u8_t sz_u8_tolower(sz_u8_t c) {
-    static sz_u8_t const lowered[256] = {
-        0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  //
-        16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  //
-        32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  //
+SZ_INTERNAL sz_u64_t _sz_gear(sz_u8_t c) {
+    static sz_u64_t const gear[256] = {
+        0xE220A8397B1DCDAFull, 0x6E789E6AA1B965F4ull, 0x06C45D188009454Full, 0xF88BB8A8724C81ECull, //
+        0x1B39896A51A8749Bull, 0x53CB9F0C747EA2EAull, 0x2C829ABE1F4532E1ull, 0xC584133AC916AB3Cull, //
+        0x3EE5789041C98AC3ull, 0xF3B8488C368CB0A6ull, 0x657EECDD3CB13D09ull, 0xC2D326E0055BDEF6ull, //
+        0x8621A03FE0BBDB7Bull, 0x8E1F7555983AA92Full, 0xB54E0F1600CC4D19ull, 0x84BB3F97971D80ABull, //
+        0x7D29825C75521255ull, 0xC3CF17102B7F7F86ull, 0x3466E9A083914F64ull, 0xD81A8D2B5A4485ACull, //
+        0xDB01602B100B9ED7ull, 0xA9038A921825F10Dull, 0xEDF5F1D90DCA2F6Aull, 0x54496AD67BD2634Cull, //
+        0xDD7C01D4F5407269ull, 0x935E82F1DB4C4F7Bull, 0x69B82EBC92233300ull, 0x40D29EB57DE1D510ull, //
+        0xA2F09DABB45C6316ull, 0xEE521D7A0F4D3872ull, 0xF16952EE72F3454Full, 0x377D35DEA8E40225ull, //
+        0x0C7DE8064963BAB0ull, 0x05582D37111AC529ull, 0xD254741F599DC6F7ull, 0x69630F7593D108C3ull, //
+        0x417EF96181DAA383ull, 0x3C3C41A3B43343A1ull, 0x6E19905DCBE531DFull, 0x4FA9FA7324851729ull, //
+        0x84EB4454A792922Aull, 0x134F7096918175CEull, 0x07DC930B302278A8ull, 0x12C015A97019E937ull, //
+        0xCC06C31652EBF438ull, 0xECEE65630A691E37ull, 0x3E84ECB1763E79ADull, 0x690ED476743AAE49ull, //
+        0x774615D7B1A1F2E1ull, 0x22B353F04F4F52DAull, 0xE3DDD86BA71A5EB1ull, 0xDF268ADEB6513356ull, //
+        0x2098EB73D4367D77ull, 0x03D6845323CE3C71ull, 0xC952C5620043C714ull, 0x9B196BCA844F1705ull, //
+        0x30260345DD9E0EC1ull, 0xCF448A5882BB9698ull, 0xF4A578DCCBC87656ull, 0xBFDEAED9A17B3C8Full, //
+        0xED79402D1D5C5D7Bull, 0x55F070AB1CBBF170ull, 0x3E00A34929A88F1Dull, 0xE255B237B8BB18FBull, //
+        0x2A7B67AF6C6AD50Eull, 0x466D5E7F3E46F143ull, 0x42375CB399A4FC72ull, 0x8C8A1F148A8BB259ull, //
+        0x32FCAB5DAED5BDFCull, 0x9E60398C8D8553C0ull, 0xEE89CCEB8C4064C0ull, 0xDB0215941D86A66Full, //
+        0x5CCDE78203C367A8ull, 0xF1BCBC6A1EC11786ull, 0xEF054FCEEE954551ull, 0xDF82012D0555C6DFull, //
+        0x292566FF72403C08ull, 0xC4DD302A1BFA1137ull, 0xD85F219DB5C554E1ull, 0x6A27FF807441BCD2ull, //
+        0x96A573E9B48216E8ull, 0x46A9FDAC40BF0048ull, 0x3DD12464A0EE15B4ull, 0x451E521296A7EEA1ull, //
+        0x56E4398A98F8A0FDull, 0x7B7DC2160E3335A7ull, 0xC679EE0BEBCB1CCAull, 0x928D6F2D7453424Eull, //
+        0x1B38994205234C6Dull, 0x8086D193A6F2B568ull, 0x21C6E26639AC2C65ull, 0xD9DCCAC414D23C6Full, //
+        0x91CD642057E00235ull, 0x77FC607DC6589373ull, 0x05B8ABE26DD3AEE7ull, 0x12F6436AC376CC66ull, //
+        0x64952424897B2307ull, 0xEE8C2BAF6343E5C3ull, 0xDC4C613D9EBA2304ull, 0x3505B7796BD1A506ull, //
+        0x8176DAF800A05F50ull, 0x8BD8FF7A0385CDBCull, 0x1A764A3CD78101DAull, 0xBE4D15BF6CA266ACull, //
+        0xA85E1F38BB2DC749ull, 0x56759A968493CD8Cull, 0xF3A9BCE7336BD182ull, 0x365B15013741519Bull, //
+        0x1F7A44A6B109AC94ull, 0x3521D628813CB177ull, 0x6A77AFAB0F7C9370ull, 0x179642D8CDE95015ull, //
+        0x5EF102A8FB354461ull, 0xF51C504764ED82F2ull, 0xC58427F041CE6808ull, 0xFAD8FC45C9643C37ull, //
+        0xCF8682F9A70FA9C0ull, 0x7E1B3B75A4005729ull, 0x992DD867927B52D8ull, 0x7FBD5DB142F6791Full, //
+        0x370595AACAB4ADAEull, 0xB1392DBDC5AB61D6ull, 0x9FEA7DFC79D452D9ull, 0x40B12B120085641Cull, //
+        0xA192AFE3157C85D0ull, 0xC847729F4E08F3A3ull, 0x6F1384A306C41FC2ull, 0x12D05C4045A39C19ull, //
+        0x9899202FD20F0841ull, 0xE9C7191857E774B8ull, 0x4EEAD809AF5B0CC3ull, 0xE809ACAFA23864A4ull, //
+        0x4DA1EDABA1D0F7BDull, 0x846EB9673349F8E4ull, 0x87BAE55B86039FE8ull, 0x7F367B8BD953EFF2ull, //
+        0x3884700F650D04E1ull, 0xBFE4B2AB46980CADull, 0xC5FC89075299106Cull, 0x37B2FA361ADEA7CDull, //
+        0x7D75D813F04895B4ull, 0x702F5B393F62C0E0ull, 0x0A3FC775F4ECF37Full, 0xE4B23787A352437Full, //
+        0xF83FA245C34D6363ull, 0xB99BCF040786CF50ull, 0x38B6EA0A0E6C9D8Aull, 0x093FDC76776E37E1ull, //
+        0x1A75E6F76BA7EEE8ull, 0x442CDCFEE9660C62ull, 0x22D58D35116B5E0Bull, 0x87D4A5180F6A3645ull, //
+        0x589FB216BD82131Bull, 0x91D031CAD319AEC0ull, 0xABECF76A553D320Bull, 0xB8686CB347612DCFull, //
+        0xFCAB66337C0A77F5ull, 0xAC318214381EC437ull, 0x6EB7F0FCA24494AEull, 0xCF42861DCDC895A9ull, //
+        0x4ABAD7A1586D7A91ull, 0xC21B318DC2F49745ull, 0xD49474DC2ACBD1F0ull, 0xB1D4873747C1C8E1ull, //
+        0x5434DC8C7D015BF6ull, 0xE1C486287511B6A9ull, 0xA8616DF62E89A193ull, 0x31CE6319498D8347ull, //
+        0xAFD0B486123D6FAAull, 0xE6495F5D102301EBull, 0x0DC51CED17A43C52ull, 0x8BCBCDE81355EF2Dull, //
+        0x2412AF73FDEE7CFCull, 0xC8D589E486E29EEDull, 0x23390E8664517F89ull, 0x251ADE58E8A6849Dull, //
+        0xF8555DBD2E8F9CB0ull, 0xCB417C3EEF54F7C3ull, 0x8028F8E1AAC3A919ull, 0x10E31052ACF748A0ull, //
+        0x2D886C073B1E1B78ull, 0x972974D90DF9FAEEull, 0xBC1B7B38796893BAull, 0x1958ED432070E652ull, //
+        0xCA5F297197A12DCCull, 0xE025A27375704F28ull, 0x418010A570A924FBull, 0x9828E2941BFC419Cull, //
+        0x4FBACD2F52B85C1Full, 0x33DD5B756211CC67ull, 0x23C8DFDD1DB57FF0ull, 0x32F81801A1A8E901ull, //
+        0x26884EAC5ADA36DAull, 0xCAA82F9BB42E37D4ull, 0x19FB1A7491D6A7D1ull, 0x5AA0243AA357F38Eull, //
+        0xB31D917809E447F0ull, 0x3F9C197225215BE0ull, 0xDC3C315A1E33C095ull, 0x3DD399AD533E80ACull, //
+        0x566F32CCE8301D95ull, 0xC880188083D9BA21ull, 0xB9CC357F3B0E7D2Eull, 0x0237D2123A8A8D6Cull, //
+        0xBF636E9AA7CBF6BDull, 0xD7BD4284C4E2A6A7ull, 0xDA2EBB47D50577A9ull, 0x90BA1C11B539087Dull, //
+        0x44993D31552B4F57ull, 0x32C2D6F80A8A8898ull, 0x450583ED7FB54B19ull, 0xEC2B0B09E50EF3EFull, //
+        0xD918A0B6E2EFD65Cull, 0xE37A868D9785F572ull, 0x7D1A6118F2B0F37Aull, 0x9E2E3CC13B343439ull, //
+        0xEFD82C11212E37E8ull, 0xAF89C05CD4FC75EDull, 0x55BC16BB9697108Eull, 0x6C4701FA5DB69BEEull, //
+        0x9237338441DAF445ull, 0x248CF0831E81A5FCull, 0xACC13557E77DE273ull, 0x520970C25E06513Aull, //
+        0x657329CB02987CABull, 0xA9B0B3366A4E55A8ull, 0xC4D06CA2F39ACDD4ull, 0x5DCE37D68170CDE1ull, //
+        0x5F1E44E77E1854C9ull, 0x6883D452D55DF899ull, 0x05C5BD62F1067032ull, 0xE680B683CE60FAB0ull, //
+        0x5DC9DA3F286D18B1ull, 0x94B4BF3AB85ED6D8ull, 0xCE65F449E3ACC5A3ull, 0x34B0209642CEA639ull, //
+        0xC14C3C771D904827ull, 0x6ADDCEE2BD9CDEE5ull, 0xE24EED137FFBB613ull, 0x75DD58EF79963D1Bull, //
+        0xFDB83ECF6CC24920ull, 0x7A1D0057C57169FBull, 0x339200F4FEB62D07ull, 0xD33F4D4AC88469F4ull, //
+        0x8226F234E68DFEE4ull, 0x320DEF4F2A105536ull, 0x7786F3B13AEFC159ull, 0xB28225AC9DF63EE2ull, //
+        0x781B9D0376CC6044ull, 0x05BD0115226C6AB6ull, 0xD302230207BDFDABull, 0xDB898ABD8E0D2933ull, //
+        0x9E79A397BA00B9CCull, 0x89DF84A5F0003EE8ull, 0x011F04F2A75FB9BEull, 0x5A5832BB47BCF19Eull, //
+    };
+    return gear[c];
+}
+
+SZ_PUBLIC void sz_chunker_init(sz_chunker_t *chunker, sz_size_t min_length, sz_size_t average_length,
+                               sz_size_t max_length, sz_size_t normalization) {
+    min_length = sz_max_of_two(min_length, 1);
+    max_length = sz_max_of_two(max_length, min_length);
+    average_length = sz_min_of_two(sz_max_of_two(average_length, min_length), max_length);
+    normalization = sz_min_of_two(normalization, 3);
+
+    // The probability of a boundary with a mask of `n` bits is `1 / 2^n`.
+    int const average_bits = (int)sz_size_log2i_nonzero(average_length);
+    int const strict_bits = sz_min_of_two(average_bits + (int)normalization, 63);
+    int const relaxed_bits = sz_max_of_two(average_bits - (int)normalization, 0);
+    chunker->min_length = min_length;
+    chunker->average_length = average_length;
+    chunker->max_length = max_length;
+    chunker->mask_strict = strict_bits ? ~0ull << (64 - strict_bits) : 0;
+    chunker->mask_relaxed = relaxed_bits ? ~0ull << (64 - relaxed_bits) : 0;
+    chunker->hash = 0;
+    chunker->chunk_length = 0;
+}
+
+SZ_PUBLIC sz_size_t sz_chunk_boundaries(sz_chunker_t *chunker, sz_cptr_t text, sz_size_t length,
+                                        sz_size_t *boundaries, sz_size_t capacity) {
+
+    sz_u8_t const *const text_start = (sz_u8_t const *)text;
+    sz_u8_t const *text_u8 = text_start;
+    sz_u8_t const *const text_end = text_start + length;
+    sz_size_t const min_length = chunker->min_length;
+    sz_size_t const average_length = chunker->average_length;
+    sz_size_t const max_length = chunker->max_length;
+    sz_u64_t hash = chunker->hash;
+    sz_size_t chunk_length = chunker->chunk_length;
+
+    // After 64 iterations of `hash = (hash << 1) + gear`, the older bytes are shifted out entirely.
+    // So we can skip the beginning of every long chunk, and only warm up the hash before the `min_length`.
+    sz_size_t const skipped_length = min_length > 64 ? min_length - 64 : 0;
+    sz_size_t count = 0;
+    while (text_u8 != text_end && count < capacity) {
+        sz_size_t const remaining = (sz_size_t)(text_end - text_u8);
+        if (chunk_length < skipped_length) {
+            sz_size_t const skipped = sz_min_of_two(skipped_length - chunk_length, remaining);
+            text_u8 += skipped, chunk_length += skipped;
+        }
+        else if (chunk_length < min_length) {
+            sz_u8_t const *const warmup_end = text_u8 + sz_min_of_two(min_length - chunk_length, remaining);
+            chunk_length += (sz_size_t)(warmup_end - text_u8);
+            for (; text_u8 != warmup_end; ++text_u8) hash = (hash << 1) + _sz_gear(*text_u8);
+        }
+        else {
+            // Use the stricter mask before the average length, and the relaxed one after.
+            sz_bool_t const is_short = (sz_bool_t)(chunk_length < average_length);
+            sz_u64_t const mask = is_short ? chunker->mask_strict : chunker->mask_relaxed;
+            sz_size_t const limit = is_short ? average_length : max_length;
+            sz_u8_t const *const scan_start = text_u8;
+            sz_u8_t const *const scan_end = text_u8 + sz_min_of_two(limit - chunk_length, remaining);
+            sz_bool_t found = sz_false_k;
+            while (text_u8 != scan_end) {
+                hash = (hash << 1) + _sz_gear(*text_u8++);
+                if ((hash & mask) == 0) {
+                    found = sz_true_k;
+                    break;
+                }
+            }
+            chunk_length += (sz_size_t)(text_u8 - scan_start);
+            if (found || chunk_length == max_length) {
+                boundaries[count++] = (sz_size_t)(text_u8 - text_start);
+                chunk_length = 0;
+            }
+        }
+    }
+
+    chunker->hash = hash;
+    chunker->chunk_length = chunk_length;
+    return count;
+}
+
+/**
+ *  @brief  Produces the constants of the `index`-th MinHash permutation, `(hash ^ seed) * multiplier`,
+ *          using the SplitMix64 generator. The multiplier is odd, so the permutation is a bijection.
+ */
+SZ_INTERNAL void _sz_minhash_permutation(sz_size_t index, sz_u64_t *multiplier, sz_u64_t *seed) {
+    sz_u64_t state = (sz_u64_t)index * 2ull;
+    for (int i = 0; i != 2; ++i) {
+        state += 0x9E3779B97F4A7C15ull;
+        sz_u64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+        if (i == 0) *multiplier = z | 1ull;
+        else *seed = z;
+    }
+}
+
+SZ_PUBLIC void sz_hashes_minhash_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                        sz_hash_family_t family, sz_u64_t *signature, sz_size_t signature_length) {
+
+    // Export the rolling hashes into a small on-stack buffer, and update every permutation in a tight loop.
+    sz_u64_t hashes[256];
+    while (window_length && length >= window_length) {
+        sz_size_t const count = sz_hashes_into_serial(text, length, window_length, 1, family, hashes, SZ_NULL, 256);
+        for (sz_size_t slot = 0; slot != signature_length; ++slot) {
+            sz_u64_t multiplier, seed, minimum = signature[slot];
+            _sz_minhash_permutation(slot, &multiplier, &seed);
+            for (sz_size_t i = 0; i != count; ++i) {
+                sz_u64_t const permuted = (hashes[i] ^ seed) * multiplier;
+                minimum = permuted < minimum ? permuted : minimum;
+            }
+            signature[slot] = minimum;
+        }
+        text += count, length -= count;
+    }
+}
+
+SZ_PUBLIC sz_u64_t sz_hashes_simhash_serial(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                            sz_hash_family_t family) {
+
+    // Count the number of set bits in every position across all the window hashes.
+    sz_size_t ones[64] = {0}, total = 0;
+    sz_u64_t hashes[256];
+    while (window_length && length >= window_length) {
+        sz_size_t const count = sz_hashes_into_serial(text, length, window_length, 1, family, hashes, SZ_NULL, 256);
+        for (sz_size_t i = 0; i != count; ++i)
+            for (int bit = 0; bit != 64; ++bit) ones[bit] += (hashes[i] >> bit) & 1ull;
+        text += count, length -= count, total += count;
+    }
+
+    sz_u64_t simhash = 0;
+    for (int bit = 0; bit != 64; ++bit) simhash |= (sz_u64_t)(ones[bit] * 2 > total) << bit;
+    return simhash;
+}
+
+SZ_PUBLIC void sz_minhash_matches_serial(sz_u64_t const *query, sz_u64_t const *signatures,
+                                         sz_size_t signatures_count, sz_size_t signature_length, sz_size_t *matches) {
+    for (sz_size_t i = 0; i != signatures_count; ++i, signatures += signature_length) {
+        sz_size_t count = 0;
+        for (sz_size_t slot = 0; slot != signature_length; ++slot) count += query[slot] == signatures[slot];
+        matches[i] = count;
+    }
+}
+
+SZ_PUBLIC void sz_minhash_bands(sz_u64_t const *signature, sz_size_t signature_length, sz_size_t band_length,
+                                sz_u64_t *band_hashes) {
+    if (!band_length) return;
+    sz_size_t const bands_count = signature_length / band_length;
+    for (sz_size_t band = 0; band != bands_count; ++band, signature += band_length) {
+        sz_u64_t hash = (sz_u64_t)band * 0x9E3779B97F4A7C15ull;
+        for (sz_size_t slot = 0; slot != band_length; ++slot) {
+            hash ^= signature[slot] + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            hash *= 0xBF58476D1CE4E5B9ull;
+        }
+        band_hashes[band] = hash ^ (hash >> 31);
+    }
+}
+
+/**
+ *  @brief  Uses a small lookup-table to convert a nucleotide character into a 2-bit code,
+ *          mapping 'A', 'C', 'G', 'T' to 0, 1, 2, 3, ignoring the case, and everything else to 4.
+ */
+SZ_INTERNAL sz_u8_t _sz_nucleotide_code(sz_u8_t c) {
+    static sz_u8_t const codes[256] = {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 0, 4, 1, 4, 4, 4, 2, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 0, 4, 1, 4, 4, 4, 2, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, //
+    };
+    return codes[c];
+}
+
+/**
+ *  @brief  Appends a nucleotide to the forward and reverse complement k-mers, packed with 2 bits per nucleotide.
+ *  @return True, if the last ::k characters were all nucleotides and the ::kmer is ready.
+ */
+SZ_INTERNAL sz_bool_t _sz_kmer_roll(sz_u8_t c, sz_size_t k, sz_bool_t canonical, sz_u64_t *forward,
+                                    sz_u64_t *reverse, sz_size_t *run, sz_u64_t *kmer) {
+    sz_u64_t const code = _sz_nucleotide_code(c);
+    if (code > 3) {
+        *run = 0;
+        return sz_false_k;
+    }
+    sz_u64_t const mask = k == 32 ? ~0ull : (1ull << (2 * k)) - 1ull;
+    *forward = ((*forward << 2) | code) & mask;
+    *reverse = (*reverse >> 2) | ((3ull - code) << (2 * k - 2));
+    if (++*run < k) return sz_false_k;
+    *kmer = canonical && *reverse < *forward ? *reverse : *forward;
+    return sz_true_k;
+}
+
+/** @brief  Invertible mix of a packed k-mer, used to order the minimizers. */
+SZ_INTERNAL sz_u64_t _sz_kmer_hash(sz_u64_t x) {
+    x = (x ^ (x >> 31)) * 0x7FB5D329728EA185ull;
+    x = (x ^ (x >> 27)) * 0x81DADEF4BC2DD44Dull;
+    return x ^ (x >> 33);
+}
+
+SZ_PUBLIC sz_size_t sz_kmers(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_bool_t canonical, sz_u64_t *kmers,
+                             sz_size_t *positions, sz_size_t capacity) {
+    if (!k || k > 32) return 0;
+    sz_u8_t const *text_u8 = (sz_u8_t const *)text;
+    sz_u64_t forward = 0, reverse = 0, kmer;
+    sz_size_t run = 0, count = 0;
+    for (sz_size_t i = 0; i != length && count < capacity; ++i) {
+        if (!_sz_kmer_roll(text_u8[i], k, canonical, &forward, &reverse, &run, &kmer)) continue;
+        kmers[count] = kmer;
+        if (positions) positions[count] = i + 1 - k;
+        ++count;
+    }
+    return count;
+}
+
+SZ_PUBLIC sz_size_t sz_kmers_count(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_bool_t canonical,
+                                   sz_u64_t *kmers, sz_size_t *counts, sz_size_t capacity,
+                                   sz_memory_allocator_t *alloc) {
+    if (!k || k > 32 || !capacity || length < k) return 0;
+
+    // Keep the hash-table at most half full, storing the indices of the exported k-mers.
+    sz_size_t const max_distinct = sz_min_of_two(capacity, length - k + 1);
+    sz_size_t const slots_count = (sz_size_t)1 << (sz_size_log2i_nonzero(max_distinct) + 2);
+    sz_size_t const slots_mask = slots_count - 1;
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    sz_size_t *slots = (sz_size_t *)alloc->allocate(slots_count * sizeof(sz_size_t), alloc->handle);
+    if (!slots) return SZ_SIZE_MAX;
+    for (sz_size_t i = 0; i != slots_count; ++i) slots[i] = SZ_SIZE_MAX;
+
+    sz_u8_t const *text_u8 = (sz_u8_t const *)text;
+    sz_u64_t forward = 0, reverse = 0, kmer;
+    sz_size_t run = 0, count = 0;
+    for (sz_size_t i = 0; i != length; ++i) {
+        if (!_sz_kmer_roll(text_u8[i], k, canonical, &forward, &reverse, &run, &kmer)) continue;
+        sz_size_t slot = (sz_size_t)_sz_kmer_hash(kmer) & slots_mask;
+        while (slots[slot] != SZ_SIZE_MAX && kmers[slots[slot]] != kmer) slot = (slot + 1) & slots_mask;
+        if (slots[slot] != SZ_SIZE_MAX) { ++counts[slots[slot]]; }
+        else if (count < capacity) {
+            slots[slot] = count;
+            kmers[count] = kmer;
+            counts[count] = 1;
+            ++count;
+        }
+    }
+
+    alloc->free((sz_ptr_t)slots, slots_count * sizeof(sz_size_t), alloc->handle);
+    return count;
+}
+
+SZ_PUBLIC sz_size_t sz_minimizers(sz_cptr_t text, sz_size_t length, sz_size_t k, sz_size_t w, sz_bool_t canonical,
+                                  sz_u64_t *hashes, sz_size_t *positions, sz_size_t capacity,
+                                  sz_memory_allocator_t *alloc) {
+    if (!k || k > 32 || !w || !capacity || length < k) return 0;
+
+    // Keep the hashes and positions of the last `w` k-mers in a ring buffer.
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    sz_size_t const buffer_length = w * (sizeof(sz_u64_t) + sizeof(sz_size_t));
+    sz_u64_t *ring_hashes = (sz_u64_t *)alloc->allocate(buffer_length, alloc->handle);
+    if (!ring_hashes) return SZ_SIZE_MAX;
+    sz_size_t *ring_positions = (sz_size_t *)(ring_hashes + w);
+
+    sz_u8_t const *text_u8 = (sz_u8_t const *)text;
+    sz_u64_t forward = 0, reverse = 0, kmer, min_hash = 0;
+    sz_size_t run = 0, kmers_in_run = 0, min_index = SZ_SIZE_MAX, count = 0;
+    for (sz_size_t i = 0; i <= length && count < capacity; ++i) {
+        // Sequences with fewer than `w` k-mers export the minimum of all of them, once they end.
+        if (i == length || _sz_nucleotide_code(text_u8[i]) > 3) {
+            if (kmers_in_run && kmers_in_run < w) {
+                min_index = 0, min_hash = ring_hashes[0];
+                for (sz_size_t j = 1; j != kmers_in_run; ++j)
+                    if (ring_hashes[j] <= min_hash) min_index = j, min_hash = ring_hashes[j];
+                hashes[count] = min_hash;
+                if (positions) positions[count] = ring_positions[min_index];
+                ++count;
+            }
+            kmers_in_run = 0, min_index = SZ_SIZE_MAX, run = 0;
+            continue;
+        }
+        if (!_sz_kmer_roll(text_u8[i], k, canonical, &forward, &reverse, &run, &kmer)) continue;
+
+        sz_size_t const last = kmers_in_run++;
+        ring_hashes[last % w] = _sz_kmer_hash(kmer);
+        ring_positions[last % w] = i + 1 - k;
+        if (last + 1 < w) continue;
+
+        // If the previous minimizer has left the window, rescan it, preferring the rightmost minimum.
+        // Otherwise, only a strictly smaller incoming hash can replace it.
+        sz_size_t const first = last + 1 - w;
+        if (min_index == SZ_SIZE_MAX || min_index < first) {
+            min_index = first, min_hash = ring_hashes[first % w];
+            for (sz_size_t j = first + 1; j <= last; ++j)
+                if (ring_hashes[j % w] <= min_hash) min_index = j, min_hash = ring_hashes[j % w];
+        }
+        else if (ring_hashes[last % w] < min_hash)
+            min_index = last, min_hash = ring_hashes[last % w];
+        else
+            continue;
+
+        hashes[count] = min_hash;
+        if (positions) positions[count] = ring_positions[min_index % w];
+        ++count;
+    }
+
+    alloc->free((sz_ptr_t)ring_hashes, buffer_length, alloc->handle);
+    return count;
+}
+
+/**
+ *  @brief  Loads up to 8 bytes of a packed buffer into a little-endian 64-bit word, never reading past its end.
+ */
+SZ_INTERNAL sz_u64_t _sz_u64_load_le_until(sz_u8_t const *bytes, sz_size_t length) {
+    sz_u64_t word = 0;
+    if (length >= 8) {
+#if !SZ_DETECT_BIG_ENDIAN
+        return sz_u64_load((sz_cptr_t)bytes).u64;
+#else
+        return sz_u64_bytes_reverse(sz_u64_load((sz_cptr_t)bytes).u64);
+#endif
+    }
+    for (sz_size_t i = 0; i != length; ++i) word |= (sz_u64_t)bytes[i] << (i * 8);
+    return word;
+}
+
+/**
+ *  @brief  Loads 32 packed nucleotides starting from an arbitrary nucleotide offset into a 64-bit word.
+ *          The nucleotides past the end of the buffer are zeros.
+ */
+SZ_INTERNAL sz_u64_t _sz_nucleotides_load(sz_u8_t const *packed, sz_size_t packed_bytes, sz_size_t offset) {
+    sz_size_t const byte = offset / 4;
+    int const shift = (int)(offset % 4) * 2;
+    sz_u64_t word = _sz_u64_load_le_until(packed + byte, packed_bytes - byte) >> shift;
+    if (shift && byte + 8 < packed_bytes) word |= (sz_u64_t)packed[byte + 8] << (64 - shift);
+    return word;
+}
+
+SZ_PUBLIC sz_size_t sz_nucleotides_pack(sz_cptr_t text, sz_size_t length, sz_ptr_t packed, sz_ptr_t n_mask) {
+    sz_u8_t const *text_u8 = (sz_u8_t const *)text;
+    sz_u8_t *packed_u8 = (sz_u8_t *)packed;
+    sz_u8_t *n_mask_u8 = (sz_u8_t *)n_mask;
+    sz_size_t unknowns = 0, i = 0;
+
+#if !SZ_DETECT_BIG_ENDIAN
+    // In ASCII, `((c >> 1) ^ (c >> 2)) & 3` maps both cases of 'A', 'C', 'G', 'T' to 0, 1, 2, 3.
+    // So we can convert 8 characters at a time, and squeeze the eight 2-bit codes into 16 bits.
+    sz_u64_vec_t text_vec, lower_vec, valid_vec;
+    sz_u64_vec_t a_vec, c_vec, g_vec, t_vec;
+    a_vec.u64 = 0x6161616161616161ull, c_vec.u64 = 0x6363636363636363ull;
+    g_vec.u64 = 0x6767676767676767ull, t_vec.u64 = 0x7474747474747474ull;
+    for (; i + 8 <= length; i += 8) {
+        text_vec = sz_u64_load((sz_cptr_t)(text_u8 + i));
+        sz_u64_t codes = ((text_vec.u64 >> 1) ^ (text_vec.u64 >> 2)) & 0x0303030303030303ull;
+        codes = (codes | (codes >> 6)) & 0x000F000F000F000Full;
+        codes = (codes | (codes >> 12)) & 0x000000FF000000FFull;
+        codes = (codes | (codes >> 24)) & 0x000000000000FFFFull;
+        packed_u8[i / 4] = (sz_u8_t)codes;
+        packed_u8[i / 4 + 1] = (sz_u8_t)(codes >> 8);
+
+        // Detect the unknown characters, comparing the lowercase bytes to every nucleotide.
+        lower_vec.u64 = text_vec.u64 | 0x2020202020202020ull;
+        valid_vec.u64 = _sz_u64_each_byte_equal(lower_vec, a_vec).u64 | _sz_u64_each_byte_equal(lower_vec, c_vec).u64;
+        valid_vec.u64 |= _sz_u64_each_byte_equal(lower_vec, g_vec).u64 | _sz_u64_each_byte_equal(lower_vec, t_vec).u64;
+        sz_u64_t const unknown_bits = ~valid_vec.u64 & 0x8080808080808080ull;
+        if (unknown_bits) {
+            for (sz_size_t j = 0; j != 8; ++j)
+                if (unknown_bits & (0x80ull << (j * 8)))
+                    packed_u8[(i + j) / 4] &= (sz_u8_t) ~(3u << ((i + j) % 4 * 2));
+            unknowns += sz_u64_popcount(unknown_bits);
+        }
+        // Squeeze the top bits of every byte into a single byte of the mask.
+        if (n_mask_u8) n_mask_u8[i / 8] = (sz_u8_t)((unknown_bits >> 7) * 0x0102040810204080ull >> 56);
+    }
+#endif
+
+    // Process the tail one character at a time.
+    for (; i != length; ++i) {
+        sz_u8_t code = _sz_nucleotide_code(text_u8[i]);
+        sz_u8_t const is_unknown = code > 3;
+        unknowns += is_unknown;
+        code = is_unknown ? 0 : code;
+        if (i % 4 == 0) packed_u8[i / 4] = 0;
+        packed_u8[i / 4] |= (sz_u8_t)(code << (i % 4 * 2));
+        if (!n_mask_u8) continue;
+        if (i % 8 == 0) n_mask_u8[i / 8] = 0;
+        n_mask_u8[i / 8] |= (sz_u8_t)(is_unknown << (i % 8));
+    }
+    return unknowns;
+}
+
+SZ_PUBLIC void sz_nucleotides_unpack(sz_cptr_t packed, sz_cptr_t n_mask, sz_size_t length, sz_ptr_t text) {
+    sz_u8_t const *packed_u8 = (sz_u8_t const *)packed;
+    sz_u8_t const *n_mask_u8 = (sz_u8_t const *)n_mask;
+    char const nucleotides[4] = {'A', 'C', 'G', 'T'};
+    for (sz_size_t i = 0; i != length; ++i) {
+        sz_bool_t const is_unknown = (sz_bool_t)(n_mask_u8 && ((n_mask_u8[i / 8] >> (i % 8)) & 1));
+        text[i] = is_unknown ? 'N' : nucleotides[(packed_u8[i / 4] >> (i % 4 * 2)) & 3];
+    }
+}
+
+SZ_PUBLIC sz_size_t sz_nucleotides_hamming(sz_cptr_t a, sz_cptr_t b, sz_size_t length) {
+    sz_u8_t const *a_u8 = (sz_u8_t const *)a;
+    sz_u8_t const *b_u8 = (sz_u8_t const *)b;
+    sz_size_t const packed_bytes = (length + 3) / 4;
+    sz_size_t distance = 0;
+    for (sz_size_t offset = 0; offset < length; offset += 32) {
+        sz_size_t const byte = offset / 4;
+        sz_u64_t const differences = _sz_u64_load_le_until(a_u8 + byte, packed_bytes - byte) ^
+                                     _sz_u64_load_le_until(b_u8 + byte, packed_bytes - byte);
+        // A nucleotide differs, if any of its two bits differ.
+        sz_u64_t different_nucleotides = (differences | (differences >> 1)) & 0x5555555555555555ull;
+        if (length - offset < 32) different_nucleotides &= (1ull << ((length - offset) * 2)) - 1;
+        distance += sz_u64_popcount(different_nucleotides);
+    }
+    return distance;
+}
+
+SZ_PUBLIC void sz_nucleotides_reverse_complement(sz_cptr_t packed, sz_size_t length, sz_ptr_t result) {
+    sz_u8_t const *packed_u8 = (sz_u8_t const *)packed;
+    sz_u8_t *result_u8 = (sz_u8_t *)result;
+    sz_size_t const packed_bytes = (length + 3) / 4;
+
+    // Every output word of 32 nucleotides is a complemented and reversed word of the input,
+    // ending at the mirrored offset. The complement of a 2-bit code `x` is `3 - x`, or just `~x`.
+    for (sz_size_t offset = 0; offset < length; offset += 32) {
+        sz_size_t const count = sz_min_of_two(length - offset, 32);
+        sz_size_t const source_offset = length - offset - count;
+        sz_u64_t word = ~_sz_nucleotides_load(packed_u8, packed_bytes, source_offset);
+        // Reverse the order of 2-bit groups: bytes first, then nibbles, then pairs of bits.
+        word = sz_u64_bytes_reverse(word);
+        word = ((word >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((word & 0x0F0F0F0F0F0F0F0Full) << 4);
+        word = ((word >> 2) & 0x3333333333333333ull) | ((word & 0x3333333333333333ull) << 2);
+        // If the word is incomplete, the meaningful nucleotides are now at the top.
+        word >>= (32 - count) * 2;
+        for (sz_size_t i = 0; i < (count + 3) / 4; ++i) result_u8[offset / 4 + i] = (sz_u8_t)(word >> (i * 8));
+    }
+}
+
+SZ_PUBLIC sz_size_t sz_nucleotides_find(sz_cptr_t haystack, sz_size_t h_length, sz_cptr_t h_mask, sz_cptr_t needle,
+                                        sz_size_t n_length) {
+    if (!n_length || n_length > h_length) return SZ_SIZE_MAX;
+    sz_u8_t const *h_u8 = (sz_u8_t const *)haystack;
+    sz_u8_t const *n_u8 = (sz_u8_t const *)needle;
+    sz_u8_t const *mask_u8 = (sz_u8_t const *)h_mask;
+    sz_size_t const h_bytes = (h_length + 3) / 4, n_bytes = (n_length + 3) / 4;
+
+    // Compare the first 32 nucleotides of the needle at every offset, and only then check the rest.
+    sz_size_t const prefix_length = sz_min_of_two(n_length, 32);
+    sz_u64_t const prefix_mask = prefix_length == 32 ? ~0ull : (1ull << (prefix_length * 2)) - 1;
+    sz_u64_t const prefix = _sz_nucleotides_load(n_u8, n_bytes, 0) & prefix_mask;
+    for (sz_size_t offset = 0; offset + n_length <= h_length; ++offset) {
+        if ((_sz_nucleotides_load(h_u8, h_bytes, offset) & prefix_mask) != prefix) continue;
+        sz_size_t checked = prefix_length;
+        for (; checked < n_length; checked += 32) {
+            sz_size_t const count = sz_min_of_two(n_length - checked, 32);
+            sz_u64_t const mask = count == 32 ? ~0ull : (1ull << (count * 2)) - 1;
+            if ((_sz_nucleotides_load(h_u8, h_bytes, offset + checked) & mask) !=
+                (_sz_nucleotides_load(n_u8, n_bytes, checked) & mask))
+                break;
+        }
+        if (checked < n_length) continue;
+        // Unknown nucleotides of the haystack never match.
+        sz_bool_t has_unknowns = sz_false_k;
+        for (sz_size_t i = offset; mask_u8 && i != offset + n_length && !has_unknowns; ++i)
+            has_unknowns = (sz_bool_t)((mask_u8[i / 8] >> (i % 8)) & 1);
+        if (!has_unknowns) return offset;
+    }
+    return SZ_SIZE_MAX;
+}
+
+/**
+ *  @brief  Uses a small lookup-table to convert a lowercase character to uppercase.
+ */
+SZ_INTERNAL sz_u8_t sz_u8_tolower(sz_u8_t c) {
+    static sz_u8_t const lowered[256] = {
+        0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  //
+        16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  //
+        32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  //
         48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  //
         64,  97,  98,  99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, //
         112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 91,  92,  93,  94,  95,  //
@@ -3268,35 +4595,140 @@ SZ_PUBLIC sz_size_t sz_partition(sz_sequence_t *sequence, sz_sequence_predicate_
     return matches;
 }
 
-SZ_PUBLIC void sz_merge(sz_sequence_t *sequence, sz_size_t partition, sz_sequence_comparator_t less) {
+SZ_PUBLIC sz_bool_t sz_merge_buffered(sz_sequence_t *sequence, sz_size_t partition, sz_sequence_comparator_t less,
+                                      sz_sorted_idx_t *buffer, sz_memory_allocator_t *alloc) {
+
+    sz_sorted_idx_t *order = sequence->order;
+    sz_size_t const count = sequence->count;
+    if (partition == 0 || partition >= count) return sz_true_k;
+
+    // If the direct merge is already sorted.
+    if (!less(sequence, order[partition], order[partition - 1])) return sz_true_k;
+
+    sz_size_t const buffer_length = sz_min_of_two(partition, count - partition);
+    sz_size_t const buffer_bytes = buffer_length * sizeof(sz_sorted_idx_t);
+    sz_memory_allocator_t global_alloc;
+    sz_bool_t const owns_buffer = (sz_bool_t)(buffer == SZ_NULL);
+    if (owns_buffer) {
+        if (!alloc) {
+            sz_memory_allocator_init_default(&global_alloc);
+            alloc = &global_alloc;
+        }
+        buffer = (sz_sorted_idx_t *)alloc->allocate(buffer_bytes, alloc->handle);
+        if (!buffer) return sz_false_k;
+    }
+
+    // With a shorter first chunk, merge forward from the buffer and the second chunk.
+    if (partition <= count - partition) {
+        for (sz_size_t i = 0; i != partition; ++i) buffer[i] = order[i];
+        sz_size_t a = 0, b = partition, output = 0;
+        while (a != partition && b != count)
+            order[output++] = less(sequence, order[b], buffer[a]) ? order[b++] : buffer[a++];
+        while (a != partition) order[output++] = buffer[a++];
+    }
+    // With a shorter second chunk, merge backward from the first chunk and the buffer.
+    else {
+        sz_size_t const length_b = count - partition;
+        for (sz_size_t i = 0; i != length_b; ++i) buffer[i] = order[partition + i];
+        sz_size_t a = partition, b = length_b, output = count;
+        while (a != 0 && b != 0)
+            order[--output] = less(sequence, buffer[b - 1], order[a - 1]) ? order[--a] : buffer[--b];
+        while (b != 0) order[--output] = buffer[--b];
+    }
+
+    if (owns_buffer) alloc->free(buffer, buffer_bytes, alloc->handle);
+    return sz_true_k;
+}
 
-    sz_size_t start_b = partition + 1;
+SZ_PUBLIC void sz_merge(sz_sequence_t *sequence, sz_size_t partition, sz_sequence_comparator_t less) {
 
-    // If the direct merge is already sorted
-    if (!less(sequence, sequence->order[start_b], sequence->order[partition])) return;
+    if (sz_merge_buffered(sequence, partition, less, SZ_NULL, SZ_NULL)) return;
 
-    sz_size_t start_a = 0;
-    while (start_a <= partition && start_b <= sequence->count) {
+    // Without scratch space, insert the elements of the second chunk one by one, shifting the first.
+    sz_sorted_idx_t *order = sequence->order;
+    sz_size_t start_a = 0, start_b = partition;
+    while (start_a < start_b && start_b < sequence->count) {
 
         // If element 1 is in right place
-        if (!less(sequence, sequence->order[start_b], sequence->order[start_a])) { start_a++; }
+        if (!less(sequence, order[start_b], order[start_a])) { start_a++; }
         else {
-            sz_size_t value = sequence->order[start_b];
+            sz_sorted_idx_t value = order[start_b];
             sz_size_t index = start_b;
 
             // Shift all the elements between element 1
             // element 2, right by 1.
-            while (index != start_a) { sequence->order[index] = sequence->order[index - 1], index--; }
-            sequence->order[start_a] = value;
+            while (index != start_a) { order[index] = order[index - 1], index--; }
+            order[start_a] = value;
 
             // Update all the pointers
             start_a++;
-            partition++;
             start_b++;
         }
     }
 }
 
+/**
+ *  @brief  Checks if the head of chunk @p i should go before the head of chunk @p j in `sz_merge_many`,
+ *          breaking ties by the chunk index to keep the merge stable.
+ */
+SZ_INTERNAL sz_bool_t _sz_merge_many_is_less(sz_sequence_t const *sequence, sz_sequence_comparator_t less,
+                                             sz_size_t const *cursors, sz_size_t i, sz_size_t j) {
+    sz_sorted_idx_t i_key = sequence->order[cursors[i]], j_key = sequence->order[cursors[j]];
+    if (less(sequence, i_key, j_key)) return sz_true_k;
+    if (less(sequence, j_key, i_key)) return sz_false_k;
+    return (sz_bool_t)(i < j);
+}
+
+SZ_PUBLIC sz_bool_t sz_merge_many(sz_sequence_t const *sequence, sz_size_t const *offsets, sz_size_t count,
+                                  sz_sequence_comparator_t less, sz_sorted_idx_t *output,
+                                  sz_memory_allocator_t *alloc) {
+
+    // Simplify usage in higher-level libraries, where wrapping custom allocators may be troublesome.
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    if (!count) return sz_true_k;
+
+    // Keep a min-heap of non-empty chunks, and the offsets of their current heads.
+    sz_size_t const buffer_bytes = 2 * count * sizeof(sz_size_t);
+    sz_size_t *heap = (sz_size_t *)alloc->allocate(buffer_bytes, alloc->handle);
+    if (!heap) return sz_false_k;
+    sz_size_t *cursors = heap + count;
+    sz_size_t heap_size = 0;
+    for (sz_size_t i = 0; i != count; ++i) {
+        cursors[i] = offsets[i];
+        if (offsets[i] == offsets[i + 1]) continue;
+        // Sift the new chunk up.
+        sz_size_t child = heap_size++;
+        while (child && _sz_merge_many_is_less(sequence, less, cursors, i, heap[(child - 1) / 2]))
+            heap[child] = heap[(child - 1) / 2], child = (child - 1) / 2;
+        heap[child] = i;
+    }
+
+    sz_size_t exported = 0;
+    while (heap_size) {
+        sz_size_t top = heap[0];
+        output[exported++] = sequence->order[cursors[top]++];
+        // Replace the exhausted chunk with the last one in the heap, and sift it down.
+        if (cursors[top] == offsets[top + 1]) top = heap[--heap_size];
+        sz_size_t root = 0;
+        while (1) {
+            sz_size_t child = 2 * root + 1;
+            if (child >= heap_size) break;
+            if (child + 1 < heap_size && _sz_merge_many_is_less(sequence, less, cursors, heap[child + 1], heap[child]))
+                ++child;
+            if (!_sz_merge_many_is_less(sequence, less, cursors, heap[child], top)) break;
+            heap[root] = heap[child], root = child;
+        }
+        if (heap_size) heap[root] = top;
+    }
+
+    alloc->free(heap, buffer_bytes, alloc->handle);
+    return sz_true_k;
+}
+
 SZ_PUBLIC void sz_sort_insertion(sz_sequence_t *sequence, sz_sequence_comparator_t less) {
     sz_u64_t *keys = sequence->order;
     sz_size_t keys_count = sequence->count;
@@ -3341,6 +4773,28 @@ SZ_INTERNAL void _sz_heapsort(sz_sequence_t *sequence, sz_sequence_comparator_t
     }
 }
 
+/**
+ *  @brief  Heap-selection of the @p partial_order_length smallest elements of the sequence, and their heap-sort.
+ *          Costs O(N * logK) comparisons, placing the selected elements in the head in order, and the rest after.
+ */
+SZ_INTERNAL void _sz_sort_partial_heap(sz_sequence_t *sequence, sz_sequence_comparator_t less,
+                                       sz_size_t partial_order_length) {
+    sz_u64_t *order = sequence->order;
+    if (partial_order_length == 0) return;
+
+    // Keep the largest of the selected elements at the root of a max-heap, to replace it with the smaller ones.
+    if (partial_order_length > 1) _sz_heapify(sequence, less, order, partial_order_length);
+    for (sz_size_t i = partial_order_length; i < sequence->count; ++i) {
+        if (!less(sequence, order[i], order[0])) continue;
+        sz_u64_swap(order + i, order);
+        _sz_sift_down(sequence, less, order, 0, partial_order_length - 1);
+    }
+    for (sz_size_t end = partial_order_length - 1; end > 0; --end) {
+        sz_u64_swap(order, order + end);
+        _sz_sift_down(sequence, less, order, 0, end - 1);
+    }
+}
+
 SZ_PUBLIC void sz_sort_introsort_recursion(sz_sequence_t *sequence, sz_sequence_comparator_t less, sz_size_t first,
                                            sz_size_t last, sz_size_t depth) {
 
@@ -3423,9 +4877,10 @@ SZ_PUBLIC void sz_sort_recursion( //
     if (!sequence->count) return;
 
     // Array of size one doesn't need sorting - only needs the prefix to be discarded.
-    if (sequence->count == 1) {
+    // The same applies to the buckets, that fall beyond the partially sorted head.
+    if (sequence->count == 1 || partial_order_length == 0) {
         sz_u32_t *order_half_words = (sz_u32_t *)sequence->order;
-        order_half_words[1] = 0;
+        for (sz_size_t i = 0; i != sequence->count; ++i) order_half_words[i * 2 + 1] = 0;
         return;
     }
 
@@ -3468,16 +4923,18 @@ SZ_PUBLIC void sz_sort_recursion( //
         }
     }
 
-    // Go down recursively.
+    // Go down recursively, only sorting the part of the second bucket, that falls into the partially sorted head.
+    sz_size_t partial_a = sz_min_of_two(partial_order_length, split);
+    sz_size_t partial_b = partial_order_length > split ? partial_order_length - split : 0;
     if (bit_idx < bit_max) {
         sz_sequence_t a = *sequence;
         a.count = split;
-        sz_sort_recursion(&a, bit_idx + 1, bit_max, comparator, partial_order_length);
+        sz_sort_recursion(&a, bit_idx + 1, bit_max, comparator, partial_a);
 
         sz_sequence_t b = *sequence;
         b.order += split;
         b.count -= split;
-        sz_sort_recursion(&b, bit_idx + 1, bit_max, comparator, partial_order_length);
+        sz_sort_recursion(&b, bit_idx + 1, bit_max, comparator, partial_b);
     }
     // Reached the end of recursion.
     else {
@@ -3485,55 +4942,910 @@ SZ_PUBLIC void sz_sort_recursion( //
         sz_u32_t *order_half_words = (sz_u32_t *)sequence->order;
         for (sz_size_t i = 0; i != sequence->count; ++i) { order_half_words[i * 2 + 1] = 0; }
 
+        // Fully sort the buckets, that fit into the head, and select the smallest elements from the others.
         sz_sequence_t a = *sequence;
         a.count = split;
-        sz_sort_introsort(&a, comparator);
+        if (partial_a == a.count) sz_sort_introsort(&a, comparator);
+        else _sz_sort_partial_heap(&a, comparator, partial_a);
+
+        sz_sequence_t b = *sequence;
+        b.order += split;
+        b.count -= split;
+        if (partial_b == b.count) sz_sort_introsort(&b, comparator);
+        else _sz_sort_partial_heap(&b, comparator, partial_b);
+    }
+}
+
+SZ_INTERNAL sz_bool_t _sz_sort_is_less(sz_sequence_t *sequence, sz_size_t i_key, sz_size_t j_key) {
+    sz_cptr_t i_str = sequence->get_start(sequence, i_key);
+    sz_cptr_t j_str = sequence->get_start(sequence, j_key);
+    sz_size_t i_len = sequence->get_length(sequence, i_key);
+    sz_size_t j_len = sequence->get_length(sequence, j_key);
+    return (sz_bool_t)(sz_order_serial(i_str, i_len, j_str, j_len) == sz_less_k);
+}
+
+SZ_PUBLIC void sz_sort_partial(sz_sequence_t *sequence, sz_size_t partial_order_length) {
+
+    if (partial_order_length > sequence->count) partial_order_length = sequence->count;
+
+#if SZ_DETECT_BIG_ENDIAN
+    sz_sequence_comparator_t less = (sz_sequence_comparator_t)_sz_sort_is_less;
+    if (partial_order_length == sequence->count) sz_sort_introsort(sequence, less);
+    else _sz_sort_partial_heap(sequence, less, partial_order_length);
+#else
+
+    // Export up to 4 bytes into the `sequence` bits themselves
+    for (sz_size_t i = 0; i != sequence->count; ++i) {
+        sz_cptr_t begin = sequence->get_start(sequence, sequence->order[i]);
+        sz_size_t length = sequence->get_length(sequence, sequence->order[i]);
+        length = length > 4u ? 4u : length;
+        sz_ptr_t prefix = (sz_ptr_t)&sequence->order[i];
+        for (sz_size_t j = 0; j != length; ++j) prefix[7 - j] = begin[j];
+    }
+
+    // Perform optionally-parallel radix sort on them
+    sz_sort_recursion(sequence, 0, 32, (sz_sequence_comparator_t)_sz_sort_is_less, partial_order_length);
+#endif
+}
+
+SZ_PUBLIC void sz_sort(sz_sequence_t *sequence) {
+#if SZ_DETECT_BIG_ENDIAN
+    sz_sort_introsort(sequence, (sz_sequence_comparator_t)_sz_sort_is_less);
+#else
+    sz_sort_partial(sequence, sequence->count);
+#endif
+}
+
+SZ_INTERNAL sz_bool_t _sz_sort_is_less_index(sz_sequence_t *sequence, sz_size_t i_key, sz_size_t j_key) {
+    sz_unused(sequence);
+    return (sz_bool_t)(i_key < j_key);
+}
+
+/**
+ *  @brief  Sequence of the incoming positions in `sz_sort_stable`, forwarding to the strings of the original keys.
+ */
+typedef struct _sz_sort_stable_positions_t {
+    sz_sequence_t const *original;
+    sz_sorted_idx_t const *keys;
+} _sz_sort_stable_positions_t;
+
+SZ_INTERNAL sz_cptr_t _sz_sort_stable_get_start(sz_sequence_t const *sequence, sz_size_t position) {
+    _sz_sort_stable_positions_t const *positions = (_sz_sort_stable_positions_t const *)sequence->handle;
+    return positions->original->get_start(positions->original, positions->keys[position]);
+}
+
+SZ_INTERNAL sz_size_t _sz_sort_stable_get_length(sz_sequence_t const *sequence, sz_size_t position) {
+    _sz_sort_stable_positions_t const *positions = (_sz_sort_stable_positions_t const *)sequence->handle;
+    return positions->original->get_length(positions->original, positions->keys[position]);
+}
+
+SZ_PUBLIC sz_bool_t sz_sort_stable(sz_sequence_t *sequence, sz_memory_allocator_t *alloc) {
+    sz_size_t const count = sequence->count;
+    if (count < 2) return sz_true_k;
+
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    sz_size_t const keys_bytes = count * sizeof(sz_sorted_idx_t);
+    sz_sorted_idx_t *keys = (sz_sorted_idx_t *)alloc->allocate(keys_bytes, alloc->handle);
+    if (!keys) return sz_false_k;
+
+    // Sort the incoming positions instead of the keys, so the ties can be broken by the positions.
+    sz_sorted_idx_t *order = sequence->order;
+    for (sz_size_t i = 0; i != count; ++i) keys[i] = order[i], order[i] = i;
+    _sz_sort_stable_positions_t positions;
+    positions.original = sequence;
+    positions.keys = keys;
+    sz_sequence_t by_position = *sequence;
+    by_position.handle = &positions;
+    by_position.get_start = _sz_sort_stable_get_start;
+    by_position.get_length = _sz_sort_stable_get_length;
+    sz_sort(&by_position);
+
+    // The equal strings are already adjacent, so only the positions within their runs need to be ordered.
+    for (sz_size_t first = 0, last; first < count; first = last) {
+        sz_cptr_t first_start = sequence->get_start(sequence, keys[order[first]]);
+        sz_size_t first_length = sequence->get_length(sequence, keys[order[first]]);
+        for (last = first + 1; last != count; ++last)
+            if (sequence->get_length(sequence, keys[order[last]]) != first_length ||
+                !sz_equal(first_start, sequence->get_start(sequence, keys[order[last]]), first_length))
+                break;
+        if (last - first < 2) continue;
+
+        sz_sequence_t ties = by_position;
+        ties.order += first;
+        ties.count = last - first;
+        sz_sort_introsort(&ties, (sz_sequence_comparator_t)_sz_sort_is_less_index);
+    }
+
+    // Replace the sorted positions with the keys they came from.
+    for (sz_size_t i = 0; i != count; ++i) order[i] = keys[order[i]];
+    alloc->free((sz_ptr_t)keys, keys_bytes, alloc->handle);
+    return sz_true_k;
+}
+
+SZ_PUBLIC void sz_collation_ranks_case_fold(sz_u8_t *ranks) {
+    for (sz_size_t i = 0; i != 256; ++i) ranks[i] = (sz_u8_t)(i >= 'A' && i <= 'Z' ? i + ('a' - 'A') : i);
+}
+
+SZ_INTERNAL sz_bool_t _sz_is_digit(sz_u8_t c) { return (sz_bool_t)(c >= '0' && c <= '9'); }
+
+SZ_INTERNAL sz_u8_t _sz_collation_digits_rank(sz_u8_t const *ranks) {
+    sz_u8_t digits_rank = ranks['0'];
+    for (sz_u8_t c = '1'; c <= '9'; ++c) digits_rank = sz_min_of_two(digits_rank, ranks[c]);
+    return digits_rank;
+}
+
+/**
+ *  @brief  Compares two strings under a collation with a mandatory @p ranks table.
+ *          In the @p natural order, digits are ranked as @p digits_rank against other characters,
+ *          and if the latter have the same rank, the digits come first.
+ */
+SZ_INTERNAL sz_ordering_t _sz_order_ranked(sz_u8_t const *a, sz_size_t a_length, sz_u8_t const *b,
+                                           sz_size_t b_length, sz_u8_t const *ranks, sz_bool_t natural,
+                                           sz_u8_t digits_rank) {
+    sz_u8_t const *const a_end = a + a_length;
+    sz_u8_t const *const b_end = b + b_length;
+    while (a != a_end && b != b_end) {
+        sz_bool_t a_is_digit = (sz_bool_t)(natural && _sz_is_digit(*a));
+        sz_bool_t b_is_digit = (sz_bool_t)(natural && _sz_is_digit(*b));
+        if (a_is_digit != b_is_digit) return (a_is_digit ? ranks[*b] >= digits_rank : ranks[*a] < digits_rank)
+                                                 ? sz_less_k
+                                                 : sz_greater_k;
+        if (!a_is_digit) {
+            if (ranks[*a] != ranks[*b]) return ranks[*a] < ranks[*b] ? sz_less_k : sz_greater_k;
+            ++a, ++b;
+            continue;
+        }
+
+        // Compare the runs of digits by their values: first by the number of significant digits, then by them.
+        while (a != a_end && *a == '0') ++a;
+        while (b != b_end && *b == '0') ++b;
+        sz_u8_t const *a_digits = a, *b_digits = b;
+        while (a != a_end && _sz_is_digit(*a)) ++a;
+        while (b != b_end && _sz_is_digit(*b)) ++b;
+        sz_size_t a_digits_count = (sz_size_t)(a - a_digits), b_digits_count = (sz_size_t)(b - b_digits);
+        if (a_digits_count != b_digits_count) return a_digits_count < b_digits_count ? sz_less_k : sz_greater_k;
+        for (; a_digits != a; ++a_digits, ++b_digits)
+            if (*a_digits != *b_digits) return *a_digits < *b_digits ? sz_less_k : sz_greater_k;
+    }
+    return a != a_end ? sz_greater_k : b != b_end ? sz_less_k : sz_equal_k;
+}
+
+SZ_PUBLIC sz_ordering_t sz_order_collated(sz_cptr_t a, sz_size_t a_length, sz_cptr_t b, sz_size_t b_length,
+                                          sz_collation_t const *collation) {
+    if (!collation || (!collation->ranks && !collation->natural)) return sz_order(a, a_length, b, b_length);
+    sz_u8_t identity[256];
+    sz_u8_t const *ranks = collation->ranks;
+    if (!ranks) {
+        for (sz_size_t i = 0; i != 256; ++i) identity[i] = (sz_u8_t)i;
+        ranks = identity;
+    }
+    return _sz_order_ranked((sz_u8_t const *)a, a_length, (sz_u8_t const *)b, b_length, ranks, collation->natural,
+                            _sz_collation_digits_rank(ranks));
+}
+
+/**
+ *  @brief  Helper structure for `sz_sort_collated`, wrapping the user-provided sequence into a new one,
+ *          so that the comparator can access the collation rules through its `handle`.
+ */
+typedef struct _sz_sort_collated_t {
+    sz_sequence_t const *sequence;
+    sz_u8_t const *ranks;
+    sz_bool_t natural;
+    sz_u8_t digits_rank;
+} _sz_sort_collated_t;
+
+SZ_INTERNAL sz_cptr_t _sz_sort_collated_start(sz_sequence_t const *wrapper, sz_size_t i) {
+    sz_sequence_t const *sequence = ((_sz_sort_collated_t const *)wrapper->handle)->sequence;
+    return sequence->get_start(sequence, i);
+}
+
+SZ_INTERNAL sz_size_t _sz_sort_collated_length(sz_sequence_t const *wrapper, sz_size_t i) {
+    sz_sequence_t const *sequence = ((_sz_sort_collated_t const *)wrapper->handle)->sequence;
+    return sequence->get_length(sequence, i);
+}
+
+SZ_INTERNAL sz_bool_t _sz_sort_collated_is_less(sz_sequence_t *wrapper, sz_size_t i_key, sz_size_t j_key) {
+    _sz_sort_collated_t const *collated = (_sz_sort_collated_t const *)wrapper->handle;
+    sz_sequence_t const *sequence = collated->sequence;
+    sz_u8_t const *i_str = (sz_u8_t const *)sequence->get_start(sequence, i_key);
+    sz_u8_t const *j_str = (sz_u8_t const *)sequence->get_start(sequence, j_key);
+    sz_size_t i_len = sequence->get_length(sequence, i_key);
+    sz_size_t j_len = sequence->get_length(sequence, j_key);
+    return (sz_bool_t)(_sz_order_ranked(i_str, i_len, j_str, j_len, collated->ranks, collated->natural,
+                                        collated->digits_rank) == sz_less_k);
+}
+
+SZ_PUBLIC void sz_sort_collated(sz_sequence_t *sequence, sz_collation_t const *collation) {
+    if (!collation || (!collation->ranks && !collation->natural)) {
+        sz_sort(sequence);
+        return;
+    }
+
+    sz_u8_t identity[256];
+    _sz_sort_collated_t collated;
+    collated.sequence = sequence;
+    collated.ranks = collation->ranks;
+    collated.natural = collation->natural;
+    if (!collated.ranks) {
+        for (sz_size_t i = 0; i != 256; ++i) identity[i] = (sz_u8_t)i;
+        collated.ranks = identity;
+    }
+    collated.digits_rank = _sz_collation_digits_rank(collated.ranks);
+
+    sz_sequence_t wrapper = *sequence;
+    wrapper.handle = &collated;
+    wrapper.get_start = _sz_sort_collated_start;
+    wrapper.get_length = _sz_sort_collated_length;
+    sz_sequence_comparator_t less = (sz_sequence_comparator_t)_sz_sort_collated_is_less;
+
+#if SZ_DETECT_BIG_ENDIAN
+    sz_sort_introsort(&wrapper, less);
+#else
+
+    // Export the ranks of up to 4 bytes into the `sequence` bits themselves. In the natural order, the first digit
+    // is exported with the rank of the whole run, and the following bytes are left zeroed, to be compared later.
+    for (sz_size_t i = 0; i != sequence->count; ++i) {
+        sz_u8_t const *begin = (sz_u8_t const *)sequence->get_start(sequence, sequence->order[i]);
+        sz_size_t length = sequence->get_length(sequence, sequence->order[i]);
+        length = length > 4u ? 4u : length;
+        sz_u8_t *prefix = (sz_u8_t *)&sequence->order[i];
+        for (sz_size_t j = 0; j != length; ++j) {
+            if (collated.natural && _sz_is_digit(begin[j])) {
+                prefix[7 - j] = collated.digits_rank;
+                break;
+            }
+            prefix[7 - j] = collated.ranks[begin[j]];
+        }
+    }
+    sz_sort_recursion(&wrapper, 0, 32, less, sequence->count);
+#endif
+}
+
+/**
+ *  @brief  Text of a single SA-IS recursion level. The top level is a byte string, optionally split into
+ *          a tape of strings, where the last byte of every string is ranked below the same byte elsewhere.
+ *          Deeper levels work with the integer names of LMS substrings.
+ */
+typedef struct _sz_sais_text_t {
+    sz_u8_t const *bytes;
+    sz_u8_t const *ends;
+    sz_size_t const *names;
+} _sz_sais_text_t;
+
+SZ_INTERNAL sz_size_t _sz_sais_at(_sz_sais_text_t const *text, sz_size_t i) {
+    if (text->names) return text->names[i];
+    if (text->ends) return ((sz_size_t)text->bytes[i] << 1) | (((text->ends[i >> 3] >> (i & 7)) & 1) ^ 1);
+    return text->bytes[i];
+}
+
+SZ_INTERNAL sz_bool_t _sz_sais_is_s(sz_u8_t const *types, sz_size_t i) {
+    return (sz_bool_t)((types[i >> 3] >> (i & 7)) & 1);
+}
+
+SZ_INTERNAL sz_bool_t _sz_sais_is_lms(sz_u8_t const *types, sz_size_t i) {
+    return (sz_bool_t)(i > 0 && _sz_sais_is_s(types, i) && !_sz_sais_is_s(types, i - 1));
+}
+
+/**
+ *  @brief  Fills the @p buckets with the first or the past-the-last offsets of every character in the suffix array.
+ */
+SZ_INTERNAL void _sz_sais_buckets(_sz_sais_text_t const *text, sz_size_t length, sz_size_t alphabet,
+                                  sz_size_t *buckets, sz_bool_t ends) {
+    for (sz_size_t c = 0; c != alphabet; ++c) buckets[c] = 0;
+    for (sz_size_t i = 0; i != length; ++i) ++buckets[_sz_sais_at(text, i)];
+    for (sz_size_t c = 0, sum = 0; c != alphabet; ++c) {
+        sz_size_t count = buckets[c];
+        buckets[c] = ends ? sum + count : sum;
+        sum += count;
+    }
+}
+
+/**
+ *  @brief  Induces the order of L-type suffixes from the sorted LMS ones, scanning forward from bucket heads,
+ *          and then the order of S-type suffixes, scanning backward from bucket tails.
+ */
+SZ_INTERNAL void _sz_sais_induce(_sz_sais_text_t const *text, sz_u8_t const *types, sz_size_t length,
+                                 sz_size_t alphabet, sz_size_t *buckets, sz_size_t *suffixes) {
+
+    // The last suffix is the smallest L-type one, as it only precedes the virtual sentinel.
+    _sz_sais_buckets(text, length, alphabet, buckets, sz_false_k);
+    suffixes[buckets[_sz_sais_at(text, length - 1)]++] = length - 1;
+    for (sz_size_t i = 0; i != length; ++i) {
+        sz_size_t j = suffixes[i];
+        if (j == SZ_SIZE_MAX || j == 0 || _sz_sais_is_s(types, j - 1)) continue;
+        suffixes[buckets[_sz_sais_at(text, j - 1)]++] = j - 1;
+    }
+
+    _sz_sais_buckets(text, length, alphabet, buckets, sz_true_k);
+    for (sz_size_t i = length; i-- > 0;) {
+        sz_size_t j = suffixes[i];
+        if (j == SZ_SIZE_MAX || j == 0 || !_sz_sais_is_s(types, j - 1)) continue;
+        suffixes[--buckets[_sz_sais_at(text, j - 1)]] = j - 1;
+    }
+}
+
+/**
+ *  @brief  Recursive SA-IS step. The reduced problem reuses the @p suffixes array: the names of LMS substrings
+ *          are gathered in its tail, and their suffix array is built in its head. The gap in between, if large
+ *          enough, serves as the bucket table of the next level, passed as @p workspace.
+ */
+SZ_INTERNAL sz_bool_t _sz_sais(_sz_sais_text_t const *text, sz_size_t length, sz_size_t alphabet,
+                               sz_size_t *suffixes, sz_size_t *workspace, sz_size_t workspace_length,
+                               sz_memory_allocator_t *alloc) {
+
+    if (length == 0) return sz_true_k;
+    if (length == 1) {
+        suffixes[0] = 0;
+        return sz_true_k;
+    }
+
+    sz_size_t const types_bytes = length / 8 + 1;
+    sz_size_t const buckets_bytes = alphabet * sizeof(sz_size_t);
+    sz_u8_t *types = (sz_u8_t *)alloc->allocate(types_bytes, alloc->handle);
+    if (!types) return sz_false_k;
+    sz_size_t *buckets = workspace_length >= alphabet ? workspace
+                                                      : (sz_size_t *)alloc->allocate(buckets_bytes, alloc->handle);
+    if (!buckets) {
+        alloc->free(types, types_bytes, alloc->handle);
+        return sz_false_k;
+    }
+
+    // Classify the suffixes into S-type, smaller than the following suffix, and L-type, larger than it.
+    for (sz_size_t i = 0; i != types_bytes; ++i) types[i] = 0;
+    for (sz_size_t i = length - 1, next = _sz_sais_at(text, length - 1); i-- > 0;) {
+        sz_size_t current = _sz_sais_at(text, i);
+        if (current < next || (current == next && _sz_sais_is_s(types, i + 1))) types[i >> 3] |= 1 << (i & 7);
+        next = current;
+    }
+
+    // Sort the LMS substrings, by placing them at the tails of their buckets and inducing the rest.
+    for (sz_size_t i = 0; i != length; ++i) suffixes[i] = SZ_SIZE_MAX;
+    _sz_sais_buckets(text, length, alphabet, buckets, sz_true_k);
+    for (sz_size_t i = 1; i != length; ++i)
+        if (_sz_sais_is_lms(types, i)) suffixes[--buckets[_sz_sais_at(text, i)]] = i;
+    _sz_sais_induce(text, types, length, alphabet, buckets, suffixes);
+
+    // Compact the sorted LMS substrings in the head, and name them, keeping the names in the tail.
+    // No two LMS positions are adjacent, so `position / 2` maps them into distinct slots.
+    sz_size_t lms_count = 0;
+    for (sz_size_t i = 0; i != length; ++i)
+        if (_sz_sais_is_lms(types, suffixes[i])) suffixes[lms_count++] = suffixes[i];
+    for (sz_size_t i = lms_count; i != length; ++i) suffixes[i] = SZ_SIZE_MAX;
+
+    sz_size_t names_count = 0;
+    for (sz_size_t i = 0, previous = SZ_SIZE_MAX; i != lms_count; ++i) {
+        sz_size_t position = suffixes[i];
+        sz_bool_t differs = (sz_bool_t)(previous == SZ_SIZE_MAX);
+        for (sz_size_t d = 0; !differs; ++d) {
+            // Only the last LMS substring reaches the virtual sentinel, so it is unique.
+            if (position + d == length || previous + d == length ||
+                _sz_sais_at(text, position + d) != _sz_sais_at(text, previous + d) ||
+                _sz_sais_is_s(types, position + d) != _sz_sais_is_s(types, previous + d))
+                differs = sz_true_k;
+            else if (d > 0 && _sz_sais_is_lms(types, position + d)) break;
+        }
+        if (differs) ++names_count, previous = position;
+        suffixes[lms_count + position / 2] = names_count - 1;
+    }
+    sz_size_t *reduced_text = suffixes + length - lms_count;
+    for (sz_size_t i = length, j = length; i-- > lms_count;)
+        if (suffixes[i] != SZ_SIZE_MAX) suffixes[--j] = suffixes[i];
+
+    // Sort the reduced text recursively, unless all of the names are unique.
+    // The bucket table isn't needed until we return, so we can release it to lower the peak memory usage.
+    if (buckets != workspace) alloc->free(buckets, buckets_bytes, alloc->handle);
+    if (names_count < lms_count) {
+        _sz_sais_text_t reduced;
+        reduced.bytes = SZ_NULL, reduced.ends = SZ_NULL, reduced.names = reduced_text;
+        if (!_sz_sais(&reduced, lms_count, names_count, suffixes, suffixes + lms_count, length - 2 * lms_count,
+                      alloc)) {
+            alloc->free(types, types_bytes, alloc->handle);
+            return sz_false_k;
+        }
+    }
+    else { for (sz_size_t i = 0; i != lms_count; ++i) suffixes[reduced_text[i]] = i; }
+    buckets = workspace_length >= alphabet ? workspace : (sz_size_t *)alloc->allocate(buckets_bytes, alloc->handle);
+    if (!buckets) {
+        alloc->free(types, types_bytes, alloc->handle);
+        return sz_false_k;
+    }
+
+    // Translate the reduced suffixes back into LMS positions, and put them at the tails of their buckets,
+    // going backwards to preserve their order. Then induce the order of all other suffixes.
+    for (sz_size_t i = 1, j = 0; i != length; ++i)
+        if (_sz_sais_is_lms(types, i)) reduced_text[j++] = i;
+    for (sz_size_t i = 0; i != lms_count; ++i) suffixes[i] = reduced_text[suffixes[i]];
+    for (sz_size_t i = lms_count; i != length; ++i) suffixes[i] = SZ_SIZE_MAX;
+    _sz_sais_buckets(text, length, alphabet, buckets, sz_true_k);
+    for (sz_size_t i = lms_count; i-- > 0;) {
+        sz_size_t position = suffixes[i];
+        suffixes[i] = SZ_SIZE_MAX;
+        suffixes[--buckets[_sz_sais_at(text, position)]] = position;
+    }
+    _sz_sais_induce(text, types, length, alphabet, buckets, suffixes);
+
+    if (buckets != workspace) alloc->free(buckets, buckets_bytes, alloc->handle);
+    alloc->free(types, types_bytes, alloc->handle);
+    return sz_true_k;
+}
+
+/**
+ *  @brief  Kasai's linear-time LCP construction, relying on the fact, that the common prefix of the next suffix
+ *          in text order is at most one character shorter. With a bitset of string @p ends, stops at them.
+ */
+SZ_INTERNAL sz_bool_t _sz_suffix_array_lcp(sz_u8_t const *text, sz_u8_t const *ends, sz_size_t length,
+                                           sz_size_t const *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc) {
+
+    sz_size_t const ranks_bytes = length * sizeof(sz_size_t);
+    sz_size_t *ranks = (sz_size_t *)alloc->allocate(ranks_bytes, alloc->handle);
+    if (!ranks) return sz_false_k;
+    for (sz_size_t i = 0; i != length; ++i) ranks[suffixes[i]] = i;
+
+    for (sz_size_t i = 0, common = 0; i != length; ++i) {
+        sz_size_t rank = ranks[i];
+        if (rank == 0) {
+            lcp[0] = common = 0;
+            continue;
+        }
+        // The inherited prefix can't cross a string end, but may stop right at it.
+        sz_size_t previous = suffixes[rank - 1];
+        sz_bool_t ended = sz_false_k;
+        if (ends && common) {
+            sz_size_t a = i + common - 1, b = previous + common - 1;
+            ended = (sz_bool_t)((((ends[a >> 3] >> (a & 7)) | (ends[b >> 3] >> (b & 7))) & 1) != 0);
+        }
+        while (!ended && i + common < length && previous + common < length &&
+               text[i + common] == text[previous + common]) {
+            sz_size_t a = i + common, b = previous + common;
+            ++common;
+            ended = (sz_bool_t)(ends && (((ends[a >> 3] >> (a & 7)) | (ends[b >> 3] >> (b & 7))) & 1));
+        }
+        lcp[rank] = common;
+        if (common) --common;
+    }
+
+    alloc->free(ranks, ranks_bytes, alloc->handle);
+    return sz_true_k;
+}
+
+SZ_PUBLIC sz_bool_t sz_suffix_array(sz_cptr_t text, sz_size_t length, sz_size_t *suffixes, sz_size_t *lcp,
+                                    sz_memory_allocator_t *alloc) {
+
+    // Simplify usage in higher-level libraries, where wrapping custom allocators may be troublesome.
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+
+    _sz_sais_text_t bytes;
+    bytes.bytes = (sz_u8_t const *)text, bytes.ends = SZ_NULL, bytes.names = SZ_NULL;
+    if (!_sz_sais(&bytes, length, 256, suffixes, SZ_NULL, 0, alloc)) return sz_false_k;
+    return lcp ? _sz_suffix_array_lcp(bytes.bytes, SZ_NULL, length, suffixes, lcp, alloc) : sz_true_k;
+}
+
+/**
+ *  @brief  Shared part of `sz_suffix_array_u32tape` and `sz_suffix_array_u64tape`, taking the bitset,
+ *          marking the last bytes of every string in the tape.
+ */
+SZ_INTERNAL sz_bool_t _sz_suffix_array_tape(sz_cptr_t start, sz_size_t first, sz_size_t length, sz_u8_t const *ends,
+                                            sz_size_t *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc) {
+    _sz_sais_text_t tape;
+    tape.bytes = (sz_u8_t const *)start + first, tape.ends = ends, tape.names = SZ_NULL;
+    if (!_sz_sais(&tape, length, 512, suffixes, SZ_NULL, 0, alloc)) return sz_false_k;
+    if (lcp && !_sz_suffix_array_lcp(tape.bytes, ends, length, suffixes, lcp, alloc)) return sz_false_k;
+    if (first)
+        for (sz_size_t i = 0; i != length; ++i) suffixes[i] += first;
+    return sz_true_k;
+}
+
+SZ_PUBLIC sz_bool_t sz_suffix_array_u32tape(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count,
+                                            sz_size_t *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc) {
+
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+
+    sz_size_t const first = offsets[0], length = offsets[count] - offsets[0];
+    sz_size_t const ends_bytes = length / 8 + 1;
+    sz_u8_t *ends = (sz_u8_t *)alloc->allocate(ends_bytes, alloc->handle);
+    if (!ends) return sz_false_k;
+    for (sz_size_t i = 0; i != ends_bytes; ++i) ends[i] = 0;
+    for (sz_size_t i = 0; i != count; ++i) {
+        if (offsets[i + 1] == offsets[i]) continue;
+        sz_size_t last = offsets[i + 1] - 1 - first;
+        ends[last >> 3] |= 1 << (last & 7);
+    }
+
+    sz_bool_t result = _sz_suffix_array_tape(start, first, length, ends, suffixes, lcp, alloc);
+    alloc->free(ends, ends_bytes, alloc->handle);
+    return result;
+}
+
+SZ_PUBLIC sz_bool_t sz_suffix_array_u64tape(sz_cptr_t start, sz_u64_t const *offsets, sz_size_t count,
+                                            sz_size_t *suffixes, sz_size_t *lcp, sz_memory_allocator_t *alloc) {
+
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+
+    sz_size_t const first = (sz_size_t)offsets[0], length = (sz_size_t)(offsets[count] - offsets[0]);
+    sz_size_t const ends_bytes = length / 8 + 1;
+    sz_u8_t *ends = (sz_u8_t *)alloc->allocate(ends_bytes, alloc->handle);
+    if (!ends) return sz_false_k;
+    for (sz_size_t i = 0; i != ends_bytes; ++i) ends[i] = 0;
+    for (sz_size_t i = 0; i != count; ++i) {
+        if (offsets[i + 1] == offsets[i]) continue;
+        sz_size_t last = (sz_size_t)(offsets[i + 1] - 1) - first;
+        ends[last >> 3] |= 1 << (last & 7);
+    }
+
+    sz_bool_t result = _sz_suffix_array_tape(start, first, length, ends, suffixes, lcp, alloc);
+    alloc->free(ends, ends_bytes, alloc->handle);
+    return result;
+}
+
+/*
+ *  The FM-index keeps cumulative counts of every byte value in the BWT: 64-bit ones for every superblock
+ *  of 64K rows, 16-bit ones for every block of 1K rows, and scans the remaining bytes of the block with SWAR.
+ */
+#define _sz_fm_superblock_bits 16
+#define _sz_fm_block_bits 10
+#define _sz_fm_marks_group_bits 9
+#define _sz_fm_magic 0x31584449464D5A53ull // "SZFMIDX1" in little-endian
+
+/**
+ *  @brief  Computes the offsets of the blob sections, in the order of `sz_fm_index_t` members,
+ *          and returns the total size of the blob. The first section is the header of 8 words.
+ */
+SZ_INTERNAL sz_size_t _sz_fm_index_layout(sz_size_t length, sz_size_t sample_rate, sz_size_t *offsets) {
+    sz_size_t const rows = length + 1;
+    sz_size_t sizes[8];
+    sizes[0] = 8 * sizeof(sz_u64_t);
+    sizes[1] = 257 * sizeof(sz_u64_t);
+    sizes[2] = ((rows >> _sz_fm_superblock_bits) + 1) * 256 * sizeof(sz_u64_t);
+    sizes[3] = (((rows >> _sz_fm_block_bits) + 1) * 256 * sizeof(sz_u16_t) + 7) / 8 * 8;
+    sizes[4] = ((rows >> 6) + 1) * sizeof(sz_u64_t);
+    sizes[5] = ((rows >> _sz_fm_marks_group_bits) + 1) * sizeof(sz_u64_t);
+    sizes[6] = (length + sample_rate - 1) / sample_rate * sizeof(sz_u64_t);
+    sizes[7] = rows;
+    sz_size_t total = 0;
+    for (sz_size_t i = 0; i != 8; ++i) offsets[i] = total, total += sizes[i];
+    return total;
+}
+
+SZ_INTERNAL void _sz_fm_index_bind(sz_fm_index_t *index, sz_cptr_t blob, sz_size_t const *offsets) {
+    sz_u64_t const *header = (sz_u64_t const *)blob;
+    index->blob = blob;
+    index->blob_length = (sz_size_t)header[4];
+    index->length = (sz_size_t)header[1];
+    index->primary = (sz_size_t)header[2];
+    index->sample_rate = (sz_size_t)header[3];
+    index->counts = (sz_u64_t const *)(blob + offsets[1]);
+    index->superblocks = (sz_u64_t const *)(blob + offsets[2]);
+    index->blocks = (sz_u16_t const *)(blob + offsets[3]);
+    index->marks = (sz_u64_t const *)(blob + offsets[4]);
+    index->marks_ranks = (sz_u64_t const *)(blob + offsets[5]);
+    index->samples = (sz_u64_t const *)(blob + offsets[6]);
+    index->bwt = (sz_u8_t const *)(blob + offsets[7]);
+}
+
+/**
+ *  @brief  Counts the occurrences of byte @p c in the first @p row rows of the BWT, excluding the sentinel.
+ */
+SZ_INTERNAL sz_size_t _sz_fm_index_occurrences(sz_fm_index_t const *index, sz_u8_t c, sz_size_t row) {
+    sz_size_t count = (sz_size_t)index->superblocks[(row >> _sz_fm_superblock_bits) * 256 + c] +
+                      index->blocks[(row >> _sz_fm_block_bits) * 256 + c];
+    sz_cptr_t text = (sz_cptr_t)index->bwt + ((row >> _sz_fm_block_bits) << _sz_fm_block_bits);
+    sz_cptr_t const end = (sz_cptr_t)index->bwt + row;
+    sz_u64_vec_t text_vec, match_vec;
+    match_vec.u64 = (sz_u64_t)c * 0x0101010101010101ull;
+    for (; text + 8 <= end; text += 8) {
+        text_vec = sz_u64_load(text);
+        count += sz_u64_popcount(_sz_u64_each_byte_equal(text_vec, match_vec).u64);
+    }
+    for (; text != end; ++text) count += *(sz_u8_t const *)text == c;
+    // The sentinel is stored as a zero byte in the `primary` row.
+    return count - (c == 0 && index->primary < row);
+}
+
+SZ_PUBLIC sz_bool_t sz_fm_index_init(sz_fm_index_t *index, sz_cptr_t text, sz_size_t length, sz_size_t sample_rate,
+                                     sz_memory_allocator_t *alloc) {
+
+    // Simplify usage in higher-level libraries, where wrapping custom allocators may be troublesome.
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    if (!sample_rate) sample_rate = 32;
+
+    sz_size_t const suffixes_bytes = length * sizeof(sz_size_t);
+    sz_size_t *suffixes = (sz_size_t *)alloc->allocate(suffixes_bytes ? suffixes_bytes : 1, alloc->handle);
+    if (!suffixes) return sz_false_k;
+    if (!sz_suffix_array(text, length, suffixes, SZ_NULL, alloc)) {
+        alloc->free(suffixes, suffixes_bytes ? suffixes_bytes : 1, alloc->handle);
+        return sz_false_k;
+    }
 
-        sz_sequence_t b = *sequence;
-        b.order += split;
-        b.count -= split;
-        sz_sort_introsort(&b, comparator);
+    sz_size_t offsets[8];
+    sz_size_t const blob_length = _sz_fm_index_layout(length, sample_rate, offsets);
+    sz_ptr_t blob = (sz_ptr_t)alloc->allocate(blob_length, alloc->handle);
+    if (!blob) {
+        alloc->free(suffixes, suffixes_bytes ? suffixes_bytes : 1, alloc->handle);
+        return sz_false_k;
+    }
+    sz_fill_serial(blob, offsets[7], 0);
+
+    // Export the BWT, where the first row is the empty suffix after the sentinel, and mark the sampled rows.
+    sz_size_t const rows = length + 1;
+    sz_u8_t *bwt = (sz_u8_t *)(blob + offsets[7]);
+    sz_u64_t *marks = (sz_u64_t *)(blob + offsets[4]);
+    sz_u64_t *samples = (sz_u64_t *)(blob + offsets[6]);
+    sz_size_t primary = 0;
+    bwt[0] = length ? (sz_u8_t)text[length - 1] : 0;
+    for (sz_size_t row = 1, samples_count = 0; row != rows; ++row) {
+        sz_size_t position = suffixes[row - 1];
+        if (position) bwt[row] = (sz_u8_t)text[position - 1];
+        else bwt[row] = 0, primary = row;
+        if (position % sample_rate) continue;
+        marks[row >> 6] |= (sz_u64_t)1 << (row & 63);
+        samples[samples_count++] = position;
     }
+    alloc->free(suffixes, suffixes_bytes ? suffixes_bytes : 1, alloc->handle);
+
+    // Accumulate the occurrence counters, and the ranks of marked rows.
+    sz_u64_t *superblocks = (sz_u64_t *)(blob + offsets[2]);
+    sz_u16_t *blocks = (sz_u16_t *)(blob + offsets[3]);
+    sz_u64_t *marks_ranks = (sz_u64_t *)(blob + offsets[5]);
+    sz_u64_t running[256], superblock_start[256];
+    for (sz_size_t c = 0; c != 256; ++c) running[c] = superblock_start[c] = 0;
+    for (sz_size_t row = 0; row <= rows; ++row) {
+        if ((row & ((1 << _sz_fm_superblock_bits) - 1)) == 0)
+            for (sz_size_t c = 0; c != 256; ++c)
+                superblocks[(row >> _sz_fm_superblock_bits) * 256 + c] = superblock_start[c] = running[c];
+        if ((row & ((1 << _sz_fm_block_bits) - 1)) == 0)
+            for (sz_size_t c = 0; c != 256; ++c)
+                blocks[(row >> _sz_fm_block_bits) * 256 + c] = (sz_u16_t)(running[c] - superblock_start[c]);
+        if (row != rows) ++running[bwt[row]];
+    }
+    for (sz_size_t group = 0, rank = 0; group <= (rows >> _sz_fm_marks_group_bits); ++group) {
+        marks_ranks[group] = rank;
+        for (sz_size_t word = group << 3; word != (group + 1) << 3 && word <= (rows >> 6); ++word)
+            rank += sz_u64_popcount(marks[word]);
+    }
+
+    // The first row of every character follows the sentinel row and all the smaller characters.
+    sz_u64_t *counts = (sz_u64_t *)(blob + offsets[1]);
+    running[0] -= 1;
+    counts[0] = 1;
+    for (sz_size_t c = 0; c != 256; ++c) counts[c + 1] = counts[c] + running[c];
+
+    sz_u64_t *header = (sz_u64_t *)blob;
+    header[0] = _sz_fm_magic;
+    header[1] = length, header[2] = primary, header[3] = sample_rate, header[4] = blob_length;
+    _sz_fm_index_bind(index, blob, offsets);
+    return sz_true_k;
 }
 
-SZ_INTERNAL sz_bool_t _sz_sort_is_less(sz_sequence_t *sequence, sz_size_t i_key, sz_size_t j_key) {
-    sz_cptr_t i_str = sequence->get_start(sequence, i_key);
-    sz_cptr_t j_str = sequence->get_start(sequence, j_key);
-    sz_size_t i_len = sequence->get_length(sequence, i_key);
-    sz_size_t j_len = sequence->get_length(sequence, j_key);
-    return (sz_bool_t)(sz_order_serial(i_str, i_len, j_str, j_len) == sz_less_k);
+/**
+ *  @brief  Checks the parts of a viewed index, that the searches use as array indices: the first rows of every
+ *          character, and the ranks of the sampled rows. Takes one pass over the samples and the marks bitset,
+ *          but doesn't rescan the BWT, as the searches clamp the rows derived from the occurrence counters.
+ */
+SZ_INTERNAL sz_bool_t _sz_fm_index_is_valid(sz_fm_index_t const *index) {
+    sz_size_t const rows = index->length + 1;
+    if (index->primary >= rows) return sz_false_k;
+
+    // The first rows of the characters must be non-decreasing, ending at the number of rows.
+    if (index->counts[0] != 1 || index->counts[256] != rows) return sz_false_k;
+    for (sz_size_t c = 0; c != 256; ++c)
+        if (index->counts[c + 1] < index->counts[c]) return sz_false_k;
+
+    // The ranks of marked rows must match the bitset, which must mark exactly as many rows as there are samples.
+    sz_size_t const samples_count = (index->length + index->sample_rate - 1) / index->sample_rate;
+    sz_size_t const last_word = rows >> 6;
+    sz_size_t rank = 0;
+    for (sz_size_t word = 0; word <= last_word; ++word) {
+        if ((word & 7) == 0 && index->marks_ranks[word >> 3] != rank) return sz_false_k;
+        sz_u64_t marks = index->marks[word];
+        if (word == last_word) marks &= ((sz_u64_t)1 << (rows & 63)) - 1;
+        rank += sz_u64_popcount(marks);
+    }
+    if (rank != samples_count) return sz_false_k;
+    for (sz_size_t i = 0; i != samples_count; ++i)
+        if (index->samples[i] >= index->length) return sz_false_k;
+    return sz_true_k;
 }
 
-SZ_PUBLIC void sz_sort_partial(sz_sequence_t *sequence, sz_size_t partial_order_length) {
+SZ_PUBLIC sz_bool_t sz_fm_index_view(sz_fm_index_t *index, sz_cptr_t blob, sz_size_t blob_length) {
+    if (blob_length < 8 * sizeof(sz_u64_t) || ((sz_size_t)blob & 7)) return sz_false_k;
+    sz_u64_t const *header = (sz_u64_t const *)blob;
+    if (header[0] != _sz_fm_magic || header[3] == 0 || header[4] != blob_length) return sz_false_k;
+    // Every byte of the text takes a byte of the BWT, so the length must fit in the blob, to avoid overflows.
+    if (header[1] >= blob_length) return sz_false_k;
+    sz_size_t offsets[8];
+    if (_sz_fm_index_layout((sz_size_t)header[1], (sz_size_t)header[3], offsets) != blob_length) return sz_false_k;
+    sz_fm_index_t viewed;
+    _sz_fm_index_bind(&viewed, blob, offsets);
+    if (!_sz_fm_index_is_valid(&viewed)) return sz_false_k;
+    *index = viewed;
+    return sz_true_k;
+}
 
-#if SZ_DETECT_BIG_ENDIAN
-    // TODO: Implement partial sort for big-endian systems. For now this sorts the whole thing.
-    sz_unused(partial_order_length);
-    sz_sort_introsort(sequence, (sz_sequence_comparator_t)_sz_sort_is_less);
-#else
+SZ_PUBLIC void sz_fm_index_free(sz_fm_index_t *index, sz_memory_allocator_t *alloc) {
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    if (index->blob) alloc->free((sz_ptr_t)index->blob, index->blob_length, alloc->handle);
+    index->blob = SZ_NULL, index->blob_length = 0;
+}
 
-    // Export up to 4 bytes into the `sequence` bits themselves
-    for (sz_size_t i = 0; i != sequence->count; ++i) {
-        sz_cptr_t begin = sequence->get_start(sequence, sequence->order[i]);
-        sz_size_t length = sequence->get_length(sequence, sequence->order[i]);
-        length = length > 4u ? 4u : length;
-        sz_ptr_t prefix = (sz_ptr_t)&sequence->order[i];
-        for (sz_size_t j = 0; j != length; ++j) prefix[7 - j] = begin[j];
+/**
+ *  @brief  Backward search, narrowing the range of sorted rotations starting with the pattern suffix.
+ *  @return Number of matching rows, starting at @p first_row.
+ */
+SZ_INTERNAL sz_size_t _sz_fm_index_range(sz_fm_index_t const *index, sz_cptr_t pattern, sz_size_t length,
+                                         sz_size_t *first_row) {
+    sz_size_t const rows = index->length + 1;
+    sz_size_t low = 0, high = rows;
+    while (length && low < high) {
+        sz_u8_t c = (sz_u8_t)pattern[--length];
+        // Valid counters never exceed the number of rows, but the mapped ones may be corrupted.
+        low = sz_min_of_two((sz_size_t)index->counts[c] + _sz_fm_index_occurrences(index, c, low), rows);
+        high = sz_min_of_two((sz_size_t)index->counts[c] + _sz_fm_index_occurrences(index, c, high), rows);
     }
+    *first_row = low;
+    return low < high ? high - low : 0;
+}
+
+SZ_PUBLIC sz_size_t sz_fm_index_count(sz_fm_index_t const *index, sz_cptr_t pattern, sz_size_t length) {
+    sz_size_t first_row;
+    return _sz_fm_index_range(index, pattern, length, &first_row);
+}
+
+SZ_PUBLIC sz_size_t sz_fm_index_locate(sz_fm_index_t const *index, sz_cptr_t pattern, sz_size_t length,
+                                       sz_size_t *positions, sz_size_t capacity) {
+    sz_size_t first_row;
+    sz_size_t count = _sz_fm_index_range(index, pattern, length, &first_row);
+    count = sz_min_of_two(count, capacity);
+
+    // Walk backwards through the text with LF-mapping, until reaching a row with a sampled offset.
+    // The first text offset is always sampled, so the walk never reaches the sentinel,
+    // and takes fewer than `sample_rate` steps, unless the mapped counters are corrupted.
+    sz_size_t const last_row = index->length;
+    sz_size_t const last_sample = (index->length + index->sample_rate - 1) / index->sample_rate - 1;
+    for (sz_size_t i = 0; i != count; ++i) {
+        sz_size_t row = first_row + i, steps = 0;
+        while (!((index->marks[row >> 6] >> (row & 63)) & 1) && steps != index->sample_rate) {
+            sz_u8_t c = index->bwt[row];
+            row = sz_min_of_two((sz_size_t)index->counts[c] + _sz_fm_index_occurrences(index, c, row), last_row);
+            ++steps;
+        }
+        sz_size_t rank = (sz_size_t)index->marks_ranks[row >> _sz_fm_marks_group_bits];
+        for (sz_size_t word = (row >> _sz_fm_marks_group_bits) << 3; word != (row >> 6); ++word)
+            rank += sz_u64_popcount(index->marks[word]);
+        rank += sz_u64_popcount(index->marks[row >> 6] & (((sz_u64_t)1 << (row & 63)) - 1));
+        positions[i] = (sz_size_t)index->samples[sz_min_of_two(rank, last_sample)] + steps;
+    }
+    return count;
+}
 
-    // Perform optionally-parallel radix sort on them
-    sz_sort_recursion(sequence, 0, 32, (sz_sequence_comparator_t)_sz_sort_is_less, partial_order_length);
-#endif
+#undef _sz_fm_superblock_bits
+#undef _sz_fm_block_bits
+#undef _sz_fm_marks_group_bits
+#undef _sz_fm_magic
+
+#define _sz_tape_magic 0x3156455041545A53ull // "SZTAPEV1" in little-endian
+
+SZ_PUBLIC sz_size_t sz_tape_header(sz_u64_t *header, sz_size_t count, sz_size_t data_length, sz_size_t offset_size) {
+    if (offset_size != 4 && offset_size != 8) return 0;
+    if (offset_size == 4 && data_length > 0xFFFFFFFFull) return 0;
+    sz_size_t const data_offset = 8 * sizeof(sz_u64_t) + ((count + 1) * offset_size + 7) / 8 * 8;
+    sz_size_t const blob_length = data_offset + data_length;
+    header[0] = _sz_tape_magic;
+    header[1] = count, header[2] = offset_size, header[3] = data_offset, header[4] = blob_length;
+    header[5] = header[6] = header[7] = 0;
+    return blob_length;
+}
+
+SZ_PUBLIC sz_bool_t sz_tape_view(sz_tape_t *tape, sz_cptr_t blob, sz_size_t blob_length) {
+    if (blob_length < 8 * sizeof(sz_u64_t) || ((sz_size_t)blob & 7)) return sz_false_k;
+    sz_u64_t const *header = (sz_u64_t const *)blob;
+    if (header[0] != _sz_tape_magic || header[4] != blob_length) return sz_false_k;
+    if (header[2] != 4 && header[2] != 8) return sz_false_k;
+    sz_size_t const count = (sz_size_t)header[1], offset_size = (sz_size_t)header[2];
+    // Check the sizes before multiplying them, to avoid overflows on malformed headers
+    if (count >= blob_length / offset_size) return sz_false_k;
+    sz_size_t const data_offset = 8 * sizeof(sz_u64_t) + ((count + 1) * offset_size + 7) / 8 * 8;
+    if (header[3] != data_offset || data_offset > blob_length) return sz_false_k;
+
+    sz_cptr_t const offsets = blob + 8 * sizeof(sz_u64_t);
+    sz_u64_t first, last;
+    if (offset_size == 4) first = ((sz_u32_t const *)offsets)[0], last = ((sz_u32_t const *)offsets)[count];
+    else first = ((sz_u64_t const *)offsets)[0], last = ((sz_u64_t const *)offsets)[count];
+    if (first != 0 || last != blob_length - data_offset) return sz_false_k;
+
+    tape->blob = blob;
+    tape->blob_length = blob_length;
+    tape->count = count;
+    tape->offset_size = offset_size;
+    tape->offsets = offsets;
+    tape->data = blob + data_offset;
+    return sz_true_k;
 }
 
-SZ_PUBLIC void sz_sort(sz_sequence_t *sequence) {
-#if SZ_DETECT_BIG_ENDIAN
-    sz_sort_introsort(sequence, (sz_sequence_comparator_t)_sz_sort_is_less);
-#else
-    sz_sort_partial(sequence, sequence->count);
-#endif
+SZ_PUBLIC sz_bool_t sz_tape_write(sz_sequence_t const *sequence, sz_tape_write_t write, void *user) {
+    sz_size_t const count = sequence->count;
+    sz_size_t data_length = 0;
+    for (sz_size_t i = 0; i != count; ++i) data_length += sequence->get_length(sequence, i);
+    sz_size_t const offset_size = data_length <= 0xFFFFFFFFull ? 4 : 8;
+    sz_u64_t header[8];
+    sz_tape_header(header, count, data_length, offset_size);
+    if (!write((sz_cptr_t)header, sizeof(header), user)) return sz_false_k;
+
+    // Export the offsets in batches, starting with zero, followed by the padding to 8 bytes
+    sz_u64_t batch[256];
+    sz_u32_t *batch_32bit = (sz_u32_t *)batch;
+    sz_size_t const batch_capacity = sizeof(batch) / offset_size;
+    sz_size_t running_offset = 0, batch_length = 0;
+    for (sz_size_t i = 0; i <= count; ++i) {
+        if (offset_size == 4) batch_32bit[batch_length++] = (sz_u32_t)running_offset;
+        else batch[batch_length++] = running_offset;
+        if (i != count) running_offset += sequence->get_length(sequence, i);
+        if (batch_length != batch_capacity && i != count) continue;
+        if (!write((sz_cptr_t)batch, batch_length * offset_size, user)) return sz_false_k;
+        batch_length = 0;
+    }
+    sz_size_t const padding = (sz_size_t)header[3] - sizeof(header) - (count + 1) * offset_size;
+    batch[0] = 0;
+    if (padding && !write((sz_cptr_t)batch, padding, user)) return sz_false_k;
+
+    // Merge the strings following each other in memory, like the slices of a single buffer, into one call
+    sz_cptr_t pending_start = NULL;
+    sz_size_t pending_length = 0;
+    for (sz_size_t i = 0; i != count; ++i) {
+        sz_cptr_t start = sequence->get_start(sequence, i);
+        sz_size_t length = sequence->get_length(sequence, i);
+        if (!length) continue;
+        if (pending_start && pending_start + pending_length == start) {
+            pending_length += length;
+            continue;
+        }
+        if (pending_length && !write(pending_start, pending_length, user)) return sz_false_k;
+        pending_start = start, pending_length = length;
+    }
+    if (pending_length && !write(pending_start, pending_length, user)) return sz_false_k;
+    return sz_true_k;
+}
+
+SZ_PUBLIC sz_bool_t sz_tape_validate(sz_tape_t const *tape) {
+    // The first and the last offsets are checked by `sz_tape_view`, so monotonicity bounds all of the others
+    if (tape->offset_size == 4) {
+        sz_u32_t const *offsets = (sz_u32_t const *)tape->offsets;
+        for (sz_size_t i = 0; i != tape->count; ++i)
+            if (offsets[i] > offsets[i + 1]) return sz_false_k;
+    }
+    else {
+        sz_u64_t const *offsets = (sz_u64_t const *)tape->offsets;
+        for (sz_size_t i = 0; i != tape->count; ++i)
+            if (offsets[i] > offsets[i + 1]) return sz_false_k;
+    }
+    return sz_true_k;
 }
 
+#undef _sz_tape_magic
+
 #pragma endregion
 
 /*
@@ -3703,125 +6015,279 @@ SZ_INTERNAL __m256i _mm256_mul_epu64(__m256i a, __m256i b) {
     return prod;
 }
 
-SZ_PUBLIC void sz_hashes_avx2(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
-                              sz_hash_callback_t callback, void *callback_handle) {
+SZ_PUBLIC void sz_hash_tape_avx2(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
 
-    if (length < window_length || !window_length) return;
-    if (length < 4 * window_length) {
-        sz_hashes_serial(start, length, window_length, step, callback, callback_handle);
-        return;
+    // AVX2 only has signed 64-bit comparisons, so to check if `x >= prime` we flip the sign bit
+    // of both arguments and compare `x ^ sign > (prime - 1) ^ sign`.
+    sz_u256_vec_t prime_vec, sign_vec, prime_minus_one_flipped_vec, golden_ratio_vec, shift_high_vec, byte_mask_vec;
+    prime_vec.ymm = _mm256_set1_epi64x(SZ_U64_MAX_PRIME);
+    sign_vec.ymm = _mm256_set1_epi64x(0x8000000000000000ull);
+    prime_minus_one_flipped_vec.ymm = _mm256_set1_epi64x((SZ_U64_MAX_PRIME - 1ull) ^ 0x8000000000000000ull);
+    golden_ratio_vec.ymm = _mm256_set1_epi64x(11400714819323198485ull);
+    shift_high_vec.ymm = _mm256_set1_epi64x(77ull);
+    byte_mask_vec.ymm = _mm256_set1_epi64x(0xFFull);
+
+    // Every one of the 4 lanes is hashing a different string, interleaving their dependency chains.
+    sz_u256_vec_t begins_vec, lengths_vec, words_vec, active_vec, overflow_vec;
+    sz_u256_vec_t chars_low_vec, chars_high_vec, hash_low_vec, hash_high_vec, new_low_vec, new_high_vec;
+    for (; count >= 4; offsets += 4, hashes += 4, count -= 4) {
+        begins_vec.ymm = _mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i const *)offsets));
+        lengths_vec.ymm = _mm256_sub_epi64(_mm256_cvtepu32_epi64(_mm_loadu_si128((__m128i const *)(offsets + 1))),
+                                           begins_vec.ymm);
+        sz_size_t const max_length = sz_max_of_two(sz_max_of_two(lengths_vec.u64s[0], lengths_vec.u64s[1]),
+                                                   sz_max_of_two(lengths_vec.u64s[2], lengths_vec.u64s[3]));
+        hash_low_vec.ymm = _mm256_setzero_si256();
+        hash_high_vec.ymm = _mm256_setzero_si256();
+
+        for (sz_size_t progress = 0; progress < max_length; progress += 8) {
+            // Strings with at least 8 more bytes are gathered at once, the shorter tails are assembled
+            // byte-by-byte to avoid reading past the end of the tape. Lengths are 32-bit, so signed comparisons work.
+            __m256i full_mask = _mm256_cmpgt_epi64(lengths_vec.ymm, _mm256_set1_epi64x(progress + 7));
+            words_vec.ymm = _mm256_mask_i64gather_epi64(
+                _mm256_setzero_si256(), (long long const *)start,
+                _mm256_add_epi64(begins_vec.ymm, _mm256_set1_epi64x(progress)), full_mask, 1);
+            for (int lane = 0; lane != 4; ++lane) {
+                if (lengths_vec.u64s[lane] <= progress || lengths_vec.u64s[lane] >= progress + 8) continue;
+                sz_u8_t const *tail = (sz_u8_t const *)start + begins_vec.u64s[lane] + progress;
+                sz_u64_t word = 0;
+                for (sz_size_t i = lengths_vec.u64s[lane] - progress; i; --i) word = (word << 8) | tail[i - 1];
+                words_vec.u64s[lane] = word;
+            }
+
+            // Consume the 8 bytes one at a time, only updating the lanes that haven't reached their end.
+            for (sz_size_t byte = 0; byte != 8; ++byte) {
+                active_vec.ymm = _mm256_cmpgt_epi64(lengths_vec.ymm, _mm256_set1_epi64x(progress + byte));
+                chars_low_vec.ymm = _mm256_and_si256(words_vec.ymm, byte_mask_vec.ymm);
+                chars_high_vec.ymm =
+                    _mm256_and_si256(_mm256_add_epi64(chars_low_vec.ymm, shift_high_vec.ymm), byte_mask_vec.ymm);
+                words_vec.ymm = _mm256_srli_epi64(words_vec.ymm, 8);
+
+                // Multiplying by 31 and 257 is cheaper with shifts: `x * 31 = (x << 5) - x`, `x * 257 = (x << 8) + x`.
+                new_low_vec.ymm = _mm256_sub_epi64(_mm256_slli_epi64(hash_low_vec.ymm, 5), hash_low_vec.ymm);
+                new_low_vec.ymm = _mm256_add_epi64(new_low_vec.ymm, chars_low_vec.ymm);
+                new_high_vec.ymm = _mm256_add_epi64(_mm256_slli_epi64(hash_high_vec.ymm, 8), hash_high_vec.ymm);
+                new_high_vec.ymm = _mm256_add_epi64(new_high_vec.ymm, chars_high_vec.ymm);
+
+                // Compute the modulo by conditionally subtracting the prime, just like `sz_hash_serial`.
+                overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(new_low_vec.ymm, sign_vec.ymm),
+                                                      prime_minus_one_flipped_vec.ymm);
+                new_low_vec.ymm = _mm256_sub_epi64(new_low_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
+                overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(new_high_vec.ymm, sign_vec.ymm),
+                                                      prime_minus_one_flipped_vec.ymm);
+                new_high_vec.ymm =
+                    _mm256_sub_epi64(new_high_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
+
+                hash_low_vec.ymm = _mm256_blendv_epi8(hash_low_vec.ymm, new_low_vec.ymm, active_vec.ymm);
+                hash_high_vec.ymm = _mm256_blendv_epi8(hash_high_vec.ymm, new_high_vec.ymm, active_vec.ymm);
+            }
+        }
+
+        // Mix the two hashes, similar to `_sz_hash_mix`.
+        hash_low_vec.ymm = _mm256_mul_epu64(hash_low_vec.ymm, golden_ratio_vec.ymm);
+        hash_high_vec.ymm = _mm256_mul_epu64(hash_high_vec.ymm, golden_ratio_vec.ymm);
+        _mm256_storeu_si256((__m256i *)hashes, _mm256_xor_si256(hash_low_vec.ymm, hash_high_vec.ymm));
     }
 
-    // Using AVX2, we can perform 4 long integer multiplications and additions within one register.
-    // So let's slice the entire string into 4 overlapping windows, to slide over them in parallel.
-    sz_size_t const max_hashes = length - window_length + 1;
-    sz_size_t const min_hashes_per_thread = max_hashes / 4; // At most one sequence can overlap between 2 threads.
-    sz_u8_t const *text_first = (sz_u8_t const *)start;
-    sz_u8_t const *text_second = text_first + min_hashes_per_thread;
-    sz_u8_t const *text_third = text_first + min_hashes_per_thread * 2;
-    sz_u8_t const *text_fourth = text_first + min_hashes_per_thread * 3;
-    sz_u8_t const *text_end = text_first + length;
+    sz_hash_tape_serial(start, offsets, count, hashes);
+}
 
-    // Prepare the `prime ^ window_length` values, that we are going to use for modulo arithmetic.
-    sz_u64_t prime_power_low = 1, prime_power_high = 1;
-    for (sz_size_t i = 0; i + 1 < window_length; ++i)
-        prime_power_low = (prime_power_low * 31ull) % SZ_U64_MAX_PRIME,
-        prime_power_high = (prime_power_high * 257ull) % SZ_U64_MAX_PRIME;
-
-    // Broadcast the constants into the registers.
-    sz_u256_vec_t prime_vec, golden_ratio_vec;
-    sz_u256_vec_t base_low_vec, base_high_vec, prime_power_low_vec, prime_power_high_vec, shift_high_vec;
-    base_low_vec.ymm = _mm256_set1_epi64x(31ull);
-    base_high_vec.ymm = _mm256_set1_epi64x(257ull);
-    shift_high_vec.ymm = _mm256_set1_epi64x(77ull);
-    prime_vec.ymm = _mm256_set1_epi64x(SZ_U64_MAX_PRIME);
+/** @copydoc _sz_mersenne_reduce */
+SZ_INTERNAL __m256i _sz_mersenne_reduce_avx2(__m256i x, __m256i prime) {
+    x = _mm256_add_epi64(_mm256_and_si256(x, prime), _mm256_srli_epi64(x, 61));
+    // After the first step the value is below `2^62`, so the signed comparison is safe.
+    return _mm256_sub_epi64(x, _mm256_and_si256(_mm256_cmpgt_epi64(x, _mm256_sub_epi64(prime, _mm256_set1_epi64x(1))),
+                                                prime));
+}
+
+/** @copydoc _sz_mersenne_mul_byte */
+SZ_INTERNAL __m256i _sz_mersenne_mul_byte_avx2(__m256i bytes, __m256i x_low, __m256i x_high, __m256i prime) {
+    __m256i high = _mm256_mul_epu32(bytes, x_high);
+    high = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi64(high, 32), prime), _mm256_srli_epi64(high, 29));
+    return _sz_mersenne_reduce_avx2(_mm256_add_epi64(_mm256_mul_epu32(bytes, x_low), high), prime);
+}
+
+/** @copydoc _sz_mersenne_mul_31 */
+SZ_INTERNAL __m256i _sz_mersenne_mul_31_add_avx2(__m256i x, __m256i chars, __m256i prime) {
+    __m256i rotated = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi64(x, 5), prime), _mm256_srli_epi64(x, 56));
+    return _sz_mersenne_reduce_avx2(
+        _mm256_add_epi64(rotated, _mm256_sub_epi64(_mm256_add_epi64(prime, chars), x)), prime);
+}
+
+/** @copydoc _sz_mersenne_mul_257 */
+SZ_INTERNAL __m256i _sz_mersenne_mul_257_add_avx2(__m256i x, __m256i chars, __m256i prime) {
+    __m256i rotated = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi64(x, 8), prime), _mm256_srli_epi64(x, 53));
+    return _sz_mersenne_reduce_avx2(_mm256_add_epi64(rotated, _mm256_add_epi64(x, chars)), prime);
+}
+
+/**
+ *  @brief  Shared AVX2 implementation of the rolling hashes for all families, slicing the text into 4 parts,
+ *          one per 64-bit lane, each reporting the same number of consecutive windows, so that the hashes can
+ *          be exported in order. The remaining windows are processed serially.
+ *  @see    _sz_hashes_serial
+ */
+SZ_INTERNAL sz_size_t _sz_hashes_avx2(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                      sz_hash_family_t family, sz_hash_callback_t callback, void *callback_handle,
+                                      sz_u64_t *hashes, sz_size_t *positions, sz_size_t capacity) {
+
+    if (length < window_length || !window_length || !capacity) return 0;
+    sz_size_t const step_mask = step - 1;
+    sz_size_t const reported = sz_min_of_two((length - window_length) / step + 1, capacity);
+    sz_size_t const reported_per_lane = reported / 4;
+    if (reported_per_lane < 2)
+        return _sz_hashes_serial(start, length, window_length, step, family, callback, callback_handle, hashes,
+                                 positions, capacity);
+    sz_size_t const lane_length = reported_per_lane * step;
+    sz_size_t const last_cycle = (reported_per_lane - 1) * step;
+    sz_bool_t const is_mersenne = (sz_bool_t)(family == sz_hash_family_mersenne_k);
+
+    // Prepare the `base ^ (window_length - 1)` values, to discard the oldest characters.
+    sz_u64_t prime_power_low, prime_power_high;
+    _sz_hashes_prime_powers(window_length, family, &prime_power_low, &prime_power_high);
+
+    // The characters are smaller than 2^8, so the products with the powers can be assembled
+    // from two 32-bit multiplications for both families.
+    sz_u256_vec_t prime_vec, golden_ratio_vec, shift_high_vec, byte_mask_vec;
+    sz_u256_vec_t power_low_low_vec, power_low_high_vec, power_high_low_vec, power_high_high_vec;
+    prime_vec.ymm = _mm256_set1_epi64x(is_mersenne ? SZ_U61_MERSENNE_PRIME : SZ_U64_MAX_PRIME);
     golden_ratio_vec.ymm = _mm256_set1_epi64x(11400714819323198485ull);
-    prime_power_low_vec.ymm = _mm256_set1_epi64x(prime_power_low);
-    prime_power_high_vec.ymm = _mm256_set1_epi64x(prime_power_high);
+    shift_high_vec.ymm = _mm256_set1_epi64x(77ull);
+    byte_mask_vec.ymm = _mm256_set1_epi64x(0xFFull);
+    power_low_low_vec.ymm = _mm256_set1_epi64x(prime_power_low & 0xFFFFFFFFull);
+    power_low_high_vec.ymm = _mm256_set1_epi64x(prime_power_low >> 32);
+    power_high_low_vec.ymm = _mm256_set1_epi64x(prime_power_high & 0xFFFFFFFFull);
+    power_high_high_vec.ymm = _mm256_set1_epi64x(prime_power_high >> 32);
+    // AVX2 only has signed 64-bit comparisons, so to check if `x >= prime` we flip the sign bit
+    // of both arguments and compare `x ^ sign > (prime - 1) ^ sign`.
+    sz_u256_vec_t sign_vec, prime_minus_one_flipped_vec, overflow_vec;
+    sign_vec.ymm = _mm256_set1_epi64x(0x8000000000000000ull);
+    prime_minus_one_flipped_vec.ymm = _mm256_set1_epi64x((SZ_U64_MAX_PRIME - 1ull) ^ 0x8000000000000000ull);
+
+    sz_u8_t const *texts[4];
+    for (int lane = 0; lane != 4; ++lane) texts[lane] = (sz_u8_t const *)start + lane * lane_length;
 
     // Compute the initial hash values for every one of the four windows.
     sz_u256_vec_t hash_low_vec, hash_high_vec, hash_mix_vec, chars_low_vec, chars_high_vec;
     hash_low_vec.ymm = _mm256_setzero_si256();
     hash_high_vec.ymm = _mm256_setzero_si256();
-    for (sz_u8_t const *prefix_end = text_first + window_length; text_first < prefix_end;
-         ++text_first, ++text_second, ++text_third, ++text_fourth) {
-
-        // 1. Multiply the hashes by the base.
-        hash_low_vec.ymm = _mm256_mul_epu64(hash_low_vec.ymm, base_low_vec.ymm);
-        hash_high_vec.ymm = _mm256_mul_epu64(hash_high_vec.ymm, base_high_vec.ymm);
-
-        // 2. Load the four characters from `text_first`, `text_first + max_hashes_per_thread`,
-        //   `text_first + max_hashes_per_thread * 2`, `text_first + max_hashes_per_thread * 3`.
-        chars_low_vec.ymm = _mm256_set_epi64x(text_fourth[0], text_third[0], text_second[0], text_first[0]);
-        chars_high_vec.ymm = _mm256_add_epi8(chars_low_vec.ymm, shift_high_vec.ymm);
-
-        // 3. Add the incoming characters.
-        hash_low_vec.ymm = _mm256_add_epi64(hash_low_vec.ymm, chars_low_vec.ymm);
-        hash_high_vec.ymm = _mm256_add_epi64(hash_high_vec.ymm, chars_high_vec.ymm);
-
-        // 4. Compute the modulo. Assuming there are only 59 values between our prime
-        //    and the 2^64 value, we can simply compute the modulo by conditionally subtracting the prime.
-        hash_low_vec.ymm = _mm256_blendv_epi8(hash_low_vec.ymm, _mm256_sub_epi64(hash_low_vec.ymm, prime_vec.ymm),
-                                              _mm256_cmpgt_epi64(hash_low_vec.ymm, prime_vec.ymm));
-        hash_high_vec.ymm = _mm256_blendv_epi8(hash_high_vec.ymm, _mm256_sub_epi64(hash_high_vec.ymm, prime_vec.ymm),
-                                               _mm256_cmpgt_epi64(hash_high_vec.ymm, prime_vec.ymm));
-    }
-
-    // 5. Compute the hash mix, that will be used to index into the fingerprint.
-    //    This includes a serial step at the end.
-    hash_low_vec.ymm = _mm256_mul_epu64(hash_low_vec.ymm, golden_ratio_vec.ymm);
-    hash_high_vec.ymm = _mm256_mul_epu64(hash_high_vec.ymm, golden_ratio_vec.ymm);
-    hash_mix_vec.ymm = _mm256_xor_si256(hash_low_vec.ymm, hash_high_vec.ymm);
-    callback((sz_cptr_t)text_first, window_length, hash_mix_vec.u64s[0], callback_handle);
-    callback((sz_cptr_t)text_second, window_length, hash_mix_vec.u64s[1], callback_handle);
-    callback((sz_cptr_t)text_third, window_length, hash_mix_vec.u64s[2], callback_handle);
-    callback((sz_cptr_t)text_fourth, window_length, hash_mix_vec.u64s[3], callback_handle);
-
-    // Now repeat that operation for the remaining characters, discarding older characters.
-    sz_size_t cycle = 1;
-    sz_size_t const step_mask = step - 1;
-    for (; text_fourth != text_end; ++text_first, ++text_second, ++text_third, ++text_fourth, ++cycle) {
-        // 0. Load again the four characters we are dropping, shift them, and subtract.
-        chars_low_vec.ymm = _mm256_set_epi64x(text_fourth[-window_length], text_third[-window_length],
-                                              text_second[-window_length], text_first[-window_length]);
-        chars_high_vec.ymm = _mm256_add_epi8(chars_low_vec.ymm, shift_high_vec.ymm);
-        hash_low_vec.ymm =
-            _mm256_sub_epi64(hash_low_vec.ymm, _mm256_mul_epu64(chars_low_vec.ymm, prime_power_low_vec.ymm));
-        hash_high_vec.ymm =
-            _mm256_sub_epi64(hash_high_vec.ymm, _mm256_mul_epu64(chars_high_vec.ymm, prime_power_high_vec.ymm));
-
-        // 1. Multiply the hashes by the base.
-        hash_low_vec.ymm = _mm256_mul_epu64(hash_low_vec.ymm, base_low_vec.ymm);
-        hash_high_vec.ymm = _mm256_mul_epu64(hash_high_vec.ymm, base_high_vec.ymm);
-
-        // 2. Load the four characters from `text_first`, `text_first + max_hashes_per_thread`,
-        //   `text_first + max_hashes_per_thread * 2`, `text_first + max_hashes_per_thread * 3`.
-        chars_low_vec.ymm = _mm256_set_epi64x(text_fourth[0], text_third[0], text_second[0], text_first[0]);
-        chars_high_vec.ymm = _mm256_add_epi8(chars_low_vec.ymm, shift_high_vec.ymm);
-
-        // 3. Add the incoming characters.
-        hash_low_vec.ymm = _mm256_add_epi64(hash_low_vec.ymm, chars_low_vec.ymm);
-        hash_high_vec.ymm = _mm256_add_epi64(hash_high_vec.ymm, chars_high_vec.ymm);
-
-        // 4. Compute the modulo. Assuming there are only 59 values between our prime
-        //    and the 2^64 value, we can simply compute the modulo by conditionally subtracting the prime.
-        hash_low_vec.ymm = _mm256_blendv_epi8(hash_low_vec.ymm, _mm256_sub_epi64(hash_low_vec.ymm, prime_vec.ymm),
-                                              _mm256_cmpgt_epi64(hash_low_vec.ymm, prime_vec.ymm));
-        hash_high_vec.ymm = _mm256_blendv_epi8(hash_high_vec.ymm, _mm256_sub_epi64(hash_high_vec.ymm, prime_vec.ymm),
-                                               _mm256_cmpgt_epi64(hash_high_vec.ymm, prime_vec.ymm));
-
-        // 5. Compute the hash mix, that will be used to index into the fingerprint.
-        //    This includes a serial step at the end.
-        hash_low_vec.ymm = _mm256_mul_epu64(hash_low_vec.ymm, golden_ratio_vec.ymm);
-        hash_high_vec.ymm = _mm256_mul_epu64(hash_high_vec.ymm, golden_ratio_vec.ymm);
-        hash_mix_vec.ymm = _mm256_xor_si256(hash_low_vec.ymm, hash_high_vec.ymm);
+    for (sz_size_t i = 0; i != window_length; ++i) {
+        chars_low_vec.ymm = _mm256_set_epi64x(texts[3][i], texts[2][i], texts[1][i], texts[0][i]);
+        chars_high_vec.ymm =
+            _mm256_and_si256(_mm256_add_epi64(chars_low_vec.ymm, shift_high_vec.ymm), byte_mask_vec.ymm);
+        if (is_mersenne) {
+            hash_low_vec.ymm = _sz_mersenne_mul_31_add_avx2(hash_low_vec.ymm, chars_low_vec.ymm, prime_vec.ymm);
+            hash_high_vec.ymm = _sz_mersenne_mul_257_add_avx2(hash_high_vec.ymm, chars_high_vec.ymm, prime_vec.ymm);
+        }
+        else {
+            // Multiplying by 31 and 257 is cheaper with shifts: `x * 31 = (x << 5) - x`, `x * 257 = (x << 8) + x`.
+            hash_low_vec.ymm = _mm256_sub_epi64(_mm256_slli_epi64(hash_low_vec.ymm, 5), hash_low_vec.ymm);
+            hash_low_vec.ymm = _mm256_add_epi64(hash_low_vec.ymm, chars_low_vec.ymm);
+            hash_high_vec.ymm = _mm256_add_epi64(_mm256_slli_epi64(hash_high_vec.ymm, 8), hash_high_vec.ymm);
+            hash_high_vec.ymm = _mm256_add_epi64(hash_high_vec.ymm, chars_high_vec.ymm);
+            overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(hash_low_vec.ymm, sign_vec.ymm),
+                                                  prime_minus_one_flipped_vec.ymm);
+            hash_low_vec.ymm = _mm256_sub_epi64(hash_low_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
+            overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(hash_high_vec.ymm, sign_vec.ymm),
+                                                  prime_minus_one_flipped_vec.ymm);
+            hash_high_vec.ymm = _mm256_sub_epi64(hash_high_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
+        }
+    }
+
+    for (sz_size_t cycle = 0, slot = 0;; ++cycle) {
+        // Mix and report the hashes of every lane, if we've skipped enough windows.
         if ((cycle & step_mask) == 0) {
-            callback((sz_cptr_t)text_first, window_length, hash_mix_vec.u64s[0], callback_handle);
-            callback((sz_cptr_t)text_second, window_length, hash_mix_vec.u64s[1], callback_handle);
-            callback((sz_cptr_t)text_third, window_length, hash_mix_vec.u64s[2], callback_handle);
-            callback((sz_cptr_t)text_fourth, window_length, hash_mix_vec.u64s[3], callback_handle);
+            hash_mix_vec.ymm = _mm256_xor_si256(_mm256_mul_epu64(hash_low_vec.ymm, golden_ratio_vec.ymm),
+                                                _mm256_mul_epu64(hash_high_vec.ymm, golden_ratio_vec.ymm));
+            if (callback)
+                for (int lane = 0; lane != 4; ++lane)
+                    callback((sz_cptr_t)texts[lane], window_length, hash_mix_vec.u64s[lane], callback_handle);
+            else {
+                for (int lane = 0; lane != 4; ++lane) hashes[lane * reported_per_lane + slot] = hash_mix_vec.u64s[lane];
+                if (positions)
+                    for (int lane = 0; lane != 4; ++lane)
+                        positions[lane * reported_per_lane + slot] = lane * lane_length + cycle;
+            }
+            ++slot;
+            if (cycle == last_cycle) break;
+        }
+
+        // Discard the oldest character from every lane.
+        chars_low_vec.ymm = _mm256_set_epi64x(texts[3][0], texts[2][0], texts[1][0], texts[0][0]);
+        chars_high_vec.ymm =
+            _mm256_and_si256(_mm256_add_epi64(chars_low_vec.ymm, shift_high_vec.ymm), byte_mask_vec.ymm);
+        if (is_mersenne) {
+            hash_low_vec.ymm = _sz_mersenne_reduce_avx2(
+                _mm256_sub_epi64(_mm256_add_epi64(hash_low_vec.ymm, prime_vec.ymm),
+                                 _sz_mersenne_mul_byte_avx2(chars_low_vec.ymm, power_low_low_vec.ymm,
+                                                            power_low_high_vec.ymm, prime_vec.ymm)),
+                prime_vec.ymm);
+            hash_high_vec.ymm = _sz_mersenne_reduce_avx2(
+                _mm256_sub_epi64(_mm256_add_epi64(hash_high_vec.ymm, prime_vec.ymm),
+                                 _sz_mersenne_mul_byte_avx2(chars_high_vec.ymm, power_high_low_vec.ymm,
+                                                            power_high_high_vec.ymm, prime_vec.ymm)),
+                prime_vec.ymm);
+        }
+        else {
+            hash_low_vec.ymm = _mm256_sub_epi64(
+                hash_low_vec.ymm,
+                _mm256_add_epi64(_mm256_mul_epu32(chars_low_vec.ymm, power_low_low_vec.ymm),
+                                 _mm256_slli_epi64(_mm256_mul_epu32(chars_low_vec.ymm, power_low_high_vec.ymm), 32)));
+            hash_high_vec.ymm = _mm256_sub_epi64(
+                hash_high_vec.ymm,
+                _mm256_add_epi64(_mm256_mul_epu32(chars_high_vec.ymm, power_high_low_vec.ymm),
+                                 _mm256_slli_epi64(_mm256_mul_epu32(chars_high_vec.ymm, power_high_high_vec.ymm), 32)));
+        }
+
+        // Append the new character to every lane.
+        sz_size_t const next = window_length;
+        chars_low_vec.ymm = _mm256_set_epi64x(texts[3][next], texts[2][next], texts[1][next], texts[0][next]);
+        chars_high_vec.ymm =
+            _mm256_and_si256(_mm256_add_epi64(chars_low_vec.ymm, shift_high_vec.ymm), byte_mask_vec.ymm);
+        if (is_mersenne) {
+            hash_low_vec.ymm = _sz_mersenne_mul_31_add_avx2(hash_low_vec.ymm, chars_low_vec.ymm, prime_vec.ymm);
+            hash_high_vec.ymm = _sz_mersenne_mul_257_add_avx2(hash_high_vec.ymm, chars_high_vec.ymm, prime_vec.ymm);
+        }
+        else {
+            hash_low_vec.ymm = _mm256_sub_epi64(_mm256_slli_epi64(hash_low_vec.ymm, 5), hash_low_vec.ymm);
+            hash_low_vec.ymm = _mm256_add_epi64(hash_low_vec.ymm, chars_low_vec.ymm);
+            hash_high_vec.ymm = _mm256_add_epi64(_mm256_slli_epi64(hash_high_vec.ymm, 8), hash_high_vec.ymm);
+            hash_high_vec.ymm = _mm256_add_epi64(hash_high_vec.ymm, chars_high_vec.ymm);
+            overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(hash_low_vec.ymm, sign_vec.ymm),
+                                                  prime_minus_one_flipped_vec.ymm);
+            hash_low_vec.ymm = _mm256_sub_epi64(hash_low_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
+            overflow_vec.ymm = _mm256_cmpgt_epi64(_mm256_xor_si256(hash_high_vec.ymm, sign_vec.ymm),
+                                                  prime_minus_one_flipped_vec.ymm);
+            hash_high_vec.ymm = _mm256_sub_epi64(hash_high_vec.ymm, _mm256_and_si256(overflow_vec.ymm, prime_vec.ymm));
         }
+        for (int lane = 0; lane != 4; ++lane) ++texts[lane];
     }
+
+    // Process the remaining windows, that didn't fit evenly into the lanes.
+    sz_size_t const processed = reported_per_lane * 4, processed_length = processed * step;
+    sz_size_t const tail = _sz_hashes_serial(                                        //
+        start + processed_length, length - processed_length, window_length, step, family, callback, callback_handle, //
+        callback ? SZ_NULL : hashes + processed, positions ? positions + processed : SZ_NULL, reported - processed);
+    if (positions)
+        for (sz_size_t i = 0; i != tail; ++i) positions[processed + i] += processed_length;
+    return processed + tail;
+}
+
+SZ_PUBLIC void sz_hashes_avx2(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                              sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_avx2(start, length, window_length, step, sz_hash_family_prime_k, callback, callback_handle, SZ_NULL,
+                    SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC void sz_hashes_mersenne_avx2(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                       sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_avx2(start, length, window_length, step, sz_hash_family_mersenne_k, callback, callback_handle,
+                    SZ_NULL, SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC sz_size_t sz_hashes_into_avx2(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                        sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                        sz_size_t capacity) {
+    return _sz_hashes_avx2(start, length, window_length, step, family, SZ_NULL, SZ_NULL, hashes, positions,
+                           capacity);
 }
 
 #pragma clang attribute pop
@@ -3918,6 +6384,8 @@ SZ_PUBLIC sz_ordering_t sz_order_avx512(sz_cptr_t a, sz_size_t a_length, sz_cptr
         // They, however, have latency 3 on most modern CPUs. Using AVX2: `_mm256_cmpeq_epi8` would have
         // been cheaper, if we didn't have to apply `_mm256_movemask_epi8` afterwards.
         mask_not_equal = _mm512_cmpneq_epi8_mask(a_vec.zmm, b_vec.zmm);
+        // The zero-padded tails can differ past the end of the shorter string, where it's a prefix of the other.
+        mask_not_equal &= a_mask & b_mask;
         if (mask_not_equal != 0) {
             int first_diff = _tzcnt_u64(mask_not_equal);
             char a_char = a[first_diff];
@@ -4313,132 +6781,354 @@ SZ_INTERNAL sz_size_t sz_edit_distance_avx512(   //
 #pragma GCC target("avx", "avx512f", "avx512vl", "avx512bw", "avx512dq", "bmi", "bmi2")
 #pragma clang attribute push(__attribute__((target("avx,avx512f,avx512vl,avx512bw,avx512dq,bmi,bmi2"))), \
                              apply_to = function)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // GCC 12 intrinsics pass self-initialized `_mm*_undefined_*`
+#endif
 
-SZ_PUBLIC void sz_hashes_avx512(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
-                                sz_hash_callback_t callback, void *callback_handle) {
+SZ_PUBLIC void sz_hash_tape_avx512(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
 
-    if (length < window_length || !window_length) return;
-    if (length < 4 * window_length) {
-        sz_hashes_serial(start, length, window_length, step, callback, callback_handle);
-        return;
+    // Broadcast the constants shared by all lanes.
+    sz_u512_vec_t prime_vec, golden_ratio_vec, shift_high_vec, byte_mask_vec;
+    prime_vec.zmm = _mm512_set1_epi64(SZ_U64_MAX_PRIME);
+    golden_ratio_vec.zmm = _mm512_set1_epi64(11400714819323198485ull);
+    shift_high_vec.zmm = _mm512_set1_epi64(77ull);
+    byte_mask_vec.zmm = _mm512_set1_epi64(0xFFull);
+
+    // Every one of the 8 lanes is hashing a different string, interleaving their dependency chains.
+    // The bytes are fetched in 8-byte words, so we need just one gather per 8 iterations.
+    sz_u512_vec_t begins_vec, lengths_vec, progress_vec, words_vec;
+    sz_u512_vec_t chars_low_vec, chars_high_vec, hash_low_vec, hash_high_vec, new_low_vec, new_high_vec;
+    for (; count >= 8; offsets += 8, hashes += 8, count -= 8) {
+        begins_vec.zmm = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i const *)offsets));
+        lengths_vec.zmm = _mm512_sub_epi64(_mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i const *)(offsets + 1))),
+                                           begins_vec.zmm);
+        sz_size_t const max_length = _mm512_reduce_max_epu64(lengths_vec.zmm);
+        hash_low_vec.zmm = _mm512_setzero_si512();
+        hash_high_vec.zmm = _mm512_setzero_si512();
+
+        for (sz_size_t progress = 0; progress < max_length; progress += 8) {
+            // Strings with at least 8 more bytes are gathered at once, the shorter tails are fetched
+            // with masked loads, to avoid reading past the end of the tape.
+            progress_vec.zmm = _mm512_set1_epi64(progress);
+            __mmask8 full_mask = _mm512_cmpge_epu64_mask(lengths_vec.zmm, _mm512_set1_epi64(progress + 8));
+            __mmask8 tail_mask = _mm512_cmpgt_epu64_mask(lengths_vec.zmm, progress_vec.zmm) & ~full_mask;
+            words_vec.zmm = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), full_mask,
+                                                        _mm512_add_epi64(begins_vec.zmm, progress_vec.zmm), start, 1);
+            for (; tail_mask; tail_mask &= tail_mask - 1) {
+                int lane = sz_u64_ctz(tail_mask);
+                __m128i tail = _mm_maskz_loadu_epi8(_sz_u16_clamp_mask_until(lengths_vec.u64s[lane] - progress),
+                                                    start + begins_vec.u64s[lane] + progress);
+                words_vec.zmm = _mm512_mask_set1_epi64(words_vec.zmm, (__mmask8)(1u << lane), _mm_cvtsi128_si64(tail));
+            }
+
+            // Consume the 8 bytes one at a time, only updating the lanes that haven't reached their end.
+            for (sz_size_t byte = 0; byte != 8; ++byte) {
+                __mmask8 active_mask = _mm512_cmpgt_epu64_mask(lengths_vec.zmm, _mm512_set1_epi64(progress + byte));
+                chars_low_vec.zmm = _mm512_and_si512(words_vec.zmm, byte_mask_vec.zmm);
+                chars_high_vec.zmm =
+                    _mm512_and_si512(_mm512_add_epi64(chars_low_vec.zmm, shift_high_vec.zmm), byte_mask_vec.zmm);
+                words_vec.zmm = _mm512_srli_epi64(words_vec.zmm, 8);
+
+                // Multiplying by 31 and 257 is cheaper with shifts: `x * 31 = (x << 5) - x`, `x * 257 = (x << 8) + x`.
+                new_low_vec.zmm = _mm512_sub_epi64(_mm512_slli_epi64(hash_low_vec.zmm, 5), hash_low_vec.zmm);
+                new_low_vec.zmm = _mm512_add_epi64(new_low_vec.zmm, chars_low_vec.zmm);
+                new_high_vec.zmm = _mm512_add_epi64(_mm512_slli_epi64(hash_high_vec.zmm, 8), hash_high_vec.zmm);
+                new_high_vec.zmm = _mm512_add_epi64(new_high_vec.zmm, chars_high_vec.zmm);
+
+                // Compute the modulo by conditionally subtracting the prime, just like `sz_hash_serial`.
+                new_low_vec.zmm = _mm512_mask_sub_epi64(new_low_vec.zmm,
+                                                        _mm512_cmpge_epu64_mask(new_low_vec.zmm, prime_vec.zmm),
+                                                        new_low_vec.zmm, prime_vec.zmm);
+                new_high_vec.zmm = _mm512_mask_sub_epi64(new_high_vec.zmm,
+                                                         _mm512_cmpge_epu64_mask(new_high_vec.zmm, prime_vec.zmm),
+                                                         new_high_vec.zmm, prime_vec.zmm);
+
+                hash_low_vec.zmm = _mm512_mask_mov_epi64(hash_low_vec.zmm, active_mask, new_low_vec.zmm);
+                hash_high_vec.zmm = _mm512_mask_mov_epi64(hash_high_vec.zmm, active_mask, new_high_vec.zmm);
+            }
+        }
+
+        // Mix the two hashes, similar to `_sz_hash_mix`.
+        hash_low_vec.zmm = _mm512_mullo_epi64(hash_low_vec.zmm, golden_ratio_vec.zmm);
+        hash_high_vec.zmm = _mm512_mullo_epi64(hash_high_vec.zmm, golden_ratio_vec.zmm);
+        _mm512_storeu_si512(hashes, _mm512_xor_si512(hash_low_vec.zmm, hash_high_vec.zmm));
     }
 
-    // Using AVX2, we can perform 4 long integer multiplications and additions within one register.
-    // So let's slice the entire string into 4 overlapping windows, to slide over them in parallel.
-    sz_size_t const max_hashes = length - window_length + 1;
-    sz_size_t const min_hashes_per_thread = max_hashes / 4; // At most one sequence can overlap between 2 threads.
-    sz_u8_t const *text_first = (sz_u8_t const *)start;
-    sz_u8_t const *text_second = text_first + min_hashes_per_thread;
-    sz_u8_t const *text_third = text_first + min_hashes_per_thread * 2;
-    sz_u8_t const *text_fourth = text_first + min_hashes_per_thread * 3;
-    sz_u8_t const *text_end = text_first + length;
+    sz_hash_tape_serial(start, offsets, count, hashes);
+}
 
-    // Broadcast the global constants into the registers.
-    // Both high and low hashes will work with the same prime and golden ratio.
-    sz_u512_vec_t prime_vec, golden_ratio_vec;
-    prime_vec.zmm = _mm512_set1_epi64(SZ_U64_MAX_PRIME);
-    golden_ratio_vec.zmm = _mm512_set1_epi64(11400714819323198485ull);
+/** @copydoc _sz_mersenne_reduce */
+SZ_INTERNAL __m512i _sz_mersenne_reduce_avx512(__m512i x, __m512i prime) {
+    x = _mm512_add_epi64(_mm512_and_si512(x, prime), _mm512_srli_epi64(x, 61));
+    return _mm512_mask_sub_epi64(x, _mm512_cmpge_epu64_mask(x, prime), x, prime);
+}
 
-    // Prepare the `prime ^ window_length` values, that we are going to use for modulo arithmetic.
-    sz_u64_t prime_power_low = 1, prime_power_high = 1;
-    for (sz_size_t i = 0; i + 1 < window_length; ++i)
-        prime_power_low = (prime_power_low * 31ull) % SZ_U64_MAX_PRIME,
-        prime_power_high = (prime_power_high * 257ull) % SZ_U64_MAX_PRIME;
-
-    // We will be evaluating 4 offsets at a time with 2 different hash functions.
-    // We can fit all those 8 state variables in each of the following ZMM registers.
-    sz_u512_vec_t base_vec, prime_power_vec, shift_vec;
-    base_vec.zmm = _mm512_set_epi64(31ull, 31ull, 31ull, 31ull, 257ull, 257ull, 257ull, 257ull);
-    shift_vec.zmm = _mm512_set_epi64(0ull, 0ull, 0ull, 0ull, 77ull, 77ull, 77ull, 77ull);
-    prime_power_vec.zmm = _mm512_set_epi64(prime_power_low, prime_power_low, prime_power_low, prime_power_low,
-                                           prime_power_high, prime_power_high, prime_power_high, prime_power_high);
+/** @copydoc _sz_mersenne_mul_byte */
+SZ_INTERNAL __m512i _sz_mersenne_mul_byte_avx512(__m512i bytes, __m512i x_low, __m512i x_high, __m512i prime) {
+    // The `_mm512_mul_epu32` only looks at the bottom 32 bits of every 64-bit lane.
+    // Multiplying the upper half by `2^32` modulo the prime is a rotation of the lower 61 bits.
+    __m512i high = _mm512_mul_epu32(bytes, x_high);
+    high = _mm512_or_si512(_mm512_and_si512(_mm512_slli_epi64(high, 32), prime), _mm512_srli_epi64(high, 29));
+    return _sz_mersenne_reduce_avx512(_mm512_add_epi64(_mm512_mul_epu32(bytes, x_low), high), prime);
+}
 
-    // Compute the initial hash values for every one of the four windows.
-    sz_u512_vec_t hash_vec, chars_vec;
-    hash_vec.zmm = _mm512_setzero_si512();
-    for (sz_u8_t const *prefix_end = text_first + window_length; text_first < prefix_end;
-         ++text_first, ++text_second, ++text_third, ++text_fourth) {
-
-        // 1. Multiply the hashes by the base.
-        hash_vec.zmm = _mm512_mullo_epi64(hash_vec.zmm, base_vec.zmm);
-
-        // 2. Load the four characters from `text_first`, `text_first + max_hashes_per_thread`,
-        //   `text_first + max_hashes_per_thread * 2`, `text_first + max_hashes_per_thread * 3`...
-        chars_vec.zmm = _mm512_set_epi64(text_fourth[0], text_third[0], text_second[0], text_first[0], //
-                                         text_fourth[0], text_third[0], text_second[0], text_first[0]);
-        chars_vec.zmm = _mm512_add_epi8(chars_vec.zmm, shift_vec.zmm);
-
-        // 3. Add the incoming characters.
-        hash_vec.zmm = _mm512_add_epi64(hash_vec.zmm, chars_vec.zmm);
-
-        // 4. Compute the modulo. Assuming there are only 59 values between our prime
-        //    and the 2^64 value, we can simply compute the modulo by conditionally subtracting the prime.
-        hash_vec.zmm = _mm512_mask_blend_epi8(_mm512_cmpgt_epi64_mask(hash_vec.zmm, prime_vec.zmm), hash_vec.zmm,
-                                              _mm512_sub_epi64(hash_vec.zmm, prime_vec.zmm));
-    }
-
-    // 5. Compute the hash mix, that will be used to index into the fingerprint.
-    //    This includes a serial step at the end.
-    sz_u512_vec_t hash_mix_vec;
-    hash_mix_vec.zmm = _mm512_mullo_epi64(hash_vec.zmm, golden_ratio_vec.zmm);
-    hash_mix_vec.ymms[0] = _mm256_xor_si256(_mm512_extracti64x4_epi64(hash_mix_vec.zmm, 1), //
-                                            _mm512_extracti64x4_epi64(hash_mix_vec.zmm, 0));
-
-    callback((sz_cptr_t)text_first, window_length, hash_mix_vec.u64s[0], callback_handle);
-    callback((sz_cptr_t)text_second, window_length, hash_mix_vec.u64s[1], callback_handle);
-    callback((sz_cptr_t)text_third, window_length, hash_mix_vec.u64s[2], callback_handle);
-    callback((sz_cptr_t)text_fourth, window_length, hash_mix_vec.u64s[3], callback_handle);
-
-    // Now repeat that operation for the remaining characters, discarding older characters.
-    sz_size_t cycle = 1;
-    sz_size_t step_mask = step - 1;
-    for (; text_fourth != text_end; ++text_first, ++text_second, ++text_third, ++text_fourth, ++cycle) {
-        // 0. Load again the four characters we are dropping, shift them, and subtract.
-        chars_vec.zmm = _mm512_set_epi64(text_fourth[-window_length], text_third[-window_length],
-                                         text_second[-window_length], text_first[-window_length], //
-                                         text_fourth[-window_length], text_third[-window_length],
-                                         text_second[-window_length], text_first[-window_length]);
-        chars_vec.zmm = _mm512_add_epi8(chars_vec.zmm, shift_vec.zmm);
-        hash_vec.zmm = _mm512_sub_epi64(hash_vec.zmm, _mm512_mullo_epi64(chars_vec.zmm, prime_power_vec.zmm));
-
-        // 1. Multiply the hashes by the base.
-        hash_vec.zmm = _mm512_mullo_epi64(hash_vec.zmm, base_vec.zmm);
-
-        // 2. Load the four characters from `text_first`, `text_first + max_hashes_per_thread`,
-        //   `text_first + max_hashes_per_thread * 2`, `text_first + max_hashes_per_thread * 3`.
-        chars_vec.zmm = _mm512_set_epi64(text_fourth[0], text_third[0], text_second[0], text_first[0], //
-                                         text_fourth[0], text_third[0], text_second[0], text_first[0]);
-        chars_vec.zmm = _mm512_add_epi8(chars_vec.zmm, shift_vec.zmm);
-
-        // ... and prefetch the next four characters into Level 2 or higher.
-        _mm_prefetch(text_fourth + 1, _MM_HINT_T1);
-        _mm_prefetch(text_third + 1, _MM_HINT_T1);
-        _mm_prefetch(text_second + 1, _MM_HINT_T1);
-        _mm_prefetch(text_first + 1, _MM_HINT_T1);
-
-        // 3. Add the incoming characters.
-        hash_vec.zmm = _mm512_add_epi64(hash_vec.zmm, chars_vec.zmm);
-
-        // 4. Compute the modulo. Assuming there are only 59 values between our prime
-        //    and the 2^64 value, we can simply compute the modulo by conditionally subtracting the prime.
-        hash_vec.zmm = _mm512_mask_blend_epi8(_mm512_cmpgt_epi64_mask(hash_vec.zmm, prime_vec.zmm), hash_vec.zmm,
-                                              _mm512_sub_epi64(hash_vec.zmm, prime_vec.zmm));
-
-        // 5. Compute the hash mix, that will be used to index into the fingerprint.
-        //    This includes a serial step at the end.
-        hash_mix_vec.zmm = _mm512_mullo_epi64(hash_vec.zmm, golden_ratio_vec.zmm);
-        hash_mix_vec.ymms[0] = _mm256_xor_si256(_mm512_extracti64x4_epi64(hash_mix_vec.zmm, 1), //
-                                                _mm512_castsi512_si256(hash_mix_vec.zmm));
+/** @copydoc _sz_mersenne_mul_31 */
+SZ_INTERNAL __m512i _sz_mersenne_mul_31_add_avx512(__m512i x, __m512i chars, __m512i prime) {
+    __m512i rotated = _mm512_or_si512(_mm512_and_si512(_mm512_slli_epi64(x, 5), prime), _mm512_srli_epi64(x, 56));
+    return _sz_mersenne_reduce_avx512(
+        _mm512_add_epi64(rotated, _mm512_sub_epi64(_mm512_add_epi64(prime, chars), x)), prime);
+}
+
+/** @copydoc _sz_mersenne_mul_257 */
+SZ_INTERNAL __m512i _sz_mersenne_mul_257_add_avx512(__m512i x, __m512i chars, __m512i prime) {
+    __m512i rotated = _mm512_or_si512(_mm512_and_si512(_mm512_slli_epi64(x, 8), prime), _mm512_srli_epi64(x, 53));
+    return _sz_mersenne_reduce_avx512(_mm512_add_epi64(rotated, _mm512_add_epi64(x, chars)), prime);
+}
+
+/**
+ *  @brief  Shared AVX-512 implementation of the rolling hashes for all families, slicing the text into 8 parts,
+ *          one per 64-bit lane, each reporting the same number of consecutive windows, so that the hashes can
+ *          be scattered into the output array in order. The remaining windows are processed serially.
+ *  @see    _sz_hashes_serial
+ */
+SZ_INTERNAL sz_size_t _sz_hashes_avx512(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                        sz_hash_family_t family, sz_hash_callback_t callback, void *callback_handle,
+                                        sz_u64_t *hashes, sz_size_t *positions, sz_size_t capacity) {
+
+    if (length < window_length || !window_length || !capacity) return 0;
+    sz_size_t const step_mask = step - 1;
+    sz_size_t const reported = sz_min_of_two((length - window_length) / step + 1, capacity);
+    sz_size_t const reported_per_lane = reported / 8;
+    if (reported_per_lane < 2)
+        return _sz_hashes_serial(start, length, window_length, step, family, callback, callback_handle, hashes,
+                                 positions, capacity);
+    sz_size_t const lane_length = reported_per_lane * step;
+    sz_size_t const last_cycle = (reported_per_lane - 1) * step;
+    sz_bool_t const is_mersenne = (sz_bool_t)(family == sz_hash_family_mersenne_k);
+
+    // Prepare the `base ^ (window_length - 1)` values, to discard the oldest characters.
+    sz_u64_t prime_power_low, prime_power_high;
+    _sz_hashes_prime_powers(window_length, family, &prime_power_low, &prime_power_high);
+
+    sz_u512_vec_t prime_vec, golden_ratio_vec, shift_high_vec, byte_mask_vec;
+    sz_u512_vec_t power_low_vec, power_high_vec;
+    sz_u512_vec_t power_low_low_vec, power_low_high_vec, power_high_low_vec, power_high_high_vec;
+    prime_vec.zmm = _mm512_set1_epi64(is_mersenne ? SZ_U61_MERSENNE_PRIME : SZ_U64_MAX_PRIME);
+    golden_ratio_vec.zmm = _mm512_set1_epi64(11400714819323198485ull);
+    shift_high_vec.zmm = _mm512_set1_epi64(77ull);
+    byte_mask_vec.zmm = _mm512_set1_epi64(0xFFull);
+    power_low_vec.zmm = _mm512_set1_epi64(prime_power_low);
+    power_high_vec.zmm = _mm512_set1_epi64(prime_power_high);
+    power_low_low_vec.zmm = _mm512_set1_epi64(prime_power_low & 0xFFFFFFFFull);
+    power_low_high_vec.zmm = _mm512_set1_epi64(prime_power_low >> 32);
+    power_high_low_vec.zmm = _mm512_set1_epi64(prime_power_high & 0xFFFFFFFFull);
+    power_high_high_vec.zmm = _mm512_set1_epi64(prime_power_high >> 32);
+
+    // The output slots and the offsets of the first windows of every lane.
+    sz_u512_vec_t lanes_vec, slots_vec, offsets_vec;
+    lanes_vec.zmm = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    slots_vec.zmm = _mm512_mullo_epi64(lanes_vec.zmm, _mm512_set1_epi64(reported_per_lane));
+    offsets_vec.zmm = _mm512_mullo_epi64(lanes_vec.zmm, _mm512_set1_epi64(lane_length));
+
+    sz_u8_t const *texts[8];
+    for (int lane = 0; lane != 8; ++lane) texts[lane] = (sz_u8_t const *)start + lane * lane_length;
+
+    // Compute the initial hash values for every one of the eight windows.
+    sz_u512_vec_t hash_low_vec, hash_high_vec, hash_mix_vec, chars_low_vec, chars_high_vec;
+    hash_low_vec.zmm = _mm512_setzero_si512();
+    hash_high_vec.zmm = _mm512_setzero_si512();
+    for (sz_size_t i = 0; i != window_length; ++i) {
+        chars_low_vec.zmm = _mm512_set_epi64(texts[7][i], texts[6][i], texts[5][i], texts[4][i], //
+                                             texts[3][i], texts[2][i], texts[1][i], texts[0][i]);
+        chars_high_vec.zmm =
+            _mm512_and_si512(_mm512_add_epi64(chars_low_vec.zmm, shift_high_vec.zmm), byte_mask_vec.zmm);
+        if (is_mersenne) {
+            hash_low_vec.zmm = _sz_mersenne_mul_31_add_avx512(hash_low_vec.zmm, chars_low_vec.zmm, prime_vec.zmm);
+            hash_high_vec.zmm = _sz_mersenne_mul_257_add_avx512(hash_high_vec.zmm, chars_high_vec.zmm, prime_vec.zmm);
+        }
+        else {
+            // Multiplying by 31 and 257 is cheaper with shifts: `x * 31 = (x << 5) - x`, `x * 257 = (x << 8) + x`.
+            hash_low_vec.zmm = _mm512_sub_epi64(_mm512_slli_epi64(hash_low_vec.zmm, 5), hash_low_vec.zmm);
+            hash_low_vec.zmm = _mm512_add_epi64(hash_low_vec.zmm, chars_low_vec.zmm);
+            hash_high_vec.zmm = _mm512_add_epi64(_mm512_slli_epi64(hash_high_vec.zmm, 8), hash_high_vec.zmm);
+            hash_high_vec.zmm = _mm512_add_epi64(hash_high_vec.zmm, chars_high_vec.zmm);
+            hash_low_vec.zmm = _mm512_mask_sub_epi64(hash_low_vec.zmm,
+                                                     _mm512_cmpge_epu64_mask(hash_low_vec.zmm, prime_vec.zmm),
+                                                     hash_low_vec.zmm, prime_vec.zmm);
+            hash_high_vec.zmm = _mm512_mask_sub_epi64(hash_high_vec.zmm,
+                                                      _mm512_cmpge_epu64_mask(hash_high_vec.zmm, prime_vec.zmm),
+                                                      hash_high_vec.zmm, prime_vec.zmm);
+        }
+    }
 
+    for (sz_size_t cycle = 0;; ++cycle) {
+        // Mix and report the hashes of every lane, if we've skipped enough windows.
         if ((cycle & step_mask) == 0) {
-            callback((sz_cptr_t)text_first, window_length, hash_mix_vec.u64s[0], callback_handle);
-            callback((sz_cptr_t)text_second, window_length, hash_mix_vec.u64s[1], callback_handle);
-            callback((sz_cptr_t)text_third, window_length, hash_mix_vec.u64s[2], callback_handle);
-            callback((sz_cptr_t)text_fourth, window_length, hash_mix_vec.u64s[3], callback_handle);
+            hash_mix_vec.zmm = _mm512_xor_si512(_mm512_mullo_epi64(hash_low_vec.zmm, golden_ratio_vec.zmm),
+                                                _mm512_mullo_epi64(hash_high_vec.zmm, golden_ratio_vec.zmm));
+            if (callback)
+                for (int lane = 0; lane != 8; ++lane)
+                    callback((sz_cptr_t)texts[lane], window_length, hash_mix_vec.u64s[lane], callback_handle);
+            else {
+                _mm512_i64scatter_epi64(hashes, slots_vec.zmm, hash_mix_vec.zmm, 8);
+                if (positions)
+                    _mm512_i64scatter_epi64(positions, slots_vec.zmm,
+                                            _mm512_add_epi64(offsets_vec.zmm, _mm512_set1_epi64(cycle)), 8);
+                slots_vec.zmm = _mm512_add_epi64(slots_vec.zmm, _mm512_set1_epi64(1));
+            }
+            if (cycle == last_cycle) break;
+        }
+
+        // Discard the oldest character from every lane...
+        chars_low_vec.zmm = _mm512_set_epi64(texts[7][0], texts[6][0], texts[5][0], texts[4][0], //
+                                             texts[3][0], texts[2][0], texts[1][0], texts[0][0]);
+        chars_high_vec.zmm =
+            _mm512_and_si512(_mm512_add_epi64(chars_low_vec.zmm, shift_high_vec.zmm), byte_mask_vec.zmm);
+        if (is_mersenne) {
+            hash_low_vec.zmm = _sz_mersenne_reduce_avx512(
+                _mm512_sub_epi64(_mm512_add_epi64(hash_low_vec.zmm, prime_vec.zmm),
+                                 _sz_mersenne_mul_byte_avx512(chars_low_vec.zmm, power_low_low_vec.zmm,
+                                                              power_low_high_vec.zmm, prime_vec.zmm)),
+                prime_vec.zmm);
+            hash_high_vec.zmm = _sz_mersenne_reduce_avx512(
+                _mm512_sub_epi64(_mm512_add_epi64(hash_high_vec.zmm, prime_vec.zmm),
+                                 _sz_mersenne_mul_byte_avx512(chars_high_vec.zmm, power_high_low_vec.zmm,
+                                                              power_high_high_vec.zmm, prime_vec.zmm)),
+                prime_vec.zmm);
+        }
+        else {
+            hash_low_vec.zmm =
+                _mm512_sub_epi64(hash_low_vec.zmm, _mm512_mullo_epi64(chars_low_vec.zmm, power_low_vec.zmm));
+            hash_high_vec.zmm =
+                _mm512_sub_epi64(hash_high_vec.zmm, _mm512_mullo_epi64(chars_high_vec.zmm, power_high_vec.zmm));
+        }
+
+        // ... and append the new one.
+        sz_size_t const next = window_length;
+        chars_low_vec.zmm = _mm512_set_epi64(texts[7][next], texts[6][next], texts[5][next], texts[4][next], //
+                                             texts[3][next], texts[2][next], texts[1][next], texts[0][next]);
+        chars_high_vec.zmm =
+            _mm512_and_si512(_mm512_add_epi64(chars_low_vec.zmm, shift_high_vec.zmm), byte_mask_vec.zmm);
+        if (is_mersenne) {
+            hash_low_vec.zmm = _sz_mersenne_mul_31_add_avx512(hash_low_vec.zmm, chars_low_vec.zmm, prime_vec.zmm);
+            hash_high_vec.zmm = _sz_mersenne_mul_257_add_avx512(hash_high_vec.zmm, chars_high_vec.zmm, prime_vec.zmm);
         }
+        else {
+            hash_low_vec.zmm = _mm512_sub_epi64(_mm512_slli_epi64(hash_low_vec.zmm, 5), hash_low_vec.zmm);
+            hash_low_vec.zmm = _mm512_add_epi64(hash_low_vec.zmm, chars_low_vec.zmm);
+            hash_high_vec.zmm = _mm512_add_epi64(_mm512_slli_epi64(hash_high_vec.zmm, 8), hash_high_vec.zmm);
+            hash_high_vec.zmm = _mm512_add_epi64(hash_high_vec.zmm, chars_high_vec.zmm);
+            hash_low_vec.zmm = _mm512_mask_sub_epi64(hash_low_vec.zmm,
+                                                     _mm512_cmpge_epu64_mask(hash_low_vec.zmm, prime_vec.zmm),
+                                                     hash_low_vec.zmm, prime_vec.zmm);
+            hash_high_vec.zmm = _mm512_mask_sub_epi64(hash_high_vec.zmm,
+                                                      _mm512_cmpge_epu64_mask(hash_high_vec.zmm, prime_vec.zmm),
+                                                      hash_high_vec.zmm, prime_vec.zmm);
+        }
+        for (int lane = 0; lane != 8; ++lane) ++texts[lane];
+    }
+
+    // Process the remaining windows, that didn't fit evenly into the lanes.
+    sz_size_t const processed = reported_per_lane * 8, processed_length = processed * step;
+    sz_size_t const tail = _sz_hashes_serial(                                        //
+        start + processed_length, length - processed_length, window_length, step, family, callback, callback_handle, //
+        callback ? SZ_NULL : hashes + processed, positions ? positions + processed : SZ_NULL, reported - processed);
+    if (positions)
+        for (sz_size_t i = 0; i != tail; ++i) positions[processed + i] += processed_length;
+    return processed + tail;
+}
+
+SZ_PUBLIC void sz_hashes_avx512(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_avx512(start, length, window_length, step, sz_hash_family_prime_k, callback, callback_handle, SZ_NULL,
+                      SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC void sz_hashes_mersenne_avx512(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step, //
+                                         sz_hash_callback_t callback, void *callback_handle) {
+    _sz_hashes_avx512(start, length, window_length, step, sz_hash_family_mersenne_k, callback, callback_handle,
+                      SZ_NULL, SZ_NULL, SZ_SIZE_MAX);
+}
+
+SZ_PUBLIC sz_size_t sz_hashes_into_avx512(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_size_t step,
+                                          sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                          sz_size_t capacity) {
+    return _sz_hashes_avx512(start, length, window_length, step, family, SZ_NULL, SZ_NULL, hashes, positions,
+                             capacity);
+}
+
+SZ_PUBLIC void sz_hashes_minhash_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                        sz_hash_family_t family, sz_u64_t *signature, sz_size_t signature_length) {
+
+    // Export the rolling hashes into a small on-stack buffer, and update 8 permutations at a time,
+    // broadcasting every hash into a ZMM register.
+    sz_u64_t hashes[256];
+    sz_u512_vec_t multipliers_vec, seeds_vec, minimums_vec, permuted_vec;
+    while (window_length && length >= window_length) {
+        sz_size_t const count = sz_hashes_into_avx512(text, length, window_length, 1, family, hashes, SZ_NULL, 256);
+        for (sz_size_t slot = 0; slot < signature_length; slot += 8) {
+            __mmask8 slots_mask = (__mmask8)_sz_u16_clamp_mask_until(signature_length - slot);
+            for (int lane = 0; lane != 8; ++lane)
+                _sz_minhash_permutation(slot + lane, &multipliers_vec.u64s[lane], &seeds_vec.u64s[lane]);
+            minimums_vec.zmm = _mm512_maskz_loadu_epi64(slots_mask, signature + slot);
+            for (sz_size_t i = 0; i != count; ++i) {
+                permuted_vec.zmm = _mm512_xor_si512(_mm512_set1_epi64(hashes[i]), seeds_vec.zmm);
+                permuted_vec.zmm = _mm512_mullo_epi64(permuted_vec.zmm, multipliers_vec.zmm);
+                minimums_vec.zmm = _mm512_min_epu64(minimums_vec.zmm, permuted_vec.zmm);
+            }
+            _mm512_mask_storeu_epi64(signature + slot, slots_mask, minimums_vec.zmm);
+        }
+        text += count, length -= count;
+    }
+}
+
+SZ_PUBLIC sz_u64_t sz_hashes_simhash_avx512(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                            sz_hash_family_t family) {
+
+    // Count the set bits in 32-bit counters, 16 bit positions per ZMM register, with masked increments.
+    // The counters are flushed into 64-bit totals after every block, so they never overflow.
+    sz_size_t ones[64] = {0}, total = 0;
+    sz_u64_t hashes[256];
+    sz_u512_vec_t counters_vec[4], one_vec;
+    one_vec.zmm = _mm512_set1_epi32(1);
+    while (window_length && length >= window_length) {
+        sz_size_t const count = sz_hashes_into_avx512(text, length, window_length, 1, family, hashes, SZ_NULL, 256);
+        for (int part = 0; part != 4; ++part) counters_vec[part].zmm = _mm512_setzero_si512();
+        for (sz_size_t i = 0; i != count; ++i)
+            for (int part = 0; part != 4; ++part)
+                counters_vec[part].zmm = _mm512_mask_add_epi32(counters_vec[part].zmm,
+                                                               (__mmask16)(hashes[i] >> (part * 16)),
+                                                               counters_vec[part].zmm, one_vec.zmm);
+        for (int part = 0; part != 4; ++part)
+            for (int bit = 0; bit != 16; ++bit) ones[part * 16 + bit] += counters_vec[part].u32s[bit];
+        text += count, length -= count, total += count;
+    }
+
+    sz_u64_t simhash = 0;
+    for (int bit = 0; bit != 64; ++bit) simhash |= (sz_u64_t)(ones[bit] * 2 > total) << bit;
+    return simhash;
+}
+
+SZ_PUBLIC void sz_minhash_matches_avx512(sz_u64_t const *query, sz_u64_t const *signatures,
+                                         sz_size_t signatures_count, sz_size_t signature_length, sz_size_t *matches) {
+    sz_u512_vec_t query_vec, signature_vec;
+    for (sz_size_t i = 0; i != signatures_count; ++i, signatures += signature_length) {
+        sz_size_t count = 0;
+        for (sz_size_t slot = 0; slot < signature_length; slot += 8) {
+            __mmask8 slots_mask = (__mmask8)_sz_u16_clamp_mask_until(signature_length - slot);
+            query_vec.zmm = _mm512_maskz_loadu_epi64(slots_mask, query + slot);
+            signature_vec.zmm = _mm512_maskz_loadu_epi64(slots_mask, signatures + slot);
+            count += sz_u64_popcount(_mm512_mask_cmpeq_epi64_mask(slots_mask, query_vec.zmm, signature_vec.zmm));
+        }
+        matches[i] = count;
     }
 }
 
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 #pragma clang attribute pop
 #pragma GCC pop_options
 
@@ -4446,6 +7136,10 @@ SZ_PUBLIC void sz_hashes_avx512(sz_cptr_t start, sz_size_t length, sz_size_t win
 #pragma GCC target("avx", "avx512f", "avx512vl", "avx512bw", "avx512vbmi", "bmi", "bmi2", "gfni")
 #pragma clang attribute push(__attribute__((target("avx,avx512f,avx512vl,avx512bw,avx512vbmi,bmi,bmi2,gfni"))), \
                              apply_to = function)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // GCC 12 intrinsics pass self-initialized `_mm*_undefined_*`
+#endif
 
 SZ_PUBLIC sz_cptr_t sz_find_charset_avx512(sz_cptr_t text, sz_size_t length, sz_charset_t const *filter) {
 
@@ -4785,6 +7479,10 @@ SZ_INTERNAL sz_ssize_t sz_alignment_score_avx512( //
         return sz_alignment_score_serial(shorter, shorter_length, longer, longer_length, subs, gap, alloc);
 }
 
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 #pragma clang attribute pop
 #pragma GCC pop_options
 #endif
@@ -5027,6 +7725,66 @@ SZ_PUBLIC sz_cptr_t sz_rfind_charset_neon(sz_cptr_t h, sz_size_t h_length, sz_ch
     return sz_rfind_charset_serial(h, h_length, set);
 }
 
+SZ_PUBLIC void sz_hash_tape_neon(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
+
+    uint64x2_t prime_vec = vdupq_n_u64(SZ_U64_MAX_PRIME);
+    uint64x2_t shift_high_vec = vdupq_n_u64(77ull);
+    uint64x2_t byte_mask_vec = vdupq_n_u64(0xFFull);
+
+    // Every one of the 2 lanes is hashing a different string, interleaving their dependency chains.
+    // NEON has no 64-bit multiplication, but the bases are small enough to be replaced with shifts.
+    sz_u128_vec_t lengths_vec, words_vec, hash_low_vec, hash_high_vec;
+    uint64x2_t active_vec, chars_low_vec, chars_high_vec, new_low_vec, new_high_vec;
+    for (; count >= 2; offsets += 2, hashes += 2, count -= 2) {
+        sz_cptr_t texts[2] = {start + offsets[0], start + offsets[1]};
+        lengths_vec.u64s[0] = offsets[1] - offsets[0];
+        lengths_vec.u64s[1] = offsets[2] - offsets[1];
+        sz_size_t const max_length = sz_max_of_two(lengths_vec.u64s[0], lengths_vec.u64s[1]);
+        hash_low_vec.u64x2 = vdupq_n_u64(0);
+        hash_high_vec.u64x2 = vdupq_n_u64(0);
+
+        for (sz_size_t progress = 0; progress < max_length; progress += 8) {
+            // Fetch the next 8-byte word of every string, assembling the tails byte-by-byte.
+            for (int lane = 0; lane != 2; ++lane) {
+                sz_size_t remaining = lengths_vec.u64s[lane] > progress ? lengths_vec.u64s[lane] - progress : 0;
+                if (remaining >= 8) { words_vec.u64s[lane] = sz_u64_load(texts[lane] + progress).u64; }
+                else {
+                    sz_u8_t const *tail = (sz_u8_t const *)texts[lane] + progress;
+                    sz_u64_t word = 0;
+                    for (; remaining; --remaining) word = (word << 8) | tail[remaining - 1];
+                    words_vec.u64s[lane] = word;
+                }
+            }
+
+            // Consume the 8 bytes one at a time, only updating the lanes that haven't reached their end.
+            for (sz_size_t byte = 0; byte != 8; ++byte) {
+                active_vec = vcgtq_u64(lengths_vec.u64x2, vdupq_n_u64(progress + byte));
+                chars_low_vec = vandq_u64(words_vec.u64x2, byte_mask_vec);
+                chars_high_vec = vandq_u64(vaddq_u64(chars_low_vec, shift_high_vec), byte_mask_vec);
+                words_vec.u64x2 = vshrq_n_u64(words_vec.u64x2, 8);
+
+                // Multiplying by 31 and 257 is cheaper with shifts: `x * 31 = (x << 5) - x`, `x * 257 = (x << 8) + x`.
+                new_low_vec = vaddq_u64(vsubq_u64(vshlq_n_u64(hash_low_vec.u64x2, 5), hash_low_vec.u64x2), chars_low_vec);
+                new_high_vec =
+                    vaddq_u64(vaddq_u64(vshlq_n_u64(hash_high_vec.u64x2, 8), hash_high_vec.u64x2), chars_high_vec);
+
+                // Compute the modulo by conditionally subtracting the prime, just like `sz_hash_serial`.
+                new_low_vec = vsubq_u64(new_low_vec, vandq_u64(vcgeq_u64(new_low_vec, prime_vec), prime_vec));
+                new_high_vec = vsubq_u64(new_high_vec, vandq_u64(vcgeq_u64(new_high_vec, prime_vec), prime_vec));
+
+                hash_low_vec.u64x2 = vbslq_u64(active_vec, new_low_vec, hash_low_vec.u64x2);
+                hash_high_vec.u64x2 = vbslq_u64(active_vec, new_high_vec, hash_high_vec.u64x2);
+            }
+        }
+
+        // Mix the two hashes, similar to `_sz_hash_mix`.
+        hashes[0] = (hash_low_vec.u64s[0] * 11400714819323198485ull) ^ (hash_high_vec.u64s[0] * 11400714819323198485ull);
+        hashes[1] = (hash_low_vec.u64s[1] * 11400714819323198485ull) ^ (hash_high_vec.u64s[1] * 11400714819323198485ull);
+    }
+
+    sz_hash_tape_serial(start, offsets, count, hashes);
+}
+
 #endif // Arm Neon
 
 #pragma endregion
@@ -5042,21 +7800,101 @@ SZ_PUBLIC void sz_toupper(sz_cptr_t ins, sz_size_t length, sz_ptr_t outs) { sz_t
 SZ_PUBLIC void sz_toascii(sz_cptr_t ins, sz_size_t length, sz_ptr_t outs) { sz_toascii_serial(ins, length, outs); }
 SZ_PUBLIC sz_bool_t sz_isascii(sz_cptr_t ins, sz_size_t length) { return sz_isascii_serial(ins, length); }
 
+SZ_PUBLIC void sz_hashes_with_family(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step,
+                                     sz_hash_family_t family, sz_hash_callback_t callback, void *callback_handle) {
+    switch (family) {
+    case sz_hash_family_mersenne_k:
+        sz_hashes_mersenne(text, length, window_length, window_step, callback, callback_handle);
+        break;
+    default: sz_hashes(text, length, window_length, window_step, callback, callback_handle); break;
+    }
+}
+
 SZ_PUBLIC void sz_hashes_fingerprint(sz_cptr_t start, sz_size_t length, sz_size_t window_length, sz_ptr_t fingerprint,
                                      sz_size_t fingerprint_bytes) {
 
     sz_bool_t fingerprint_length_is_power_of_two = (sz_bool_t)((fingerprint_bytes & (fingerprint_bytes - 1)) == 0);
-    sz_string_view_t fingerprint_buffer = {fingerprint, fingerprint_bytes};
+    sz_u8_t *fingerprint_u8s = (sz_u8_t *)fingerprint;
 
     // There are several issues related to the fingerprinting algorithm.
     // First, the memory traversal order is important.
     // https://blog.stuffedcow.net/2015/08/pagewalk-coherence/
+    // So instead of setting the bits from a callback, we export the hashes into a small on-stack buffer,
+    // keeping the SIMD loop tight, and then scatter the bits in one go.
+    sz_u64_t hashes[256];
+    while (window_length && length >= window_length) {
+        sz_size_t const count =
+            sz_hashes_into(start, length, window_length, 1, sz_hash_family_prime_k, hashes, SZ_NULL, 256);
+        // In most cases the fingerprint length will be a power of two.
+        if (fingerprint_length_is_power_of_two)
+            for (sz_size_t i = 0; i != count; ++i)
+                fingerprint_u8s[(hashes[i] / 8) & (fingerprint_bytes - 1)] |= (1 << (hashes[i] & 7));
+        else
+            for (sz_size_t i = 0; i != count; ++i)
+                fingerprint_u8s[(hashes[i] / 8) % fingerprint_bytes] |= (1 << (hashes[i] & 7));
+        start += count, length -= count;
+    }
+}
 
-    // In most cases the fingerprint length will be a power of two.
-    if (fingerprint_length_is_power_of_two == sz_false_k)
-        sz_hashes(start, length, window_length, 1, _sz_hashes_fingerprint_non_pow2_callback, &fingerprint_buffer);
-    else
-        sz_hashes(start, length, window_length, 1, _sz_hashes_fingerprint_pow2_callback, &fingerprint_buffer);
+SZ_PUBLIC sz_size_t sz_hashes_winnow(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                     sz_size_t winnow_length, sz_hash_family_t family, sz_u64_t *hashes,
+                                     sz_size_t *positions, sz_size_t capacity, sz_memory_allocator_t *alloc) {
+
+    if (!window_length || !winnow_length || !capacity || length < window_length) return 0;
+
+    // If there are fewer windows than the `winnow_length`, we select the minimum of all of them.
+    sz_size_t const windows_count = length - window_length + 1;
+    sz_size_t const winnow = sz_min_of_two(winnow_length, windows_count);
+
+    // The rolling hashes are exported in blocks into a temporary buffer,
+    // keeping the last `winnow - 1` hashes of the previous block in front of it.
+    sz_size_t const block_length = 256;
+    sz_size_t const buffer_length = winnow - 1 + block_length;
+    sz_memory_allocator_t global_alloc;
+    if (!alloc) {
+        sz_memory_allocator_init_default(&global_alloc);
+        alloc = &global_alloc;
+    }
+    sz_u64_t *buffer = (sz_u64_t *)alloc->allocate(buffer_length * sizeof(sz_u64_t), alloc->handle);
+    if (!buffer) return SZ_SIZE_MAX;
+
+    sz_size_t count = 0;
+    sz_size_t buffer_offset = 0, buffer_filled = 0, hashed = 0;
+    sz_size_t min_position = SZ_SIZE_MAX;
+    sz_u64_t min_hash = 0;
+    while (hashed < windows_count && count < capacity) {
+        sz_size_t const added = sz_hashes_into(text + hashed, length - hashed, window_length, 1, family,
+                                               buffer + buffer_filled, SZ_NULL, buffer_length - buffer_filled);
+        buffer_filled += added, hashed += added;
+
+        // Slide over every run of `winnow` hashes, that ends in the newly added part of the buffer.
+        for (sz_size_t last = sz_max_of_two(winnow - 1, hashed - added); last < hashed && count < capacity; ++last) {
+            sz_size_t const first = last + 1 - winnow;
+            // If the previous minimum has left the run, rescan it, preferring the rightmost minimum.
+            if (min_position == SZ_SIZE_MAX || min_position < first) {
+                min_position = first, min_hash = buffer[first - buffer_offset];
+                for (sz_size_t i = first + 1; i <= last; ++i)
+                    if (buffer[i - buffer_offset] <= min_hash) min_position = i, min_hash = buffer[i - buffer_offset];
+            }
+            // Otherwise, only a strictly smaller incoming hash can replace it.
+            else if (buffer[last - buffer_offset] < min_hash)
+                min_position = last, min_hash = buffer[last - buffer_offset];
+            else
+                continue;
+
+            hashes[count] = min_hash;
+            if (positions) positions[count] = min_position;
+            ++count;
+        }
+
+        // Keep the tail of the buffer for the next runs.
+        sz_size_t const kept = winnow - 1;
+        sz_move((sz_ptr_t)buffer, (sz_cptr_t)(buffer + buffer_filled - kept), kept * sizeof(sz_u64_t));
+        buffer_offset += buffer_filled - kept, buffer_filled = kept;
+    }
+
+    alloc->free((sz_ptr_t)buffer, buffer_length * sizeof(sz_u64_t), alloc->handle);
+    return count;
 }
 
 SZ_PUBLIC sz_size_t sz_hamming_distance( //
@@ -5271,6 +8109,29 @@ SZ_DYNAMIC sz_ssize_t sz_alignment_score(sz_cptr_t a, sz_size_t a_length, sz_cpt
 #endif
 }
 
+SZ_DYNAMIC void sz_hashes_mersenne(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step, //
+                                   sz_hash_callback_t callback, void *callback_handle) {
+#if SZ_USE_X86_AVX512
+    sz_hashes_mersenne_avx512(text, length, window_length, window_step, callback, callback_handle);
+#elif SZ_USE_X86_AVX2
+    sz_hashes_mersenne_avx2(text, length, window_length, window_step, callback, callback_handle);
+#else
+    sz_hashes_mersenne_serial(text, length, window_length, window_step, callback, callback_handle);
+#endif
+}
+
+SZ_DYNAMIC void sz_hash_tape(sz_cptr_t start, sz_u32_t const *offsets, sz_size_t count, sz_u64_t *hashes) {
+#if SZ_USE_X86_AVX512
+    sz_hash_tape_avx512(start, offsets, count, hashes);
+#elif SZ_USE_X86_AVX2
+    sz_hash_tape_avx2(start, offsets, count, hashes);
+#elif SZ_USE_ARM_NEON
+    sz_hash_tape_neon(start, offsets, count, hashes);
+#else
+    sz_hash_tape_serial(start, offsets, count, hashes);
+#endif
+}
+
 SZ_DYNAMIC void sz_hashes(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step, //
                           sz_hash_callback_t callback, void *callback_handle) {
 #if SZ_USE_X86_AVX512
@@ -5282,6 +8143,45 @@ SZ_DYNAMIC void sz_hashes(sz_cptr_t text, sz_size_t length, sz_size_t window_len
 #endif
 }
 
+SZ_DYNAMIC sz_size_t sz_hashes_into(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_size_t window_step,
+                                    sz_hash_family_t family, sz_u64_t *hashes, sz_size_t *positions,
+                                    sz_size_t capacity) {
+#if SZ_USE_X86_AVX512
+    return sz_hashes_into_avx512(text, length, window_length, window_step, family, hashes, positions, capacity);
+#elif SZ_USE_X86_AVX2
+    return sz_hashes_into_avx2(text, length, window_length, window_step, family, hashes, positions, capacity);
+#else
+    return sz_hashes_into_serial(text, length, window_length, window_step, family, hashes, positions, capacity);
+#endif
+}
+
+SZ_DYNAMIC void sz_hashes_minhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length, sz_hash_family_t family,
+                                  sz_u64_t *signature, sz_size_t signature_length) {
+#if SZ_USE_X86_AVX512
+    sz_hashes_minhash_avx512(text, length, window_length, family, signature, signature_length);
+#else
+    sz_hashes_minhash_serial(text, length, window_length, family, signature, signature_length);
+#endif
+}
+
+SZ_DYNAMIC sz_u64_t sz_hashes_simhash(sz_cptr_t text, sz_size_t length, sz_size_t window_length,
+                                      sz_hash_family_t family) {
+#if SZ_USE_X86_AVX512
+    return sz_hashes_simhash_avx512(text, length, window_length, family);
+#else
+    return sz_hashes_simhash_serial(text, length, window_length, family);
+#endif
+}
+
+SZ_DYNAMIC void sz_minhash_matches(sz_u64_t const *query, sz_u64_t const *signatures, sz_size_t signatures_count,
+                                   sz_size_t signature_length, sz_size_t *matches) {
+#if SZ_USE_X86_AVX512
+    sz_minhash_matches_avx512(query, signatures, signatures_count, signature_length, matches);
+#else
+    sz_minhash_matches_serial(query, signatures, signatures_count, signature_length, matches);
+#endif
+}
+
 SZ_DYNAMIC sz_cptr_t sz_find_char_from(sz_cptr_t h, sz_size_t h_length, sz_cptr_t n, sz_size_t n_length) {
     sz_charset_t set;
     sz_charset_init(&set);
@@ -45,10 +45,15 @@
 #endif
 
 #if !SZ_AVOID_STL
+#include <algorithm> // `std::make_heap`
 #include <array>
 #include <bitset>
+#include <cstdio> // `std::FILE`, `std::tmpfile`
 #include <string>
 #include <vector>
+#if defined(__linux__)
+#include <fcntl.h> // `posix_fadvise`
+#endif
 #if SZ_DETECT_CPP_17 && __cpp_lib_string_view
 #include <string_view>
 #endif
@@ -3702,6 +3707,38 @@ sz_size_t _call_sequence_member_length(struct sz_sequence_t const *sequence, sz_
     return static_cast<sz_size_t>(member.size());
 }
 
+/**
+ *  @brief  Computes the permutation of an array, that would place its @p partial_order_length smallest
+ *          elements in the head in sorted order, like `std::partial_sort`. The rest follow in arbitrary order.
+ *          The elements of the array must be convertible to a `string_view` with the given extractor.
+ *
+ *  @param[in] begin                The pointer to the first element of the array.
+ *  @param[in] end                  The pointer to the element after the last element of the array.
+ *  @param[out] order               The pointer to the output array of indices, populated with the permutation.
+ *  @param[in] partial_order_length The number of smallest elements to sort.
+ *  @param[in] extractor            The function object that extracts the string from the object.
+ *
+ *  @see    sz_sort_partial
+ */
+template <typename objects_type_, typename string_extractor_>
+void partial_sorted_order(objects_type_ const *begin, objects_type_ const *end, sorted_idx_t *order,
+                          std::size_t partial_order_length, string_extractor_ &&extractor) noexcept {
+
+    // Pack the arguments into a single structure to reference it from the callback.
+    _sequence_args<objects_type_, string_extractor_> args = {begin, static_cast<std::size_t>(end - begin), order,
+                                                             std::forward<string_extractor_>(extractor)};
+    // Populate the array with `iota`-style order.
+    for (std::size_t i = 0; i != args.count; ++i) order[i] = static_cast<sorted_idx_t>(i);
+
+    sz_sequence_t array;
+    array.order = reinterpret_cast<sorted_idx_t *>(order);
+    array.count = args.count;
+    array.handle = &args;
+    array.get_start = _call_sequence_member_start<objects_type_, string_extractor_>;
+    array.get_length = _call_sequence_member_length<objects_type_, string_extractor_>;
+    sz_sort_partial(&array, partial_order_length);
+}
+
 /**
  *  @brief  Computes the permutation of an array, that would lead to sorted order.
  *          The elements of the array must be convertible to a `string_view` with the given extractor.
@@ -3717,6 +3754,58 @@ sz_size_t _call_sequence_member_length(struct sz_sequence_t const *sequence, sz_
 template <typename objects_type_, typename string_extractor_>
 void sorted_order(objects_type_ const *begin, objects_type_ const *end, sorted_idx_t *order,
                   string_extractor_ &&extractor) noexcept {
+    partial_sorted_order(begin, end, order, static_cast<std::size_t>(end - begin),
+                         std::forward<string_extractor_>(extractor));
+}
+
+/**
+ *  @brief  Computes the permutation of an array, that would lead to sorted order, keeping the equal elements
+ *          in their original relative order, like `std::stable_sort`. Useful for multi-column sorting.
+ *          The elements of the array must be convertible to a `string_view` with the given extractor.
+ *
+ *  @param[in] begin       The pointer to the first element of the array.
+ *  @param[in] end         The pointer to the element after the last element of the array.
+ *  @param[out] order      The pointer to the output array of indices, that will be populated with the permutation.
+ *  @param[in] extractor   The function object that extracts the string from the object.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ *
+ *  @see    sz_sort_stable
+ */
+template <typename objects_type_, typename string_extractor_>
+void stable_sorted_order(objects_type_ const *begin, objects_type_ const *end, sorted_idx_t *order,
+                         string_extractor_ &&extractor) noexcept(false) {
+
+    // Pack the arguments into a single structure to reference it from the callback.
+    _sequence_args<objects_type_, string_extractor_> args = {begin, static_cast<std::size_t>(end - begin), order,
+                                                             std::forward<string_extractor_>(extractor)};
+    // Populate the array with `iota`-style order, which the equal elements will preserve.
+    for (std::size_t i = 0; i != args.count; ++i) order[i] = static_cast<sorted_idx_t>(i);
+
+    sz_sequence_t array;
+    array.order = reinterpret_cast<sorted_idx_t *>(order);
+    array.count = args.count;
+    array.handle = &args;
+    array.get_start = _call_sequence_member_start<objects_type_, string_extractor_>;
+    array.get_length = _call_sequence_member_length<objects_type_, string_extractor_>;
+    if (!sz_sort_stable(&array, nullptr)) throw std::bad_alloc();
+}
+
+/**
+ *  @brief  Computes the permutation of an array, that would lead to sorted order under the given collation,
+ *          like the ASCII case-insensitive or the natural one, without normalizing copies of the strings.
+ *          The elements of the array must be convertible to a `string_view` with the given extractor.
+ *
+ *  @param[in] begin       The pointer to the first element of the array.
+ *  @param[in] end         The pointer to the element after the last element of the array.
+ *  @param[out] order      The pointer to the output array of indices, that will be populated with the permutation.
+ *  @param[in] collation   The collation rules, like a table of byte ranks.
+ *  @param[in] extractor   The function object that extracts the string from the object.
+ *
+ *  @see    sz_sort_collated, sz_collation_ranks_case_fold
+ */
+template <typename objects_type_, typename string_extractor_>
+void collated_sorted_order(objects_type_ const *begin, objects_type_ const *end, sorted_idx_t *order,
+                           sz_collation_t const &collation, string_extractor_ &&extractor) noexcept {
 
     // Pack the arguments into a single structure to reference it from the callback.
     _sequence_args<objects_type_, string_extractor_> args = {begin, static_cast<std::size_t>(end - begin), order,
@@ -3730,9 +3819,171 @@ void sorted_order(objects_type_ const *begin, objects_type_ const *end, sorted_i
     array.handle = &args;
     array.get_start = _call_sequence_member_start<objects_type_, string_extractor_>;
     array.get_length = _call_sequence_member_length<objects_type_, string_extractor_>;
-    sz_sort(&array);
+    sz_sort_collated(&array, &collation);
 }
 
+/**
+ *  @brief  FM-index of a static text, answering substring count and locate queries in time proportional
+ *          to the pattern length. Can be persisted through the `blob` and reopened with `try_view` without
+ *          rebuilding, for example from a memory-mapped file, which must outlive the view.
+ *  @see    sz_fm_index_t
+ */
+template <typename allocator_type_ = std::allocator<char>>
+class basic_fm_index {
+    sz_fm_index_t index_;
+    bool owning_ = false;
+    allocator_type_ allocator_;
+
+  public:
+    using allocator_type = allocator_type_;
+
+    basic_fm_index(allocator_type_ const &allocator = {}) noexcept : allocator_(allocator) {
+        index_.blob = nullptr, index_.blob_length = 0, index_.length = 0;
+    }
+    basic_fm_index(basic_fm_index const &) = delete;
+    basic_fm_index &operator=(basic_fm_index const &) = delete;
+    basic_fm_index(basic_fm_index &&other) noexcept
+        : index_(other.index_), owning_(other.owning_), allocator_(std::move(other.allocator_)) {
+        other.owning_ = false, other.index_.blob = nullptr, other.index_.blob_length = 0;
+    }
+    basic_fm_index &operator=(basic_fm_index &&other) noexcept {
+        std::swap(index_, other.index_);
+        std::swap(owning_, other.owning_);
+        std::swap(allocator_, other.allocator_);
+        return *this;
+    }
+    ~basic_fm_index() noexcept { reset(); }
+
+    /** @brief  Releases the owned index, if any. */
+    void reset() noexcept {
+        if (owning_)
+            _with_alloc(allocator_, [&](sz_memory_allocator_t &alloc) {
+                sz_fm_index_free(&index_, &alloc);
+                return true;
+            });
+        owning_ = false, index_.blob = nullptr, index_.blob_length = 0, index_.length = 0;
+    }
+
+    /**
+     *  @brief  Builds the index of a @p text, that doesn't have to outlive it.
+     *  @return `false` if the memory allocation failed.
+     */
+    bool try_build(string_view text, std::size_t sample_rate = 0) noexcept {
+        reset();
+        owning_ = _with_alloc(allocator_, [&](sz_memory_allocator_t &alloc) {
+            return sz_fm_index_init(&index_, text.data(), text.size(), sample_rate, &alloc) == sz_true_k;
+        });
+        return owning_;
+    }
+
+    /**
+     *  @brief  Builds the index of a @p text, that doesn't have to outlive it.
+     *  @throw  `std::bad_alloc` if the allocation fails.
+     */
+    void build(string_view text, std::size_t sample_rate = 0) noexcept(false) {
+        if (!try_build(text, sample_rate)) throw std::bad_alloc();
+    }
+
+    /**
+     *  @brief  Reuses a serialized index, previously exported with `blob`, without copying it.
+     *  @return `false` if the @p blob is not a valid index.
+     */
+    bool try_view(string_view blob) noexcept {
+        reset();
+        return sz_fm_index_view(&index_, blob.data(), blob.size()) == sz_true_k;
+    }
+
+    /** @brief  Serialized index, that can be persisted and reopened with `try_view`. */
+    string_view blob() const noexcept { return {index_.blob, index_.blob_length}; }
+
+    /** @brief  Number of bytes in the indexed text. */
+    std::size_t size() const noexcept { return index_.length; }
+
+    /** @brief  Counts the potentially overlapping occurrences of the @p pattern. */
+    std::size_t count(string_view pattern) const noexcept {
+        return sz_fm_index_count(&index_, pattern.data(), pattern.size());
+    }
+
+    /**
+     *  @brief  Exports the offsets of up to @p capacity occurrences of the @p pattern, in no particular order.
+     *  @return The number of exported offsets.
+     */
+    std::size_t locate(string_view pattern, std::size_t *positions, std::size_t capacity) const noexcept {
+        static_assert(sizeof(std::size_t) == sizeof(sz_size_t), "Offsets must be pointer-sized.");
+        return sz_fm_index_locate(&index_, pattern.data(), pattern.size(), reinterpret_cast<sz_size_t *>(positions),
+                                  capacity);
+    }
+
+#if !SZ_AVOID_STL
+    /**
+     *  @brief  Exports the offsets of all occurrences of the @p pattern, in no particular order.
+     *  @throw  `std::bad_alloc` if the allocation fails.
+     */
+    std::vector<std::size_t> locate(string_view pattern) const noexcept(false) {
+        std::vector<std::size_t> positions(count(pattern));
+        locate(pattern, positions.data(), positions.size());
+        return positions;
+    }
+#endif
+};
+
+using fm_index = basic_fm_index<>;
+
+/**
+ *  @brief  Non-owning view of a persisted tape of strings, written with `save_tape`, and reopened with `try_view`
+ *          without parsing, for example from a memory-mapped file, which must outlive the view.
+ *  @see    sz_tape_t
+ */
+class tape_view {
+    sz_tape_t tape_;
+
+  public:
+    tape_view() noexcept { reset(); }
+
+    /** @brief  Forgets the viewed blob, becoming empty. */
+    void reset() noexcept {
+        tape_.blob = nullptr, tape_.blob_length = 0, tape_.count = 0, tape_.offset_size = 8;
+        tape_.offsets = nullptr, tape_.data = nullptr;
+    }
+
+    /**
+     *  @brief  Reuses a serialized tape without copying it.
+     *  @param[in] validate  Whether to check all of the offsets in linear time, rather than just the header,
+     *                       which is only safe to skip for trusted blobs.
+     *  @return `false` if the @p blob is not a valid tape, leaving the view empty.
+     */
+    bool try_view(string_view blob, bool validate = true) noexcept {
+        if (sz_tape_view(&tape_, blob.data(), blob.size()) == sz_true_k &&
+            (!validate || sz_tape_validate(&tape_) == sz_true_k))
+            return true;
+        reset();
+        return false;
+    }
+
+    /** @brief  Serialized tape, including the header. */
+    string_view blob() const noexcept { return {tape_.blob, tape_.blob_length}; }
+
+    /** @brief  Number of strings in the tape. */
+    std::size_t size() const noexcept { return tape_.count; }
+    bool empty() const noexcept { return tape_.count == 0; }
+
+    /** @brief  Width of the offsets in bytes, either 4 or 8. */
+    std::size_t offset_size() const noexcept { return tape_.offset_size; }
+
+    string_view operator[](std::size_t i) const noexcept {
+        std::size_t start, end;
+        if (tape_.offset_size == 4) {
+            sz_u32_t const *offsets = reinterpret_cast<sz_u32_t const *>(tape_.offsets);
+            start = offsets[i], end = offsets[i + 1];
+        }
+        else {
+            sz_u64_t const *offsets = reinterpret_cast<sz_u64_t const *>(tape_.offsets);
+            start = static_cast<std::size_t>(offsets[i]), end = static_cast<std::size_t>(offsets[i + 1]);
+        }
+        return {tape_.data + start, end - start};
+    }
+};
+
 #if !SZ_AVOID_STL
 
 /**
@@ -3805,6 +4056,345 @@ std::vector<sorted_idx_t> sorted_order(std::vector<string_like_type_> const &arr
                         [](string_like_type_ const &s) -> string_view { return s; });
 }
 
+/**
+ *  @brief  Computes the permutation of an array, that would lead to sorted order, keeping the equal elements
+ *          in their original relative order.
+ *  @return The array of indices, that will be populated with the permutation.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ */
+template <typename objects_type_, typename string_extractor_>
+std::vector<sorted_idx_t> stable_sorted_order(objects_type_ const *begin, objects_type_ const *end,
+                                              string_extractor_ &&extractor) noexcept(false) {
+    std::vector<sorted_idx_t> order(end - begin);
+    stable_sorted_order(begin, end, order.data(), std::forward<string_extractor_>(extractor));
+    return order;
+}
+
+/**
+ *  @brief  Computes the permutation of an array, that would lead to sorted order, keeping the equal elements
+ *          in their original relative order.
+ *  @return The array of indices, that will be populated with the permutation.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ */
+template <typename string_like_type_>
+std::vector<sorted_idx_t> stable_sorted_order(std::vector<string_like_type_> const &array) noexcept(false) {
+    static_assert(std::is_convertible<string_like_type_, string_view>::value,
+                  "The type must be convertible to string_view.");
+    return stable_sorted_order(array.data(), array.data() + array.size(),
+                               [](string_like_type_ const &s) -> string_view { return s; });
+}
+
+/**
+ *  @brief  Computes the permutation of an array, that would lead to sorted order under the given collation.
+ *  @return The array of indices, that will be populated with the permutation.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ */
+template <typename string_like_type_>
+std::vector<sorted_idx_t> collated_sorted_order(std::vector<string_like_type_> const &array,
+                                                sz_collation_t const &collation) noexcept(false) {
+    static_assert(std::is_convertible<string_like_type_, string_view>::value,
+                  "The type must be convertible to string_view.");
+    std::vector<sorted_idx_t> order(array.size());
+    collated_sorted_order(array.data(), array.data() + array.size(), order.data(), collation,
+                          [](string_like_type_ const &s) -> string_view { return s; });
+    return order;
+}
+
+/**
+ *  @brief  Computes the indices of the @p partial_order_length smallest elements of an array in sorted order.
+ *  @return The array of up to @p partial_order_length indices.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ */
+template <typename objects_type_, typename string_extractor_>
+std::vector<sorted_idx_t> partial_sorted_order(objects_type_ const *begin, objects_type_ const *end,
+                                               std::size_t partial_order_length,
+                                               string_extractor_ &&extractor) noexcept(false) {
+    std::vector<sorted_idx_t> order(end - begin);
+    partial_sorted_order(begin, end, order.data(), partial_order_length, std::forward<string_extractor_>(extractor));
+    if (partial_order_length < order.size()) order.resize(partial_order_length);
+    return order;
+}
+
+/**
+ *  @brief  Computes the indices of the @p partial_order_length smallest elements of an array in sorted order.
+ *  @return The array of up to @p partial_order_length indices.
+ *  @throw  `std::bad_alloc` if the allocation fails.
+ */
+template <typename string_like_type_>
+std::vector<sorted_idx_t> partial_sorted_order(std::vector<string_like_type_> const &array,
+                                               std::size_t partial_order_length) noexcept(false) {
+    static_assert(std::is_convertible<string_like_type_, string_view>::value,
+                  "The type must be convertible to string_view.");
+    return partial_sorted_order(array.data(), array.data() + array.size(), partial_order_length,
+                                [](string_like_type_ const &s) -> string_view { return s; });
+}
+
+/**
+ *  @brief  Configuration of the `external_sort` pipeline.
+ */
+struct external_sort_config {
+    /**
+     *  @brief  Maximum number of bytes of text in a single in-memory run, excluding ~24 bytes per record.
+     *          The buffer starts at the input size, if it's seekable, or at `io_buffer_size`, growing up to this.
+     *          A record longer than this can't be sorted in memory and is reported as an error.
+     */
+    std::size_t memory_limit = 1ull << 30;
+    /** @brief  Size of the read buffer of every run during the merge, and of the output buffer. */
+    std::size_t io_buffer_size = 1ull << 20;
+    /** @brief  Maximum number of runs merged at once, bounding the number of open files. */
+    std::size_t max_merge_width = 256;
+    /** @brief  Character terminating every record, the last record may have none. */
+    char separator = '\n';
+};
+
+/**
+ *  @brief  Sequential reader of separator-terminated records from a run file, used in `external_sort`.
+ *          Reads the file in large blocks, growing the buffer for records longer than it.
+ */
+class _external_sort_reader {
+    std::FILE *file_;
+    std::vector<char> buffer_;
+    std::size_t begin_ = 0, end_ = 0;
+    bool exhausted_ = false;
+
+  public:
+    _external_sort_reader(std::FILE *file, std::size_t buffer_size) noexcept(false)
+        : file_(file), buffer_(buffer_size ? buffer_size : 1) {
+#if defined(POSIX_FADV_SEQUENTIAL)
+        // Let the kernel read ahead more aggressively, as the whole file is consumed in order.
+        posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    /**
+     *  @brief  Fetches the next record without the separator, valid until the following call.
+     *  @return `false` once the file is exhausted.
+     */
+    bool next(string_view &record, char separator) noexcept(false) {
+        while (true) {
+            string_view pending(buffer_.data() + begin_, end_ - begin_);
+            std::size_t position = pending.find(separator);
+            if (position != string_view::npos) {
+                record = pending.substr(0, position);
+                begin_ += position + 1;
+                return true;
+            }
+            if (exhausted_) {
+                if (pending.empty()) return false;
+                record = pending;
+                begin_ = end_;
+                return true;
+            }
+
+            // Move the incomplete record to the front, growing the buffer if it doesn't fit.
+            if (begin_) sz_move(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_, begin_ = 0;
+            if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+            std::size_t read = std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+            if (read == 0) {
+                if (std::ferror(file_)) throw std::runtime_error("Failed to read a sorted run");
+                exhausted_ = true;
+            }
+            end_ += read;
+        }
+    }
+};
+
+/**
+ *  @brief  Writes a record followed by a separator, throwing on I/O errors.
+ */
+inline void _external_sort_write(std::FILE *file, string_view record, char separator) noexcept(false) {
+    if (std::fwrite(record.data(), 1, record.size(), file) != record.size() || std::fputc(separator, file) == EOF)
+        throw std::runtime_error("Failed to write the sorted records");
+}
+
+/**
+ *  @brief  K-way merge of sorted run files into the @p output, using a binary heap of their current records.
+ */
+inline void _external_sort_merge(std::vector<std::FILE *> const &runs, std::FILE *output,
+                                 external_sort_config const &config) noexcept(false) {
+
+    std::vector<_external_sort_reader> readers;
+    readers.reserve(runs.size());
+    for (std::FILE *run : runs) readers.emplace_back(run, config.io_buffer_size);
+
+    // Keep the indices of readers in a min-heap, ordered by their current records.
+    std::vector<string_view> heads(runs.size());
+    std::vector<std::size_t> heap;
+    auto is_greater = [&](std::size_t a, std::size_t b) { return heads[b] < heads[a]; };
+    for (std::size_t i = 0; i != readers.size(); ++i)
+        if (readers[i].next(heads[i], config.separator)) heap.push_back(i);
+    std::make_heap(heap.begin(), heap.end(), is_greater);
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), is_greater);
+        std::size_t top = heap.back();
+        _external_sort_write(output, heads[top], config.separator);
+        if (readers[top].next(heads[top], config.separator)) std::push_heap(heap.begin(), heap.end(), is_greater);
+        else heap.pop_back();
+    }
+}
+
+/**
+ *  @brief  Picks the initial size of the run buffer: the remaining @p input size, if the stream is seekable,
+ *          or the I/O buffer size otherwise, never exceeding the memory limit.
+ */
+inline std::size_t _external_sort_initial_block(std::FILE *input, external_sort_config const &config) noexcept(false) {
+    std::size_t const limit = config.memory_limit ? config.memory_limit : 1;
+    std::size_t size = config.io_buffer_size ? config.io_buffer_size : 1;
+    long const position = std::ftell(input);
+    if (position >= 0 && std::fseek(input, 0, SEEK_END) == 0) {
+        long const end = std::ftell(input);
+        if (std::fseek(input, position, SEEK_SET) != 0) throw std::runtime_error("Failed to rewind the input");
+        // One more byte lets the first read detect the end of the input, without growing the buffer.
+        if (end >= position) size = static_cast<std::size_t>(end - position) + 1;
+    }
+    return size < limit ? size : limit;
+}
+
+/**
+ *  @brief  External-memory sort of separator-delimited records, for inputs larger than the RAM.
+ *          Splits the @p input into runs of at most `config.memory_limit` bytes, sorts each with `sz_sort`,
+ *          spills them to anonymous temporary files, and merges them with large sequential reads,
+ *          in multiple passes if there are more than `config.max_merge_width` runs.
+ *          Every output record is terminated with the separator.
+ *
+ *  @param input    Readable stream, like `stdin`.
+ *  @param output   Writable stream, like `stdout`.
+ *  @param config   Memory limits and the separator.
+ *  @throw  `std::runtime_error` on I/O errors or records longer than the memory limit,
+ *          and `std::bad_alloc` if the memory allocation fails.
+ *  @see    sorted_order, sz_sort
+ */
+inline void external_sort(std::FILE *input, std::FILE *output,
+                          external_sort_config const &config = {}) noexcept(false) {
+
+    char const separator = config.separator;
+    std::size_t const merge_width = config.max_merge_width > 2 ? config.max_merge_width : 2;
+    std::vector<std::FILE *> runs, merged;
+    auto close_all = [&]() {
+        for (std::FILE *&run : runs)
+            if (run) std::fclose(run), run = nullptr;
+        for (std::FILE *&run : merged)
+            if (run) std::fclose(run), run = nullptr;
+    };
+    auto create_run = [&]() {
+        std::FILE *run = std::tmpfile();
+        if (!run) throw std::runtime_error("Failed to create a temporary file");
+        if (config.io_buffer_size) std::setvbuf(run, nullptr, _IOFBF, config.io_buffer_size);
+        return run;
+    };
+
+    try {
+        // Split the input into runs, carrying over the incomplete last record of every block.
+        // The block starts small and doubles, until it holds the whole input or reaches the memory limit.
+        std::size_t const memory_limit = config.memory_limit ? config.memory_limit : 1;
+        std::vector<char> block(_external_sort_initial_block(input, config));
+        std::vector<string_view> records;
+        std::size_t filled = 0;
+        bool exhausted = false;
+        while (!exhausted) {
+            std::size_t read = std::fread(block.data() + filled, 1, block.size() - filled, input);
+            if (read == 0 && std::ferror(input)) throw std::runtime_error("Failed to read the input");
+            filled += read;
+            exhausted = filled != block.size();
+            if (!exhausted && block.size() < memory_limit) {
+                block.resize(block.size() > memory_limit / 2 ? memory_limit : block.size() * 2);
+                continue;
+            }
+
+            // Find the end of the last complete record, which a full block must contain.
+            string_view text(block.data(), filled);
+            std::size_t last_separator = text.rfind(separator);
+            std::size_t complete = exhausted                             ? filled
+                                   : last_separator == string_view::npos ? 0
+                                                                         : last_separator + 1;
+            if (!exhausted && complete == 0) throw std::runtime_error("A record is longer than the memory limit");
+
+            records.clear();
+            for (string_view tail = text.substr(0, complete); !tail.empty();) {
+                std::size_t position = tail.find(separator);
+                if (position == string_view::npos) position = tail.size();
+                records.push_back(tail.substr(0, position));
+                tail = tail.substr(position + (position != tail.size()));
+            }
+            std::vector<sorted_idx_t> order = sorted_order(records);
+
+            // A single run, that fits into memory entirely, doesn't need a temporary file.
+            bool const is_single_run = exhausted && runs.empty();
+            std::FILE *run = is_single_run ? output : create_run();
+            if (!is_single_run) runs.push_back(run);
+            for (sorted_idx_t i : order) _external_sort_write(run, records[i], separator);
+            if (is_single_run) return;
+            if (std::fflush(run) != 0) throw std::runtime_error("Failed to spill a sorted run");
+
+            sz_move(block.data(), block.data() + complete, filled - complete);
+            filled -= complete;
+        }
+
+        // Merge the runs in passes, each reducing their number `merge_width` times, until one is left.
+        while (runs.size() > merge_width) {
+            for (std::size_t first = 0; first < runs.size(); first += merge_width) {
+                std::FILE *destination = create_run();
+                merged.push_back(destination);
+                std::size_t last = first + merge_width < runs.size() ? first + merge_width : runs.size();
+                std::vector<std::FILE *> group(runs.begin() + first, runs.begin() + last);
+                for (std::FILE *run : group) std::rewind(run);
+                _external_sort_merge(group, destination, config);
+                if (std::fflush(destination) != 0) throw std::runtime_error("Failed to spill a merged run");
+                for (std::size_t i = first; i != last; ++i) std::fclose(runs[i]), runs[i] = nullptr;
+            }
+            runs.swap(merged);
+            merged.clear();
+        }
+        for (std::FILE *run : runs) std::rewind(run);
+        _external_sort_merge(runs, output, config);
+        close_all();
+    }
+    catch (...) {
+        close_all();
+        throw;
+    }
+}
+
+/**
+ *  @brief  Writes an array of strings into a @p file, in the layout of `sz_tape_t`, that can be memory-mapped
+ *          and reopened with `tape_view::try_view`. Uses 32-bit offsets, unless the strings exceed 4 GB.
+ *          The elements of the array must be convertible to a `string_view` with the given extractor,
+ *          which must not throw, as it's called from the C serializer.
+ *  @return `false` if writing to the @p file failed.
+ */
+template <typename objects_type_, typename string_extractor_>
+bool try_save_tape(std::FILE *file, objects_type_ const *begin, objects_type_ const *end,
+                   string_extractor_ &&extractor) noexcept {
+    // Pack the arguments into a single structure to reference it from the callback.
+    _sequence_args<objects_type_, string_extractor_> args = {begin, static_cast<std::size_t>(end - begin), nullptr,
+                                                             std::forward<string_extractor_>(extractor)};
+    sz_sequence_t array;
+    array.order = nullptr;
+    array.count = args.count;
+    array.handle = &args;
+    array.get_start = _call_sequence_member_start<objects_type_, string_extractor_>;
+    array.get_length = _call_sequence_member_length<objects_type_, string_extractor_>;
+    sz_tape_write_t write = [](sz_cptr_t data, sz_size_t length, void *user) -> sz_bool_t {
+        return static_cast<sz_bool_t>(std::fwrite(data, 1, length, static_cast<std::FILE *>(user)) == length);
+    };
+    if (!sz_tape_write(&array, write, file)) return false;
+    return std::fflush(file) == 0;
+}
+
+/**
+ *  @brief  Writes an array of strings into a @p file, in the layout of `sz_tape_t`.
+ *  @throw  `std::runtime_error` if writing to the @p file failed.
+ */
+template <typename string_like_type_>
+void save_tape(std::FILE *file, std::vector<string_like_type_> const &array) noexcept(false) {
+    static_assert(std::is_convertible<string_like_type_, string_view>::value,
+                  "The type must be convertible to string_view.");
+    if (!try_save_tape(file, array.data(), array.data() + array.size(),
+                       [](string_like_type_ const &s) -> string_view { return s; }))
+        throw std::runtime_error("Failed to write the tape of strings");
+}
 #endif
 
 } // namespace stringzilla
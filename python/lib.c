@@ -9,6 +9,10 @@
  *  - Doesn't use PyBind11, NanoBind, Boost.Python, or any other high-level libs, only CPython API.
  *  - To minimize latency this implementation avoids `PyArg_ParseTupleAndKeywords` calls.
  */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE 1 // `madvise`, `MAP_POPULATE`, and `MADV_HUGEPAGE`, hidden in the strict C99 mode
+#endif
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 #define NOMINMAX
 #include <windows.h>
@@ -23,8 +27,9 @@
 #include <BaseTsd.h>
 typedef SSIZE_T ssize_t;
 #else
-#include <limits.h> // `SSIZE_MAX`
-#include <unistd.h> // `ssize_t`
+#include <limits.h>  // `SSIZE_MAX`
+#include <pthread.h> // `pthread_create`
+#include <unistd.h>  // `ssize_t`, `sysconf`
 #endif
 
 // It seems like some Python versions forget to include a header, so we should:
@@ -40,13 +45,71 @@ typedef SSIZE_T ssize_t;
 
 #include <stringzilla/stringzilla.h>
 
+/**
+ *  On free-threaded CPython builds, without the GIL, the mutable `Strs` containers are guarded by per-object
+ *  critical sections. On older versions, those are no-ops, as the GIL already serializes all method calls.
+ */
+#if PY_VERSION_HEX >= 0x030D0000
+#define SZ_BEGIN_CRITICAL_SECTION(object) Py_BEGIN_CRITICAL_SECTION(object)
+#define SZ_END_CRITICAL_SECTION() Py_END_CRITICAL_SECTION()
+#else
+#define SZ_BEGIN_CRITICAL_SECTION(object) {
+#define SZ_END_CRITICAL_SECTION() }
+#endif
+
+/**
+ *  Apache Arrow C Data Interface structures, defined exactly as in the specification, to avoid a dependency.
+ *  https://arrow.apache.org/docs/format/CDataInterface.html
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
 #pragma region Forward Declarations
 
 static PyTypeObject FileType;
 static PyTypeObject StrType;
 static PyTypeObject StrsType;
+static PyTypeObject SplitIteratorType;
 
-static sz_string_view_t temporary_memory = {NULL, 0};
 
 /**
  *  @brief  Describes an on-disk file mapped into RAM, which is different from Python's
@@ -62,6 +125,7 @@ typedef struct {
 #endif
     sz_cptr_t start;
     sz_size_t length;
+    int is_writable;
 } File;
 
 /**
@@ -135,6 +199,8 @@ typedef struct {
         /**
          *  Once you sort, shuffle, or reorganize slices making up a larger string, this structure
          *  cn be used for space-efficient lookups.
+         *  The `STRS_MULTI_SOURCE` layout reuses it for strings referenced in many independent objects,
+         *  in which case the `parent` is a tuple of all of those objects, keeping them alive.
          */
         struct reordered_slices_t {
             size_t count;
@@ -144,27 +210,187 @@ typedef struct {
 
     } data;
 
+    /**
+     *  Open-addressing hash table, mapping strings to the index of their first occurrence, for membership tests.
+     *  It's built lazily on the first lookup, and dropped whenever the collection is reordered.
+     *  Every slot contains the `sz_hash` of a string and its index plus one, or zeros, if the slot is empty.
+     */
+    struct strs_lookup_t {
+        size_t capacity;
+        sz_u64_t *slots;
+    } lookup;
+
+    /**
+     *  Set when the `end_offsets` of a consecutive layout are borrowed from the memory of the `parent`,
+     *  like a file mapped by `Strs.load`, rather than allocated for this object, and mustn't be freed.
+     */
+    sz_bool_t borrows_offsets;
+
 } Strs;
 
+/**
+ *  @brief  Lazy iterator over the parts of a string-like `parent`, split by a separator, that yields `Strs`
+ *          batches of up to `batch_size` consecutive parts. Only the offsets of a single batch are allocated
+ *          at a time, so the memory usage doesn't grow with the size of the `parent`, like a mapped `File`.
+ */
+typedef struct {
+    PyObject_HEAD //
+        PyObject *parent;
+    sz_string_view_t text;
+    PyObject *separator_parent;
+    sz_string_view_t separator;
+    int keepseparator;
+    size_t batch_size;
+    size_t offset;    // Where the first part of the next batch starts in the `text`.
+    int is_finished;  // Set once the last part was yielded.
+    int is_running;   // Set while a batch is being produced without the GIL.
+} SplitIterator;
+
 #pragma endregion
 
 #pragma region Helpers
 
+/**
+ *  @brief  Keyword argument names, interned once at module initialization. The `METH_FASTCALL` methods
+ *          receive the names of keyword arguments in a tuple, and the names spelled out at the call site
+ *          are interned by the compiler, so a pointer comparison is usually enough to match them.
+ */
+static struct {
+    PyObject *start;
+    PyObject *end;
+    PyObject *allowoverlap;
+    PyObject *threads;
+    PyObject *bound;
+} interned_keywords = {NULL, NULL, NULL, NULL, NULL};
+
+static int keyword_is(PyObject *key, PyObject *interned) {
+    return key == interned || PyUnicode_Compare(key, interned) == 0;
+}
+
+/**
+ *  @brief  Releasing and re-acquiring the GIL takes a few hundred nanoseconds, so it's only done when an
+ *          operation is expected to touch at least this many bytes, or matrix cells for edit distances.
+ */
+#define SZ_GIL_RELEASE_THRESHOLD (1024 * 1024)
+
+/**
+ *  @brief  Lets other Python threads run while a long operation is in progress. Safe only for operations,
+ *          that don't touch any Python objects, and read from immutable inputs: `str`, `bytes`, `Str`, `File`.
+ *          Errors must be raised after the GIL is re-acquired with `acquire_gil`.
+ *  @return The state to pass into `acquire_gil`, or NULL, if the work is too small and the GIL was kept.
+ */
+static PyThreadState *release_gil_for(sz_size_t work) {
+    return work >= SZ_GIL_RELEASE_THRESHOLD ? PyEval_SaveThread() : NULL;
+}
+
+static void acquire_gil(PyThreadState *state) {
+    if (state) PyEval_RestoreThread(state);
+}
+
+/**
+ *  @brief  Scratch space for the dynamic-programming matrices of edit distances and alignment scores.
+ *          Kept per-thread, so that concurrent calls, running with the GIL released, don't share it.
+ *          Every buffer is freed by the thread-local storage destructor, when its thread exits.
+ */
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+static DWORD temporary_memory_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t temporary_memory_key;
+static int temporary_memory_key_created = 0;
+#endif
+
+static void temporary_memory_release(void *memory) {
+    sz_string_view_t *existing = (sz_string_view_t *)memory;
+    if (!existing) return;
+    free((void *)existing->start);
+    free(existing);
+}
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+static void WINAPI temporary_memory_release_callback(PVOID memory) { temporary_memory_release(memory); }
+#endif
+
+static int temporary_memory_key_create(void) {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    temporary_memory_key = FlsAlloc(&temporary_memory_release_callback);
+    return temporary_memory_key != FLS_OUT_OF_INDEXES;
+#else
+    temporary_memory_key_created = pthread_key_create(&temporary_memory_key, &temporary_memory_release) == 0;
+    return temporary_memory_key_created;
+#endif
+}
+
+static void temporary_memory_key_delete(void) {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    if (temporary_memory_key == FLS_OUT_OF_INDEXES) return;
+    FlsFree(temporary_memory_key); // Also invokes the callback for the current thread
+    temporary_memory_key = FLS_OUT_OF_INDEXES;
+#else
+    if (!temporary_memory_key_created) return;
+    // Destructors don't run on key deletion, so the current thread's buffer is freed manually
+    temporary_memory_release(pthread_getspecific(temporary_memory_key));
+    pthread_key_delete(temporary_memory_key);
+    temporary_memory_key_created = 0;
+#endif
+}
+
+/**
+ *  @brief  Returns the calling thread's scratch space, creating an empty one on first use.
+ *  @return NULL if the memory allocation failed.
+ */
+static sz_string_view_t *temporary_memory_for_thread(void) {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    sz_string_view_t *existing = (sz_string_view_t *)FlsGetValue(temporary_memory_key);
+    if (existing) return existing;
+    existing = (sz_string_view_t *)calloc(1, sizeof(sz_string_view_t));
+    if (existing && !FlsSetValue(temporary_memory_key, existing)) free(existing), existing = NULL;
+#else
+    sz_string_view_t *existing = (sz_string_view_t *)pthread_getspecific(temporary_memory_key);
+    if (existing) return existing;
+    existing = (sz_string_view_t *)calloc(1, sizeof(sz_string_view_t));
+    if (existing && pthread_setspecific(temporary_memory_key, existing) != 0) free(existing), existing = NULL;
+#endif
+    return existing;
+}
+
+/**
+ *  @brief  Grows the scratch space, if needed. May be called without holding the GIL,
+ *          so it doesn't raise, and the caller is responsible for reporting the failure.
+ */
 static sz_ptr_t temporary_memory_allocate(sz_size_t size, sz_string_view_t *existing) {
     if (existing->length < size) {
-        sz_cptr_t new_start = realloc(existing->start, size);
-        if (!new_start) {
-            PyErr_Format(PyExc_MemoryError, "Unable to allocate memory for the Levenshtein matrix");
-            return NULL;
-        }
+        sz_cptr_t new_start = realloc((void *)existing->start, size);
+        if (!new_start) return NULL;
         existing->start = new_start;
         existing->length = size;
     }
-    return existing->start;
+    return (sz_ptr_t)existing->start;
 }
 
 static void temporary_memory_free(sz_ptr_t start, sz_size_t size, sz_string_view_t *existing) {}
 
+static sz_cptr_t consecutive_32bit_get_start(sz_sequence_t const *seq, sz_size_t i) {
+    struct consecutive_slices_32bit_t const *slices = (struct consecutive_slices_32bit_t const *)seq->handle;
+    return slices->start + (i ? slices->end_offsets[i - 1] : 0);
+}
+
+static sz_size_t consecutive_32bit_get_length(sz_sequence_t const *seq, sz_size_t i) {
+    struct consecutive_slices_32bit_t const *slices = (struct consecutive_slices_32bit_t const *)seq->handle;
+    uint32_t start_offset = i ? slices->end_offsets[i - 1] : 0;
+    return slices->end_offsets[i] - start_offset - slices->separator_length * (i + 1 != slices->count);
+}
+
+static sz_cptr_t consecutive_64bit_get_start(sz_sequence_t const *seq, sz_size_t i) {
+    struct consecutive_slices_64bit_t const *slices = (struct consecutive_slices_64bit_t const *)seq->handle;
+    return slices->start + (i ? slices->end_offsets[i - 1] : 0);
+}
+
+static sz_size_t consecutive_64bit_get_length(sz_sequence_t const *seq, sz_size_t i) {
+    struct consecutive_slices_64bit_t const *slices = (struct consecutive_slices_64bit_t const *)seq->handle;
+    uint64_t start_offset = i ? slices->end_offsets[i - 1] : 0;
+    return slices->end_offsets[i] - start_offset - slices->separator_length * (i + 1 != slices->count);
+}
+
 static sz_cptr_t parts_get_start(sz_sequence_t *seq, sz_size_t i) {
     return ((sz_string_view_t const *)seq->handle)[i].start;
 }
@@ -208,11 +434,162 @@ void apply_order(sz_string_view_t *array, sz_sorted_idx_t *order, size_t length)
     }
 }
 
+static sz_bool_t sequence_is_less(sz_sequence_t const *sequence, sz_size_t i, sz_size_t j) {
+    return sz_order(sequence->get_start(sequence, i), sequence->get_length(sequence, i),
+                    sequence->get_start(sequence, j), sequence->get_length(sequence, j)) == sz_less_k;
+}
+
+/**
+ *  @brief  Returns the number of logical cores available to the process, used for `threads=0` arguments.
+ */
+static size_t hardware_concurrency(void) {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (size_t)cores : 1;
+#endif
+}
+
+/**
+ *  @brief  Callback for `parallel_for`, processing one of the chunks of a job, identified by its index.
+ */
+typedef void (*parallel_chunk_t)(void *handle, size_t chunk);
+
+typedef struct {
+    parallel_chunk_t callback;
+    void *handle;
+    size_t chunk;
+    sz_bool_t is_spawned;
+} parallel_task_t;
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+static DWORD WINAPI parallel_task_thread(LPVOID task_ptr) {
+    parallel_task_t *task = (parallel_task_t *)task_ptr;
+    task->callback(task->handle, task->chunk);
+    return 0;
+}
+#else
+static void *parallel_task_thread(void *task_ptr) {
+    parallel_task_t *task = (parallel_task_t *)task_ptr;
+    task->callback(task->handle, task->chunk);
+    return NULL;
+}
+#endif
+
+/**
+ *  @brief  Calls the `callback` for every one of the `threads` chunks of a job. The calling thread takes the
+ *          first chunk, and the others run in new threads, falling back to the calling one, if spawning fails.
+ *          Doesn't touch any Python objects, so can be called without holding the GIL.
+ *  @return Whether the memory for the threads was allocated. Otherwise, none of the chunks are processed.
+ */
+static sz_bool_t parallel_for(parallel_chunk_t callback, void *handle, size_t threads) {
+    if (threads <= 1) {
+        callback(handle, 0);
+        return 1;
+    }
+
+    parallel_task_t *tasks = (parallel_task_t *)malloc(threads * sizeof(parallel_task_t));
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    HANDLE *handles = (HANDLE *)malloc(threads * sizeof(HANDLE));
+#else
+    pthread_t *handles = (pthread_t *)malloc(threads * sizeof(pthread_t));
+#endif
+    sz_bool_t success = tasks && handles;
+    if (success) {
+        for (size_t i = 1; i != threads; ++i) {
+            tasks[i].callback = callback, tasks[i].handle = handle, tasks[i].chunk = i;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+            handles[i] = CreateThread(NULL, 0, parallel_task_thread, &tasks[i], 0, NULL);
+            tasks[i].is_spawned = handles[i] != NULL;
+#else
+            tasks[i].is_spawned = pthread_create(&handles[i], NULL, parallel_task_thread, &tasks[i]) == 0;
+#endif
+        }
+        callback(handle, 0);
+        for (size_t i = 1; i != threads; ++i) {
+            if (!tasks[i].is_spawned) {
+                callback(handle, i);
+                continue;
+            }
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+            WaitForSingleObject(handles[i], INFINITE);
+            CloseHandle(handles[i]);
+#else
+            pthread_join(handles[i], NULL);
+#endif
+        }
+    }
+
+    free(tasks);
+    free(handles);
+    return success;
+}
+
+typedef struct {
+    sz_sequence_t sequence;
+    sz_size_t partial_order_length;
+} sort_chunk_t;
+
+static void sort_chunk(void *chunks, size_t chunk) {
+    sort_chunk_t *sorted = (sort_chunk_t *)chunks + chunk;
+    if (sorted->partial_order_length < sorted->sequence.count)
+        sz_sort_partial(&sorted->sequence, sorted->partial_order_length);
+    else
+        sz_sort(&sorted->sequence);
+}
+
+/**
+ *  @brief  Sorts the `order` of a sequence, similar to `sz_sort_partial`. With more than one thread,
+ *          sorts equal chunks of it concurrently and combines them with a k-way merge.
+ *          Doesn't touch any Python objects, so can be called without holding the GIL.
+ *  @return Whether the sort succeeded, or failed to allocate memory for the merge.
+ */
+static sz_bool_t sort_sequence(sz_sequence_t *sequence, sz_size_t partial_order_length, size_t threads) {
+    // Small inputs aren't worth the overhead of spawning threads.
+    size_t const min_chunk_length = 16384;
+    if (threads > sequence->count / min_chunk_length) threads = sequence->count / min_chunk_length;
+    if (threads <= 1) {
+        sort_chunk_t chunk = {*sequence, partial_order_length};
+        sort_chunk(&chunk, 0);
+        return 1;
+    }
+
+    sort_chunk_t *chunks = (sort_chunk_t *)malloc(threads * sizeof(sort_chunk_t));
+    sz_size_t *offsets = (sz_size_t *)malloc((threads + 1) * sizeof(sz_size_t));
+    sz_sorted_idx_t *merged = (sz_sorted_idx_t *)malloc(sequence->count * sizeof(sz_sorted_idx_t));
+    sz_bool_t success = chunks && offsets && merged;
+    if (success) {
+        for (size_t i = 0; i <= threads; ++i) offsets[i] = sequence->count * i / threads;
+        for (size_t i = 0; i != threads; ++i) {
+            chunks[i].sequence = *sequence;
+            chunks[i].sequence.order += offsets[i];
+            chunks[i].sequence.count = offsets[i + 1] - offsets[i];
+            chunks[i].partial_order_length = partial_order_length;
+        }
+        success = parallel_for(sort_chunk, chunks, threads);
+    }
+
+    // The merge only needs the heads of the chunks to be sorted, to produce a sorted head of the output.
+    if (success) {
+        success = sz_merge_many(sequence, offsets, threads, (sz_sequence_comparator_t)sequence_is_less, merged, NULL);
+        if (success) memcpy(sequence->order, merged, sequence->count * sizeof(sz_sorted_idx_t));
+    }
+
+    free(chunks);
+    free(offsets);
+    free(merged);
+    return success;
+}
+
 sz_bool_t export_string_like(PyObject *object, sz_cptr_t **start, sz_size_t *length) {
     if (PyUnicode_Check(object)) {
         // Handle Python str
         Py_ssize_t signed_length;
         *start = PyUnicode_AsUTF8AndSize(object, &signed_length);
+        if (*start == NULL) return 0; // Not representable in UTF-8, like lone surrogates
         *length = (size_t)signed_length;
         return 1;
     }
@@ -233,7 +610,9 @@ sz_bool_t export_string_like(PyObject *object, sz_cptr_t **start, sz_size_t *len
         return 1;
     }
     else if (PyObject_TypeCheck(object, &FileType)) {
+        // Strings and their hash indexes assume the contents never change, so writable mappings are only buffers
         File *file = (File *)object;
+        if (file->is_writable) return 0;
         *start = file->start;
         *length = file->length;
         return 1;
@@ -273,6 +652,7 @@ get_string_at_offset_t str_at_offset_getter(Strs *strs) {
     case STRS_CONSECUTIVE_32: return str_at_offset_consecutive_32bit;
     case STRS_CONSECUTIVE_64: return str_at_offset_consecutive_64bit;
     case STRS_REORDERED: return str_at_offset_reordered;
+    case STRS_MULTI_SOURCE: return str_at_offset_reordered;
     default:
         // Unsupported type
         PyErr_SetString(PyExc_TypeError, "Unsupported type for conversion");
@@ -280,6 +660,25 @@ get_string_at_offset_t str_at_offset_getter(Strs *strs) {
     }
 }
 
+/**
+ *  @brief  Outputs the offsets or slices buffer and the owning reference to the parent of a `Strs`,
+ *          for the caller to release, once the layout is replaced. Borrowed offsets are output as NULL.
+ */
+static void strs_layout_detach(Strs *self, void **buffer, PyObject **parent) {
+    switch (self->type) {
+    case STRS_CONSECUTIVE_32:
+        *buffer = self->data.consecutive_32bit.end_offsets, *parent = self->data.consecutive_32bit.parent;
+        break;
+    case STRS_CONSECUTIVE_64:
+        *buffer = self->data.consecutive_64bit.end_offsets, *parent = self->data.consecutive_64bit.parent;
+        break;
+    case STRS_REORDERED:
+    case STRS_MULTI_SOURCE: *buffer = self->data.reordered.parts, *parent = self->data.reordered.parent; break;
+    default: *buffer = NULL, *parent = NULL; break;
+    }
+    if (self->borrows_offsets) *buffer = NULL;
+}
+
 sz_bool_t prepare_strings_for_reordering(Strs *strs) {
 
     // Allocate memory for reordered slices
@@ -326,7 +725,8 @@ sz_bool_t prepare_strings_for_reordering(Strs *strs) {
     }
 
     // Release previous used memory.
-    if (old_buffer) free(old_buffer);
+    if (old_buffer && !strs->borrows_offsets) free(old_buffer);
+    strs->borrows_offsets = 0;
 
     // Update the Strs object
     strs->type = STRS_REORDERED;
@@ -340,8 +740,143 @@ sz_bool_t prepare_strings_for_extension(Strs *strs, size_t new_parents, size_t n
 
 #pragma endregion
 
+#pragma region Split Iterator
+
+/**
+ *  @brief  Default number of parts in every batch of a `SplitIterator`, taking 256 KB for 32-bit offsets,
+ *          while amortizing the cost of creating the `Strs` objects.
+ */
+#define SZ_SPLIT_ITERATOR_BATCH_SIZE (64 * 1024)
+
+/**
+ *  @brief  Creates a `SplitIterator` over the @p text, exported from the @p parent, which is referenced
+ *          together with the @p separator_parent, if it's provided, until the iterator is destroyed.
+ */
+static PyObject *split_iterator_new(PyObject *parent, sz_string_view_t text, PyObject *separator_parent,
+                                    sz_string_view_t separator, int keepseparator, size_t batch_size) {
+    if (!separator.length) {
+        PyErr_SetString(PyExc_ValueError, "The separator can't be empty");
+        return NULL;
+    }
+    if (!batch_size) {
+        PyErr_SetString(PyExc_ValueError, "The batch size must be positive");
+        return NULL;
+    }
+    SplitIterator *result = (SplitIterator *)SplitIteratorType.tp_alloc(&SplitIteratorType, 0);
+    if (!result) return NULL;
+    result->parent = parent;
+    result->text = text;
+    result->separator_parent = separator_parent;
+    result->separator = separator;
+    result->keepseparator = keepseparator;
+    result->batch_size = batch_size;
+    Py_INCREF(parent);
+    Py_XINCREF(separator_parent);
+    return (PyObject *)result;
+}
+
+static void SplitIterator_dealloc(SplitIterator *self) {
+    Py_XDECREF(self->parent);
+    Py_XDECREF(self->separator_parent);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *SplitIterator_next(SplitIterator *self) {
+    // Claim the iterator, as the GIL may be released, while the batch is being produced
+    int is_running, is_finished;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    is_running = self->is_running, is_finished = self->is_finished;
+    if (!is_running && !is_finished) self->is_running = 1;
+    SZ_END_CRITICAL_SECTION();
+    if (is_running) {
+        PyErr_SetString(PyExc_ValueError, "The iterator is already running");
+        return NULL;
+    }
+    if (is_finished) return NULL; // Raises `StopIteration`
+
+    // The batch can't have more parts, than there are bytes remaining, plus one
+    size_t const batch_offset = self->offset;
+    sz_cptr_t const batch_start = self->text.start + batch_offset;
+    size_t const remaining_length = self->text.length - batch_offset;
+    size_t const capacity = self->batch_size < remaining_length + 1 ? self->batch_size : remaining_length + 1;
+    uint64_t *end_offsets = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    Strs *batch = end_offsets ? (Strs *)StrsType.tp_alloc(&StrsType, 0) : NULL;
+    if (!batch) {
+        free(end_offsets);
+        SZ_BEGIN_CRITICAL_SECTION(self);
+        self->is_running = 0;
+        SZ_END_CRITICAL_SECTION();
+        return PyErr_NoMemory();
+    }
+
+    // Find the separators, with `sz_find` dispatching to the SIMD kernels
+    size_t count = 0, next_offset = 0;
+    sz_string_view_t const separator = self->separator;
+    int is_last = 0;
+    PyThreadState *gil_state = release_gil_for(remaining_length);
+    while (count != capacity) {
+        sz_cptr_t match =
+            sz_find(batch_start + next_offset, remaining_length - next_offset, separator.start, separator.length);
+        is_last = match == NULL;
+        next_offset = is_last ? remaining_length : (size_t)(match - batch_start) + separator.length;
+        end_offsets[count++] = next_offset;
+        if (is_last) break;
+    }
+    acquire_gil(gil_state);
+
+    // Only the last part of a `Strs` is stored without the trailing separator, so unless we keep the separators,
+    // the separator after the last part of the batch must be excluded from its window.
+    size_t const separator_length = self->keepseparator ? 0 : separator.length;
+    size_t const window_length = next_offset - (is_last ? 0 : separator_length);
+    end_offsets[count - 1] = window_length;
+
+    // Most windows are under 4 GB, even in larger files, and can be narrowed to 32-bit offsets in-place
+    if (window_length < UINT32_MAX) {
+        uint32_t *narrow_offsets = (uint32_t *)end_offsets;
+        for (size_t i = 0; i != count; ++i) narrow_offsets[i] = (uint32_t)end_offsets[i];
+        batch->type = STRS_CONSECUTIVE_32;
+        batch->data.consecutive_32bit.count = count;
+        batch->data.consecutive_32bit.separator_length = separator_length;
+        batch->data.consecutive_32bit.parent = self->parent;
+        batch->data.consecutive_32bit.start = batch_start;
+        batch->data.consecutive_32bit.end_offsets = narrow_offsets;
+    }
+    else {
+        batch->type = STRS_CONSECUTIVE_64;
+        batch->data.consecutive_64bit.count = count;
+        batch->data.consecutive_64bit.separator_length = separator_length;
+        batch->data.consecutive_64bit.parent = self->parent;
+        batch->data.consecutive_64bit.start = batch_start;
+        batch->data.consecutive_64bit.end_offsets = end_offsets;
+    }
+    Py_INCREF(self->parent);
+
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    self->offset = batch_offset + next_offset;
+    self->is_finished = is_last;
+    self->is_running = 0;
+    SZ_END_CRITICAL_SECTION();
+    return (PyObject *)batch;
+}
+
+static PyTypeObject SplitIteratorType = {
+    PyVarObject_HEAD_INIT(NULL, 0).tp_name = "stringzilla.SplitIterator",
+    .tp_doc = "Lazy iterator over the parts of a string, yielding `Strs` batches of consecutive parts",
+    .tp_basicsize = sizeof(SplitIterator),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)SplitIterator_dealloc,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)SplitIterator_next,
+};
+
+#pragma endregion
+
 #pragma region MemoryMappingFile
 
+#define SZ_METHOD_FLAGS METH_VARARGS | METH_KEYWORDS
+#define SZ_FASTCALL_FLAGS METH_FASTCALL | METH_KEYWORDS
+
 static void File_dealloc(File *self) {
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
     if (self->start) {
@@ -389,18 +924,82 @@ static PyObject *File_new(PyTypeObject *type, PyObject *positional_args, PyObjec
     return (PyObject *)self;
 }
 
+/**
+ *  @brief  Access patterns, that the OS can use to tune the read-ahead and the eviction of the mapped pages.
+ *          Those are just hints, ignored on Windows, and where the OS doesn't support them.
+ */
+typedef enum {
+    file_advice_normal_k,
+    file_advice_sequential_k,
+    file_advice_random_k,
+    file_advice_willneed_k,
+} file_advice_t;
+
+static sz_bool_t file_advice_parse(PyObject *name, file_advice_t *advice) {
+    if (PyUnicode_Check(name)) {
+        if (PyUnicode_CompareWithASCIIString(name, "normal") == 0) { *advice = file_advice_normal_k; }
+        else if (PyUnicode_CompareWithASCIIString(name, "sequential") == 0) { *advice = file_advice_sequential_k; }
+        else if (PyUnicode_CompareWithASCIIString(name, "random") == 0) { *advice = file_advice_random_k; }
+        else if (PyUnicode_CompareWithASCIIString(name, "willneed") == 0) { *advice = file_advice_willneed_k; }
+        else goto unknown_advice;
+        return 1;
+    }
+unknown_advice:
+    PyErr_SetString(PyExc_ValueError, "The advice must be 'normal', 'sequential', 'random', or 'willneed'");
+    return 0;
+}
+
+static void file_advise(File *self, file_advice_t advice) {
+#if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+    if (!self->start) return;
+    int flags = MADV_NORMAL;
+    switch (advice) {
+    case file_advice_sequential_k: flags = MADV_SEQUENTIAL; break;
+    case file_advice_random_k: flags = MADV_RANDOM; break;
+    case file_advice_willneed_k: flags = MADV_WILLNEED; break;
+    default: break;
+    }
+    madvise((void *)self->start, self->length, flags);
+#else
+    sz_unused(self && advice);
+#endif
+}
+
 static int File_init(File *self, PyObject *positional_args, PyObject *named_args) {
     const char *path;
     if (!PyArg_ParseTuple(positional_args, "s", &path)) return -1;
 
+    // Parse the mapping options
+    int writable = 0, populate = 0, huge_pages = 0;
+    file_advice_t advice = file_advice_normal_k;
+    if (named_args) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(named_args, &pos, &key, &value)) {
+            int *flag = NULL;
+            if (PyUnicode_CompareWithASCIIString(key, "writable") == 0) { flag = &writable; }
+            else if (PyUnicode_CompareWithASCIIString(key, "populate") == 0) { flag = &populate; }
+            else if (PyUnicode_CompareWithASCIIString(key, "huge_pages") == 0) { flag = &huge_pages; }
+            else if (PyUnicode_CompareWithASCIIString(key, "advice") == 0) {
+                if (!file_advice_parse(value, &advice)) return -1;
+                continue;
+            }
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key)) { return -1; }
+            if ((*flag = PyObject_IsTrue(value)) == -1) return -1;
+        }
+    }
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-    self->file_handle = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    // The huge pages only apply to anonymous mappings on Windows, and there are no hints for file mappings
+    sz_unused(populate || huge_pages);
+    DWORD const access = writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    self->file_handle = CreateFile(path, access, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
     if (self->file_handle == INVALID_HANDLE_VALUE) {
         PyErr_SetString(PyExc_RuntimeError, "Couldn't map the file!");
         return -1;
     }
 
-    self->mapping_handle = CreateFileMapping(self->file_handle, 0, PAGE_READONLY, 0, 0, 0);
+    self->mapping_handle = CreateFileMapping(self->file_handle, 0, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, 0);
     if (self->mapping_handle == 0) {
         CloseHandle(self->file_handle);
         self->file_handle = NULL;
@@ -408,7 +1007,7 @@ static int File_init(File *self, PyObject *positional_args, PyObject *named_args
         return -1;
     }
 
-    char *file = (char *)MapViewOfFile(self->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    char *file = (char *)MapViewOfFile(self->mapping_handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
     if (file == 0) {
         CloseHandle(self->mapping_handle);
         self->mapping_handle = NULL;
@@ -421,7 +1020,12 @@ static int File_init(File *self, PyObject *positional_args, PyObject *named_args
     self->length = GetFileSize(self->file_handle, 0);
 #else
     struct stat sb;
-    self->file_descriptor = open(path, O_RDONLY);
+    self->file_descriptor = open(path, writable ? O_RDWR : O_RDONLY);
+    if (self->file_descriptor < 0) {
+        self->file_descriptor = 0;
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return -1;
+    }
     if (fstat(self->file_descriptor, &sb) != 0) {
         close(self->file_descriptor);
         self->file_descriptor = 0;
@@ -429,7 +1033,14 @@ static int File_init(File *self, PyObject *positional_args, PyObject *named_args
         return -1;
     }
     size_t file_size = sb.st_size;
-    void *map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, self->file_descriptor, 0);
+
+    // Pre-faulting the pages avoids the page-fault storms on the first scan of a cold file
+    int map_flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (populate) map_flags |= MAP_POPULATE;
+#endif
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *map = mmap(NULL, sb.st_size, protection, map_flags, self->file_descriptor, 0);
     if (map == MAP_FAILED) {
         close(self->file_descriptor);
         self->file_descriptor = 0;
@@ -438,20 +1049,115 @@ static int File_init(File *self, PyObject *positional_args, PyObject *named_args
     }
     self->start = map;
     self->length = file_size;
+
+    // Transparent huge pages for file mappings need a kernel with `CONFIG_READ_ONLY_THP_FOR_FS`,
+    // otherwise the hint is rejected, and the regular pages are used.
+#if defined(MADV_HUGEPAGE)
+    if (huge_pages) madvise(map, file_size, MADV_HUGEPAGE);
+#else
+    sz_unused(huge_pages);
+#endif
+#if !defined(MAP_POPULATE)
+    if (populate) file_advise(self, file_advice_willneed_k);
+#endif
+    if (advice != file_advice_normal_k) file_advise(self, advice);
 #endif
 
+    self->is_writable = writable;
     return 0;
 }
 
+static PyObject *File_advise(File *self, PyObject *name) {
+    file_advice_t advice;
+    if (!file_advice_parse(name, &advice)) return NULL;
+    file_advise(self, advice);
+    Py_RETURN_NONE;
+}
+
+static PyObject *File_flush(File *self, PyObject *Py_UNUSED(ignored)) {
+    if (!self->is_writable || !self->start) Py_RETURN_NONE;
+    int flushed;
+    Py_BEGIN_ALLOW_THREADS;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    // `FlushViewOfFile` only starts writing the dirty pages, so the file buffers must be flushed to wait for them
+    flushed = FlushViewOfFile(self->start, 0) != 0 && FlushFileBuffers(self->file_handle) != 0;
+#else
+    flushed = msync((void *)self->start, self->length, MS_SYNC) == 0;
+#endif
+    Py_END_ALLOW_THREADS;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+    if (!flushed) return PyErr_SetFromWindowsErr(0);
+#else
+    if (!flushed) return PyErr_SetFromErrno(PyExc_OSError);
+#endif
+    Py_RETURN_NONE;
+}
+
+static int File_getbuffer(File *self, Py_buffer *view, int flags) {
+    // Unlike `Str`, the mapping may be writable, which `PyBuffer_FillInfo` checks against the requested `flags`
+    return PyBuffer_FillInfo(view, (PyObject *)self, (void *)self->start, (Py_ssize_t)self->length, !self->is_writable,
+                             flags);
+}
+
+static PyObject *File_lines(File *self, PyObject *args, PyObject *kwargs) {
+    if (self->is_writable) {
+        PyErr_SetString(PyExc_ValueError, "Writable files can change under the strings, edit them with `memoryview`");
+        return NULL;
+    }
+    PyObject *keeplinebreaks_obj = NULL;
+    PyObject *batch_size_obj = NULL;
+    Py_ssize_t nargs = PyTuple_Size(args);
+    if (nargs > 2) {
+        PyErr_SetString(PyExc_TypeError, "lines() received unsupported number of arguments");
+        return NULL;
+    }
+    if (nargs > 0) keeplinebreaks_obj = PyTuple_GET_ITEM(args, 0);
+    if (nargs > 1) batch_size_obj = PyTuple_GET_ITEM(args, 1);
+    if (kwargs) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (PyUnicode_CompareWithASCIIString(key, "keeplinebreaks") == 0) { keeplinebreaks_obj = value; }
+            else if (PyUnicode_CompareWithASCIIString(key, "batch_size") == 0) { batch_size_obj = value; }
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key)) { return NULL; }
+        }
+    }
+
+    int keeplinebreaks = keeplinebreaks_obj ? PyObject_IsTrue(keeplinebreaks_obj) : 0;
+    if (keeplinebreaks == -1) return NULL;
+    size_t batch_size = SZ_SPLIT_ITERATOR_BATCH_SIZE;
+    if (batch_size_obj) {
+        batch_size = PyLong_AsSize_t(batch_size_obj);
+        if (batch_size == (size_t)-1 && PyErr_Occurred()) return NULL;
+    }
+
+    sz_string_view_t text, separator;
+    text.start = self->start, text.length = self->length;
+    separator.start = "\n", separator.length = 1;
+    return split_iterator_new((PyObject *)self, text, NULL, separator, keeplinebreaks, batch_size);
+}
+
 static PyMethodDef File_methods[] = { //
+    {"lines", (PyCFunction)File_lines, SZ_METHOD_FLAGS,
+     "Iterate through the lines of the file in `Strs` batches of up to `batch_size` lines, "
+     "optionally `keeplinebreaks`, allocating the offsets of one batch at a time."},
+    {"advise", (PyCFunction)File_advise, METH_O,
+     "Hint the expected access pattern: 'normal', 'sequential', 'random', or 'willneed' to prefetch the pages."},
+    {"flush", (PyCFunction)File_flush, METH_NOARGS, "Synchronously write the changes of a writable mapping to disk."},
     {NULL, NULL, 0, NULL}};
 
+static PyBufferProcs File_as_buffer = {
+    .bf_getbuffer = (getbufferproc)File_getbuffer,
+};
+
 static PyTypeObject FileType = {
     PyObject_HEAD_INIT(NULL).tp_name = "stringzilla.File",
-    .tp_doc = "Memory mapped file class, that exposes the memory range for low-level access",
+    .tp_doc = "Memory mapped file class, that exposes the memory range for low-level access. "
+              "Accepts the `writable`, `populate`, and `huge_pages` flags, and the access pattern `advice`",
     .tp_basicsize = sizeof(File),
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_methods = File_methods,
+    .tp_as_buffer = &File_as_buffer,
     .tp_new = (newfunc)File_new,
     .tp_init = (initproc)File_init,
     .tp_dealloc = (destructor)File_dealloc,
@@ -524,15 +1230,14 @@ static int Str_init(Str *self, PyObject *args, PyObject *kwargs) {
     }
 
     // Handle empty string
-    if (parent_obj == NULL) {
-        self->start = NULL;
-        self->length = 0;
+    sz_string_view_t view = {NULL, 0};
+    if (parent_obj == NULL) {}
+    else if (PyObject_TypeCheck(parent_obj, &FileType) && ((File *)parent_obj)->is_writable) {
+        PyErr_SetString(PyExc_ValueError, "Writable files can change under the strings, edit them with `memoryview`");
+        return -1;
     }
     // Increment the reference count of the parent
-    else if (export_string_like(parent_obj, &self->start, &self->length)) {
-        self->parent = parent_obj;
-        Py_INCREF(parent_obj);
-    }
+    else if (export_string_like(parent_obj, &view.start, &view.length)) { Py_INCREF(parent_obj); }
     else {
         PyErr_SetString(PyExc_TypeError, "Unsupported parent type");
         return -1;
@@ -540,9 +1245,24 @@ static int Str_init(Str *self, PyObject *args, PyObject *kwargs) {
 
     // Apply slicing
     size_t normalized_offset, normalized_length;
-    sz_ssize_clamp_interval(self->length, from, to, &normalized_offset, &normalized_length);
-    self->start = ((char *)self->start) + normalized_offset;
-    self->length = normalized_length;
+    sz_ssize_clamp_interval(view.length, from, to, &normalized_offset, &normalized_length);
+
+    // Readers of `Str` take no locks and may use the pointers without the GIL, so replacing the parent
+    // of a live object could free the memory under them. Only the empty objects can be initialized.
+    int is_initialized;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    is_initialized = self->parent != NULL || self->start != NULL;
+    if (!is_initialized) {
+        self->parent = parent_obj;
+        self->start = view.start + normalized_offset;
+        self->length = normalized_length;
+    }
+    SZ_END_CRITICAL_SECTION();
+    if (is_initialized) {
+        Py_XDECREF(parent_obj);
+        PyErr_SetString(PyExc_TypeError, "Str is immutable, and can't be initialized again");
+        return -1;
+    }
     return 0;
 }
 
@@ -571,16 +1291,15 @@ static PyObject *Str_str(Str *self) { return PyUnicode_FromStringAndSize(self->s
 
 static Py_hash_t Str_hash(Str *self) { return (Py_hash_t)sz_hash(self->start, self->length); }
 
-static PyObject *Str_like_hash(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_like_hash(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     // Check minimum arguments
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
-    Py_ssize_t nargs = PyTuple_Size(args);
-    if (nargs < !is_member || nargs > !is_member + 1 || kwargs) {
+    if (nargs < !is_member || nargs > !is_member + 1 || (kwnames && PyTuple_GET_SIZE(kwnames))) {
         PyErr_SetString(PyExc_TypeError, "hash() expects exactly one positional argument");
         return NULL;
     }
 
-    PyObject *text_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
+    PyObject *text_obj = is_member ? self : args[0];
     sz_string_view_t text;
 
     // Validate and convert `text`
@@ -622,7 +1341,7 @@ static PyObject *Str_subscript(Str *self, PyObject *key) {
 
         // Create a new `Str` object
         Str *self_slice = (Str *)StrType.tp_alloc(&StrType, 0);
-        if (self_slice == NULL && PyErr_NoMemory()) return NULL;
+        if (self_slice == NULL && !PyErr_NoMemory()) return NULL;
 
         // Set its properties based on the slice
         self_slice->start = self->start + start;
@@ -685,11 +1404,12 @@ static Py_ssize_t Strs_len(Strs *self) {
     case STRS_CONSECUTIVE_32: return self->data.consecutive_32bit.count;
     case STRS_CONSECUTIVE_64: return self->data.consecutive_64bit.count;
     case STRS_REORDERED: return self->data.reordered.count;
+    case STRS_MULTI_SOURCE: return self->data.reordered.count;
     default: return 0;
     }
 }
 
-static PyObject *Strs_getitem(Strs *self, Py_ssize_t i) {
+static PyObject *Strs_getitem_(Strs *self, Py_ssize_t i) {
     // Check for negative index and convert to positive
     Py_ssize_t count = Strs_len(self);
     if (i < 0) i += count;
@@ -711,7 +1431,7 @@ static PyObject *Strs_getitem(Strs *self, Py_ssize_t i) {
 
     // Create a new `Str` object
     Str *view_copy = (Str *)StrType.tp_alloc(&StrType, 0);
-    if (view_copy == NULL && PyErr_NoMemory()) return NULL;
+    if (view_copy == NULL && !PyErr_NoMemory()) return NULL;
 
     view_copy->start = start;
     view_copy->length = length;
@@ -720,7 +1440,15 @@ static PyObject *Strs_getitem(Strs *self, Py_ssize_t i) {
     return view_copy;
 }
 
-static PyObject *Strs_subscript(Strs *self, PyObject *key) {
+static PyObject *Strs_getitem(Strs *self, Py_ssize_t i) {
+    PyObject *result;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    result = Strs_getitem_(self, i);
+    SZ_END_CRITICAL_SECTION();
+    return result;
+}
+
+static PyObject *Strs_subscript_(Strs *self, PyObject *key) {
     if (PySlice_Check(key)) {
         // Sanity checks
         Py_ssize_t count = Strs_len(self);
@@ -734,7 +1462,7 @@ static PyObject *Strs_subscript(Strs *self, PyObject *key) {
 
         // Create a new `Strs` object
         Strs *self_slice = (Strs *)StrsType.tp_alloc(&StrsType, 0);
-        if (self_slice == NULL && PyErr_NoMemory()) return NULL;
+        if (self_slice == NULL && !PyErr_NoMemory()) return NULL;
 
         // Depending on the layout, the procedure will be different.
         self_slice->type = self->type;
@@ -753,11 +1481,14 @@ static PyObject *Strs_subscript(Strs *self, PyObject *key) {
     str_at_offset_consecutive_##type(self, start, count, &to->parent, &to->start, &first_length);             \
     index_t first_offset = to->start - from->start;                                                           \
     to->end_offsets = malloc(sizeof(index_t) * to->count);                                                    \
-    if (to->end_offsets == NULL && PyErr_NoMemory()) {                                                        \
+    if (to->end_offsets == NULL && !PyErr_NoMemory()) {                                                        \
+        to->parent = NULL;                                                                                    \
         Py_XDECREF(self_slice);                                                                               \
         return NULL;                                                                                          \
     }                                                                                                         \
     for (size_t i = 0; i != to->count; ++i) to->end_offsets[i] = from->end_offsets[i + start] - first_offset; \
+    /* The last part of a slice mustn't end with a separator, unless it's the last part of `self` */          \
+    if (to->count && stop != count) to->end_offsets[to->count - 1] -= from->separator_length;                 \
     Py_INCREF(to->parent);
         case STRS_CONSECUTIVE_32: {
             typedef uint32_t index_32bit_t;
@@ -770,14 +1501,16 @@ static PyObject *Strs_subscript(Strs *self, PyObject *key) {
             break;
         }
 #undef consecutive_logic
-        case STRS_REORDERED: {
+        case STRS_REORDERED:
+        case STRS_MULTI_SOURCE: {
             struct reordered_slices_t *from = &self->data.reordered;
             struct reordered_slices_t *to = &self_slice->data.reordered;
             to->count = stop - start;
             to->parent = from->parent;
 
             to->parts = malloc(sizeof(sz_string_view_t) * to->count);
-            if (to->parts == NULL && PyErr_NoMemory()) {
+            if (to->parts == NULL && !PyErr_NoMemory()) {
+                to->parent = NULL;
                 Py_XDECREF(self_slice);
                 return NULL;
             }
@@ -787,22 +1520,123 @@ static PyObject *Strs_subscript(Strs *self, PyObject *key) {
         }
         default:
             // Unsupported type
+            self_slice->type = STRS_REORDERED;
+            Py_XDECREF(self_slice);
             PyErr_SetString(PyExc_TypeError, "Unsupported type for conversion");
             return NULL;
         }
 
         return (PyObject *)self_slice;
     }
-    else if (PyLong_Check(key)) { return Strs_getitem(self, PyLong_AsSsize_t(key)); }
+    else if (PyLong_Check(key)) { return Strs_getitem_(self, PyLong_AsSsize_t(key)); }
     else {
         PyErr_SetString(PyExc_TypeError, "Strs indices must be integers or slices");
         return NULL;
     }
 }
 
-// Will be called by the `PySequence_Contains`
-static int Strs_contains(Str *self, PyObject *arg) { return 0; }
-
+static PyObject *Strs_subscript(Strs *self, PyObject *key) {
+    PyObject *result;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    result = Strs_subscript_(self, key);
+    SZ_END_CRITICAL_SECTION();
+    return result;
+}
+
+static void strs_lookup_reset(Strs *strs) {
+    free(strs->lookup.slots);
+    strs->lookup.slots = NULL;
+    strs->lookup.capacity = 0;
+}
+
+/**
+ *  @brief  Populates the hash table of `strs`, keeping only the first occurrence of every distinct string,
+ *          with linear probing in a power-of-two table, that is at most half full.
+ */
+static sz_bool_t strs_lookup_build(Strs *strs) {
+    get_string_at_offset_t getter = str_at_offset_getter(strs);
+    size_t const count = (size_t)Strs_len(strs);
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    sz_u64_t *slots = (sz_u64_t *)calloc(capacity * 2, sizeof(sz_u64_t));
+    if (!slots) return 0;
+
+    size_t const mask = capacity - 1;
+    for (size_t i = 0; i != count; ++i) {
+        PyObject *parent;
+        char const *start;
+        size_t length;
+        getter(strs, (Py_ssize_t)i, (Py_ssize_t)count, &parent, &start, &length);
+        sz_u64_t hash = sz_hash(start, length);
+        size_t slot = (size_t)hash & mask;
+        for (; slots[slot * 2 + 1]; slot = (slot + 1) & mask) {
+            if (slots[slot * 2] != hash) continue;
+            char const *other_start;
+            size_t other_length;
+            Py_ssize_t other = (Py_ssize_t)(slots[slot * 2 + 1] - 1);
+            getter(strs, other, (Py_ssize_t)count, &parent, &other_start, &other_length);
+            if (other_length == length && sz_equal(start, other_start, length)) break;
+        }
+        if (slots[slot * 2 + 1]) continue; // Duplicate of an earlier string
+        slots[slot * 2] = hash;
+        slots[slot * 2 + 1] = i + 1;
+    }
+
+    strs->lookup.capacity = capacity;
+    strs->lookup.slots = slots;
+    return 1;
+}
+
+/**
+ *  @brief  Finds the first occurrence of the `query` in `strs`, which the caller must lock.
+ *          Small collections are scanned, and larger ones build the hash table on first use.
+ *  @return The index of the match, -1 if there is none, or -2 if the table couldn't be allocated.
+ */
+static Py_ssize_t strs_lookup_find(Strs *strs, sz_string_view_t query) {
+    get_string_at_offset_t getter = str_at_offset_getter(strs);
+    size_t const count = (size_t)Strs_len(strs);
+    size_t const min_indexed_count = 64;
+    PyObject *parent;
+    char const *start;
+    size_t length;
+    if (!getter) return -1;
+    if (count < min_indexed_count) {
+        for (size_t i = 0; i != count; ++i) {
+            getter(strs, (Py_ssize_t)i, (Py_ssize_t)count, &parent, &start, &length);
+            if (length == query.length && sz_equal(start, query.start, length)) return (Py_ssize_t)i;
+        }
+        return -1;
+    }
+
+    if (!strs->lookup.slots && !strs_lookup_build(strs)) return -2;
+    sz_u64_t const *slots = strs->lookup.slots;
+    size_t const mask = strs->lookup.capacity - 1;
+    sz_u64_t hash = sz_hash(query.start, query.length);
+    for (size_t slot = (size_t)hash & mask; slots[slot * 2 + 1]; slot = (slot + 1) & mask) {
+        if (slots[slot * 2] != hash) continue;
+        Py_ssize_t i = (Py_ssize_t)(slots[slot * 2 + 1] - 1);
+        getter(strs, i, (Py_ssize_t)count, &parent, &start, &length);
+        if (length == query.length && sz_equal(start, query.start, length)) return i;
+    }
+    return -1;
+}
+
+// Will be called by the `PySequence_Contains`
+static int Strs_contains(Strs *self, PyObject *arg) {
+    sz_string_view_t query;
+    // Strings that can't be encoded into UTF-8, like lone surrogates, leave the error to propagate
+    if (!export_string_like(arg, &query.start, &query.length)) return PyErr_Occurred() ? -1 : 0;
+    Py_ssize_t index;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    index = strs_lookup_find(self, query);
+    SZ_END_CRITICAL_SECTION();
+    if (index == -2) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return index >= 0;
+}
+
 static PyObject *Str_richcompare(PyObject *self, PyObject *other, int op) {
 
     sz_cptr_t a_start = NULL, b_start = NULL;
@@ -940,32 +1774,30 @@ static PyObject *Str_offset_within(PyObject *self, PyObject *args, PyObject *kwa
  *  @return 1 on success, 0 on failure.
  */
 static int _Str_find_implementation_( //
-    PyObject *self, PyObject *args, PyObject *kwargs, sz_find_t finder, Py_ssize_t *offset_out,
-    sz_string_view_t *haystack_out, sz_string_view_t *needle_out) {
+    PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames, sz_find_t finder,
+    Py_ssize_t *offset_out, sz_string_view_t *haystack_out, sz_string_view_t *needle_out) {
 
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
-    Py_ssize_t nargs = PyTuple_Size(args);
     if (nargs < !is_member + 1 || nargs > !is_member + 3) {
         PyErr_SetString(PyExc_TypeError, "Invalid number of arguments");
         return 0;
     }
 
-    PyObject *haystack_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
-    PyObject *needle_obj = PyTuple_GET_ITEM(args, !is_member + 0);
-    PyObject *start_obj = nargs > !is_member + 1 ? PyTuple_GET_ITEM(args, !is_member + 1) : NULL;
-    PyObject *end_obj = nargs > !is_member + 2 ? PyTuple_GET_ITEM(args, !is_member + 2) : NULL;
-
-    // Parse keyword arguments
-    if (kwargs) {
-        Py_ssize_t pos = 0;
-        PyObject *key, *value;
-        while (PyDict_Next(kwargs, &pos, &key, &value)) {
-            if (PyUnicode_CompareWithASCIIString(key, "start") == 0) { start_obj = value; }
-            else if (PyUnicode_CompareWithASCIIString(key, "end") == 0) { end_obj = value; }
-            else {
-                PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key);
-                return 0;
-            }
+    PyObject *haystack_obj = is_member ? self : args[0];
+    PyObject *needle_obj = args[!is_member + 0];
+    PyObject *start_obj = nargs > !is_member + 1 ? args[!is_member + 1] : NULL;
+    PyObject *end_obj = nargs > !is_member + 2 ? args[!is_member + 2] : NULL;
+
+    // Parse keyword arguments, that follow the positional ones
+    Py_ssize_t kwargs_count = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i != kwargs_count; ++i) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (keyword_is(key, interned_keywords.start)) { start_obj = value; }
+        else if (keyword_is(key, interned_keywords.end)) { end_obj = value; }
+        else {
+            PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key);
+            return 0;
         }
     }
 
@@ -1007,7 +1839,9 @@ static int _Str_find_implementation_( //
     haystack.length = normalized_length;
 
     // Perform contains operation
+    PyThreadState *gil_state = release_gil_for(haystack.length);
     sz_cptr_t match = finder(haystack.start, haystack.length, needle.start, needle.length);
+    acquire_gil(gil_state);
     if (match == NULL) { *offset_out = -1; }
     else { *offset_out = (Py_ssize_t)(match - haystack.start + normalized_offset); }
 
@@ -1016,28 +1850,31 @@ static int _Str_find_implementation_( //
     return 1;
 }
 
-static PyObject *Str_contains(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_contains(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_find, &signed_offset, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_find, &signed_offset, &text, &separator))
+        return NULL;
     if (signed_offset == -1) { Py_RETURN_FALSE; }
     else { Py_RETURN_TRUE; }
 }
 
-static PyObject *Str_find(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_find(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_find, &signed_offset, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_find, &signed_offset, &text, &separator))
+        return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_index(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_index(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_find, &signed_offset, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_find, &signed_offset, &text, &separator))
+        return NULL;
     if (signed_offset == -1) {
         PyErr_SetString(PyExc_ValueError, "substring not found");
         return NULL;
@@ -1045,19 +1882,21 @@ static PyObject *Str_index(PyObject *self, PyObject *args, PyObject *kwargs) {
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_rfind(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_rfind(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_rfind, &signed_offset, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_rfind, &signed_offset, &text, &separator))
+        return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_rindex(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_rindex(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_rfind, &signed_offset, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_rfind, &signed_offset, &text, &separator))
+        return NULL;
     if (signed_offset == -1) {
         PyErr_SetString(PyExc_ValueError, "substring not found");
         return NULL;
@@ -1065,14 +1904,16 @@ static PyObject *Str_rindex(PyObject *self, PyObject *args, PyObject *kwargs) {
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *_Str_partition_implementation(PyObject *self, PyObject *args, PyObject *kwargs, sz_find_t finder) {
+static PyObject *_Str_partition_implementation(PyObject *self, PyObject *const *args, Py_ssize_t nargs,
+                                               PyObject *kwnames, sz_find_t finder) {
     Py_ssize_t separator_index;
     sz_string_view_t text;
     sz_string_view_t separator;
     PyObject *result_tuple;
 
     // Use _Str_find_implementation_ to get the index of the separator
-    if (!_Str_find_implementation_(self, args, kwargs, finder, &separator_index, &text, &separator)) return NULL;
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, finder, &separator_index, &text, &separator))
+        return NULL;
 
     // If separator is not found, return a tuple (self, "", "")
     if (separator_index == -1) {
@@ -1111,37 +1952,66 @@ static PyObject *_Str_partition_implementation(PyObject *self, PyObject *args, P
     return result_tuple;
 }
 
-static PyObject *Str_partition(PyObject *self, PyObject *args, PyObject *kwargs) {
-    return _Str_partition_implementation(self, args, kwargs, &sz_find);
+static PyObject *Str_partition(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return _Str_partition_implementation(self, args, nargs, kwnames, &sz_find);
+}
+
+static PyObject *Str_rpartition(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return _Str_partition_implementation(self, args, nargs, kwnames, &sz_rfind);
 }
 
-static PyObject *Str_rpartition(PyObject *self, PyObject *args, PyObject *kwargs) {
-    return _Str_partition_implementation(self, args, kwargs, &sz_rfind);
+/**
+ *  @brief  Counts the occurrences of the `needle` in the `haystack`, shared by `Str.count` and `Strs.count`.
+ *          Doesn't touch any Python objects, so can be called without holding the GIL.
+ */
+static sz_size_t count_occurrences(sz_string_view_t haystack, sz_string_view_t needle, int allowoverlap) {
+    size_t count = 0;
+    if (needle.length == 0 || haystack.length == 0 || haystack.length < needle.length) { count = 0; }
+    else if (allowoverlap) {
+        while (haystack.length) {
+            sz_cptr_t ptr = sz_find(haystack.start, haystack.length, needle.start, needle.length);
+            sz_bool_t found = ptr != NULL;
+            sz_size_t offset = found ? ptr - haystack.start : haystack.length;
+            count += found;
+            haystack.start += offset + found;
+            haystack.length -= offset + found;
+        }
+    }
+    else {
+        while (haystack.length) {
+            sz_cptr_t ptr = sz_find(haystack.start, haystack.length, needle.start, needle.length);
+            sz_bool_t found = ptr != NULL;
+            sz_size_t offset = found ? ptr - haystack.start : haystack.length;
+            count += found;
+            haystack.start += offset + needle.length;
+            haystack.length -= offset + needle.length * found;
+        }
+    }
+    return count;
 }
 
-static PyObject *Str_count(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_count(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
-    Py_ssize_t nargs = PyTuple_Size(args);
     if (nargs < !is_member + 1 || nargs > !is_member + 4) {
         PyErr_Format(PyExc_TypeError, "Invalid number of arguments");
         return NULL;
     }
 
-    PyObject *haystack_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
-    PyObject *needle_obj = PyTuple_GET_ITEM(args, !is_member + 0);
-    PyObject *start_obj = nargs > !is_member + 1 ? PyTuple_GET_ITEM(args, !is_member + 1) : NULL;
-    PyObject *end_obj = nargs > !is_member + 2 ? PyTuple_GET_ITEM(args, !is_member + 2) : NULL;
-    PyObject *allowoverlap_obj = nargs > !is_member + 3 ? PyTuple_GET_ITEM(args, !is_member + 3) : NULL;
-
-    if (kwargs) {
-        Py_ssize_t pos = 0;
-        PyObject *key, *value;
-        while (PyDict_Next(kwargs, &pos, &key, &value))
-            if (PyUnicode_CompareWithASCIIString(key, "start") == 0) { start_obj = value; }
-            else if (PyUnicode_CompareWithASCIIString(key, "end") == 0) { end_obj = value; }
-            else if (PyUnicode_CompareWithASCIIString(key, "allowoverlap") == 0) { allowoverlap_obj = value; }
-            else if (PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
-                return NULL;
+    PyObject *haystack_obj = is_member ? self : args[0];
+    PyObject *needle_obj = args[!is_member + 0];
+    PyObject *start_obj = nargs > !is_member + 1 ? args[!is_member + 1] : NULL;
+    PyObject *end_obj = nargs > !is_member + 2 ? args[!is_member + 2] : NULL;
+    PyObject *allowoverlap_obj = nargs > !is_member + 3 ? args[!is_member + 3] : NULL;
+
+    Py_ssize_t kwargs_count = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i != kwargs_count; ++i) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (keyword_is(key, interned_keywords.start)) { start_obj = value; }
+        else if (keyword_is(key, interned_keywords.end)) { end_obj = value; }
+        else if (keyword_is(key, interned_keywords.allowoverlap)) { allowoverlap_obj = value; }
+        else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+            return NULL;
     }
 
     sz_string_view_t haystack;
@@ -1161,28 +2031,9 @@ static PyObject *Str_count(PyObject *self, PyObject *args, PyObject *kwargs) {
     haystack.start += normalized_offset;
     haystack.length = normalized_length;
 
-    size_t count = 0;
-    if (needle.length == 0 || haystack.length == 0 || haystack.length < needle.length) { count = 0; }
-    else if (allowoverlap) {
-        while (haystack.length) {
-            sz_cptr_t ptr = sz_find(haystack.start, haystack.length, needle.start, needle.length);
-            sz_bool_t found = ptr != NULL;
-            sz_size_t offset = found ? ptr - haystack.start : haystack.length;
-            count += found;
-            haystack.start += offset + found;
-            haystack.length -= offset + found;
-        }
-    }
-    else {
-        while (haystack.length) {
-            sz_cptr_t ptr = sz_find(haystack.start, haystack.length, needle.start, needle.length);
-            sz_bool_t found = ptr != NULL;
-            sz_size_t offset = found ? ptr - haystack.start : haystack.length;
-            count += found;
-            haystack.start += offset + needle.length;
-            haystack.length -= offset + needle.length * found;
-        }
-    }
+    PyThreadState *gil_state = release_gil_for(haystack.length);
+    size_t count = count_occurrences(haystack, needle, allowoverlap);
+    acquire_gil(gil_state);
 
     return PyLong_FromSize_t(count);
 }
@@ -1229,10 +2080,16 @@ static PyObject *_Str_edit_distance(PyObject *self, PyObject *args, PyObject *kw
     sz_memory_allocator_t reusing_allocator;
     reusing_allocator.allocate = &temporary_memory_allocate;
     reusing_allocator.free = &temporary_memory_free;
-    reusing_allocator.handle = &temporary_memory;
+    reusing_allocator.handle = temporary_memory_for_thread();
+    if (!reusing_allocator.handle) {
+        PyErr_NoMemory();
+        return NULL;
+    }
 
+    PyThreadState *gil_state = release_gil_for(str1.length * str2.length);
     sz_size_t distance =
         function(str1.start, str1.length, str2.start, str2.length, (sz_size_t)bound, &reusing_allocator);
+    acquire_gil(gil_state);
 
     // Check for memory allocation issues
     if (distance == SZ_SIZE_MAX) {
@@ -1290,7 +2147,9 @@ static PyObject *_Str_hamming_distance(PyObject *self, PyObject *args, PyObject
         return NULL;
     }
 
+    PyThreadState *gil_state = release_gil_for(sz_min_of_two(str1.length, str2.length));
     sz_size_t distance = function(str1.start, str1.length, str2.start, str2.length, (sz_size_t)bound);
+    acquire_gil(gil_state);
 
     // Check for memory allocation issues
     if (distance == SZ_SIZE_MAX) {
@@ -1388,10 +2247,17 @@ static PyObject *Str_alignment_score(PyObject *self, PyObject *args, PyObject *k
     sz_memory_allocator_t reusing_allocator;
     reusing_allocator.allocate = &temporary_memory_allocate;
     reusing_allocator.free = &temporary_memory_free;
-    reusing_allocator.handle = &temporary_memory;
+    reusing_allocator.handle = temporary_memory_for_thread();
+    if (!reusing_allocator.handle) {
+        PyBuffer_Release(&substitutions_view);
+        PyErr_NoMemory();
+        return NULL;
+    }
 
+    PyThreadState *gil_state = release_gil_for(str1.length * str2.length);
     sz_ssize_t score = sz_alignment_score(str1.start, str1.length, str2.start, str2.length, substitutions,
                                           (sz_error_cost_t)gap, &reusing_allocator);
+    acquire_gil(gil_state);
 
     // Don't forget to release the buffer view
     PyBuffer_Release(&substitutions_view);
@@ -1405,18 +2271,39 @@ static PyObject *Str_alignment_score(PyObject *self, PyObject *args, PyObject *k
     return PyLong_FromSsize_t(score);
 }
 
-static PyObject *Str_startswith(PyObject *self, PyObject *args, PyObject *kwargs) {
+/**
+ *  @brief  Checks if the `start` and `end` arguments of `startswith` and `endswith` describe an interval ending
+ *          before it begins, like `start` past the end of the string, where CPython doesn't match even an empty affix.
+ */
+static int _Str_affix_interval_is_inverted(size_t length, Py_ssize_t start, Py_ssize_t end) {
+    Py_ssize_t signed_length = (Py_ssize_t)length;
+    if (start < 0) start = start + signed_length < 0 ? 0 : start + signed_length;
+    if (end < 0) end = end + signed_length < 0 ? 0 : end + signed_length;
+    if (end > signed_length) end = signed_length;
+    return start > end;
+}
+
+static PyObject *Str_startswith(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
-    Py_ssize_t nargs = PyTuple_Size(args);
     if (nargs < !is_member + 1 || nargs > !is_member + 3) {
         PyErr_Format(PyExc_TypeError, "Invalid number of arguments");
         return NULL;
     }
 
-    PyObject *str_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
-    PyObject *prefix_obj = PyTuple_GET_ITEM(args, !is_member);
-    PyObject *start_obj = nargs > !is_member + 1 ? PyTuple_GET_ITEM(args, !is_member + 1) : NULL;
-    PyObject *end_obj = nargs > !is_member + 2 ? PyTuple_GET_ITEM(args, !is_member + 2) : NULL;
+    PyObject *str_obj = is_member ? self : args[0];
+    PyObject *prefix_obj = args[!is_member];
+    PyObject *start_obj = nargs > !is_member + 1 ? args[!is_member + 1] : NULL;
+    PyObject *end_obj = nargs > !is_member + 2 ? args[!is_member + 2] : NULL;
+
+    Py_ssize_t kwargs_count = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i != kwargs_count; ++i) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (keyword_is(key, interned_keywords.start)) { start_obj = value; }
+        else if (keyword_is(key, interned_keywords.end)) { end_obj = value; }
+        else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+            return NULL;
+    }
 
     // Optional start and end arguments
     Py_ssize_t start = 0, end = PY_SSIZE_T_MAX;
@@ -1439,27 +2326,38 @@ static PyObject *Str_startswith(PyObject *self, PyObject *args, PyObject *kwargs
     }
 
     // Apply start and end arguments
-    str.start += start;
-    str.length -= start;
-    if (end != PY_SSIZE_T_MAX && end - start < str.length) { str.length = end - start; }
+    if (_Str_affix_interval_is_inverted(str.length, start, end)) { Py_RETURN_FALSE; }
+    size_t normalized_offset, normalized_length;
+    sz_ssize_clamp_interval(str.length, start, end, &normalized_offset, &normalized_length);
+    str.start += normalized_offset;
+    str.length = normalized_length;
 
     if (str.length < prefix.length) { Py_RETURN_FALSE; }
-    else if (strncmp(str.start, prefix.start, prefix.length) == 0) { Py_RETURN_TRUE; }
+    else if (sz_equal(str.start, prefix.start, prefix.length)) { Py_RETURN_TRUE; }
     else { Py_RETURN_FALSE; }
 }
 
-static PyObject *Str_endswith(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_endswith(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
-    Py_ssize_t nargs = PyTuple_Size(args);
     if (nargs < !is_member + 1 || nargs > !is_member + 3) {
         PyErr_Format(PyExc_TypeError, "Invalid number of arguments");
         return NULL;
     }
 
-    PyObject *str_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
-    PyObject *suffix_obj = PyTuple_GET_ITEM(args, !is_member);
-    PyObject *start_obj = nargs > !is_member + 1 ? PyTuple_GET_ITEM(args, !is_member + 1) : NULL;
-    PyObject *end_obj = nargs > !is_member + 2 ? PyTuple_GET_ITEM(args, !is_member + 2) : NULL;
+    PyObject *str_obj = is_member ? self : args[0];
+    PyObject *suffix_obj = args[!is_member];
+    PyObject *start_obj = nargs > !is_member + 1 ? args[!is_member + 1] : NULL;
+    PyObject *end_obj = nargs > !is_member + 2 ? args[!is_member + 2] : NULL;
+
+    Py_ssize_t kwargs_count = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i != kwargs_count; ++i) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (keyword_is(key, interned_keywords.start)) { start_obj = value; }
+        else if (keyword_is(key, interned_keywords.end)) { end_obj = value; }
+        else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+            return NULL;
+    }
 
     // Optional start and end arguments
     Py_ssize_t start = 0, end = PY_SSIZE_T_MAX;
@@ -1482,47 +2380,51 @@ static PyObject *Str_endswith(PyObject *self, PyObject *args, PyObject *kwargs)
     }
 
     // Apply start and end arguments
-    str.start += start;
-    str.length -= start;
-    if (end != PY_SSIZE_T_MAX && end - start < str.length) { str.length = end - start; }
+    if (_Str_affix_interval_is_inverted(str.length, start, end)) { Py_RETURN_FALSE; }
+    size_t normalized_offset, normalized_length;
+    sz_ssize_clamp_interval(str.length, start, end, &normalized_offset, &normalized_length);
+    str.start += normalized_offset;
+    str.length = normalized_length;
 
     if (str.length < suffix.length) { Py_RETURN_FALSE; }
-    else if (strncmp(str.start + (str.length - suffix.length), suffix.start, suffix.length) == 0) { Py_RETURN_TRUE; }
+    else if (sz_equal(str.start + (str.length - suffix.length), suffix.start, suffix.length)) { Py_RETURN_TRUE; }
     else { Py_RETURN_FALSE; }
 }
 
-static PyObject *Str_find_first_of(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_find_first_of(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_find_char_from, &signed_offset, &text, &separator))
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_find_char_from, &signed_offset, &text, &separator))
         return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_find_first_not_of(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_find_first_not_of(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_find_char_not_from, &signed_offset, &text, &separator))
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_find_char_not_from, &signed_offset, &text,
+                                   &separator))
         return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_find_last_of(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_find_last_of(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_rfind_char_from, &signed_offset, &text, &separator))
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_rfind_char_from, &signed_offset, &text, &separator))
         return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
 
-static PyObject *Str_find_last_not_of(PyObject *self, PyObject *args, PyObject *kwargs) {
+static PyObject *Str_find_last_not_of(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
     Py_ssize_t signed_offset;
     sz_string_view_t text;
     sz_string_view_t separator;
-    if (!_Str_find_implementation_(self, args, kwargs, &sz_rfind_char_not_from, &signed_offset, &text, &separator))
+    if (!_Str_find_implementation_(self, args, nargs, kwnames, &sz_rfind_char_not_from, &signed_offset, &text,
+                                   &separator))
         return NULL;
     return PyLong_FromSsize_t(signed_offset);
 }
@@ -1532,6 +2434,9 @@ static Strs *Str_split_(PyObject *parent, sz_string_view_t text, sz_string_view_
     // Create Strs object
     Strs *result = (Strs *)PyObject_New(Strs, &StrsType);
     if (!result) return NULL;
+    result->lookup.capacity = 0;
+    result->lookup.slots = NULL;
+    result->borrows_offsets = 0;
 
     // Initialize Strs object based on the splitting logic
     void *offsets_endings = NULL;
@@ -1554,6 +2459,8 @@ static Strs *Str_split_(PyObject *parent, sz_string_view_t text, sz_string_view_
     }
 
     // Iterate through string, keeping track of the
+    int out_of_memory = 0;
+    PyThreadState *gil_state = release_gil_for(text.length);
     sz_size_t last_start = 0;
     while (last_start <= text.length && offsets_count < maxsplit) {
         sz_cptr_t match = sz_find(text.start + last_start, text.length - last_start, separator.start, separator.length);
@@ -1569,11 +2476,10 @@ static Strs *Str_split_(PyObject *parent, sz_string_view_t text, sz_string_view_
             offsets_endings = new_offsets;
         }
 
-        // If the memory allocation has failed - discard the response
+        // If the memory allocation has failed - discard the response, once the GIL is back
         if (!offsets_endings) {
-            Py_XDECREF(result);
-            PyErr_NoMemory();
-            return NULL;
+            out_of_memory = 1;
+            break;
         }
 
         // Export the offset
@@ -1585,6 +2491,17 @@ static Strs *Str_split_(PyObject *parent, sz_string_view_t text, sz_string_view_
         // Next time we want to start
         last_start = last_start + offset_in_remaining + separator.length;
     }
+    acquire_gil(gil_state);
+
+    if (out_of_memory) {
+        // The parent isn't referenced yet, and the offsets are already freed
+        result->type = STRS_REORDERED;
+        result->data.reordered.parts = NULL;
+        result->data.reordered.parent = NULL;
+        Py_XDECREF(result);
+        PyErr_NoMemory();
+        return NULL;
+    }
 
     // Populate the Strs object with the offsets
     if (text.length >= UINT32_MAX) {
@@ -1621,7 +2538,7 @@ static PyObject *Str_split(PyObject *self, PyObject *args, PyObject *kwargs) {
             if (PyUnicode_CompareWithASCIIString(key, "separator") == 0) { separator_obj = value; }
             else if (PyUnicode_CompareWithASCIIString(key, "maxsplit") == 0) { maxsplit_obj = value; }
             else if (PyUnicode_CompareWithASCIIString(key, "keepseparator") == 0) { keepseparator_obj = value; }
-            else if (PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
                 return NULL;
         }
     }
@@ -1672,6 +2589,78 @@ static PyObject *Str_split(PyObject *self, PyObject *args, PyObject *kwargs) {
     return Str_split_(text_obj, text, separator, keepseparator, maxsplit);
 }
 
+static PyObject *Str_split_iter(PyObject *self, PyObject *args, PyObject *kwargs) {
+    // Check minimum arguments
+    int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
+    Py_ssize_t nargs = PyTuple_Size(args);
+    if (nargs < !is_member || nargs > !is_member + 3) {
+        PyErr_SetString(PyExc_TypeError, "sz.split_iter() received unsupported number of arguments");
+        return NULL;
+    }
+
+    PyObject *text_obj = is_member ? self : PyTuple_GET_ITEM(args, 0);
+    PyObject *separator_obj = nargs > !is_member + 0 ? PyTuple_GET_ITEM(args, !is_member + 0) : NULL;
+    PyObject *keepseparator_obj = nargs > !is_member + 1 ? PyTuple_GET_ITEM(args, !is_member + 1) : NULL;
+    PyObject *batch_size_obj = nargs > !is_member + 2 ? PyTuple_GET_ITEM(args, !is_member + 2) : NULL;
+
+    if (kwargs) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (PyUnicode_CompareWithASCIIString(key, "separator") == 0) { separator_obj = value; }
+            else if (PyUnicode_CompareWithASCIIString(key, "keepseparator") == 0) { keepseparator_obj = value; }
+            else if (PyUnicode_CompareWithASCIIString(key, "batch_size") == 0) { batch_size_obj = value; }
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+                return NULL;
+        }
+    }
+
+    sz_string_view_t text;
+    sz_string_view_t separator;
+    int keepseparator;
+    size_t batch_size;
+
+    // Validate and convert `text`
+    if (!export_string_like(text_obj, &text.start, &text.length)) {
+        PyErr_SetString(PyExc_TypeError, "The text argument must be string-like");
+        return NULL;
+    }
+
+    // Validate and convert `separator`
+    if (separator_obj) {
+        if (!export_string_like(separator_obj, &separator.start, &separator.length)) {
+            PyErr_SetString(PyExc_TypeError, "The separator argument must be string-like");
+            return NULL;
+        }
+    }
+    else {
+        separator.start = " ";
+        separator.length = 1;
+    }
+
+    // Validate and convert `keepseparator`
+    if (keepseparator_obj) {
+        keepseparator = PyObject_IsTrue(keepseparator_obj);
+        if (keepseparator == -1) {
+            PyErr_SetString(PyExc_TypeError, "The keepseparator argument must be a boolean");
+            return NULL;
+        }
+    }
+    else { keepseparator = 0; }
+
+    // Validate and convert `batch_size`
+    if (batch_size_obj) {
+        batch_size = PyLong_AsSize_t(batch_size_obj);
+        if (batch_size == (size_t)-1 && PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError, "The batch_size argument must be a non-negative integer");
+            return NULL;
+        }
+    }
+    else { batch_size = SZ_SPLIT_ITERATOR_BATCH_SIZE; }
+
+    return split_iterator_new(text_obj, text, separator_obj, separator, keepseparator, batch_size);
+}
+
 static PyObject *Str_splitlines(PyObject *self, PyObject *args, PyObject *kwargs) {
     // Check minimum arguments
     int is_member = self != NULL && PyObject_TypeCheck(self, &StrType);
@@ -1691,7 +2680,7 @@ static PyObject *Str_splitlines(PyObject *self, PyObject *args, PyObject *kwargs
         while (PyDict_Next(kwargs, &pos, &key, &value)) {
             if (PyUnicode_CompareWithASCIIString(key, "keeplinebreaks") == 0) { keeplinebreaks_obj = value; }
             else if (PyUnicode_CompareWithASCIIString(key, "maxsplit") == 0) { maxsplit_obj = value; }
-            else if (PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key)) { return NULL; }
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key)) { return NULL; }
         }
     }
 
@@ -1791,24 +2780,28 @@ static PyNumberMethods Str_as_number = {
     .nb_add = Str_concat,
 };
 
-#define SZ_METHOD_FLAGS METH_VARARGS | METH_KEYWORDS
-
 static PyMethodDef Str_methods[] = {
     // Basic `str`-like functionality
-    {"contains", Str_contains, SZ_METHOD_FLAGS, "Check if a string contains a substring."},
-    {"count", Str_count, SZ_METHOD_FLAGS, "Count the occurrences of a substring."},
+    {"contains", (PyCFunction)Str_contains, SZ_FASTCALL_FLAGS, "Check if a string contains a substring."},
+    {"count", (PyCFunction)Str_count, SZ_FASTCALL_FLAGS, "Count the occurrences of a substring."},
     {"splitlines", Str_splitlines, SZ_METHOD_FLAGS, "Split a string by line breaks."},
-    {"startswith", Str_startswith, SZ_METHOD_FLAGS, "Check if a string starts with a given prefix."},
-    {"endswith", Str_endswith, SZ_METHOD_FLAGS, "Check if a string ends with a given suffix."},
+    {"startswith", (PyCFunction)Str_startswith, SZ_FASTCALL_FLAGS, "Check if a string starts with a given prefix."},
+    {"endswith", (PyCFunction)Str_endswith, SZ_FASTCALL_FLAGS, "Check if a string ends with a given suffix."},
     {"split", Str_split, SZ_METHOD_FLAGS, "Split a string by a separator."},
+    {"split_iter", Str_split_iter, SZ_METHOD_FLAGS,
+     "Lazily split a string by a separator, yielding `Strs` batches of up to `batch_size` parts."},
 
     // Bidirectional operations
-    {"find", Str_find, SZ_METHOD_FLAGS, "Find the first occurrence of a substring."},
-    {"index", Str_index, SZ_METHOD_FLAGS, "Find the first occurrence of a substring or raise error if missing."},
-    {"partition", Str_partition, SZ_METHOD_FLAGS, "Splits string into 3-tuple: before, first match, after."},
-    {"rfind", Str_rfind, SZ_METHOD_FLAGS, "Find the last occurrence of a substring."},
-    {"rindex", Str_rindex, SZ_METHOD_FLAGS, "Find the last occurrence of a substring or raise error if missing."},
-    {"rpartition", Str_rpartition, SZ_METHOD_FLAGS, "Splits string into 3-tuple: before, last match, after."},
+    {"find", (PyCFunction)Str_find, SZ_FASTCALL_FLAGS, "Find the first occurrence of a substring."},
+    {"index", (PyCFunction)Str_index, SZ_FASTCALL_FLAGS,
+     "Find the first occurrence of a substring or raise error if missing."},
+    {"partition", (PyCFunction)Str_partition, SZ_FASTCALL_FLAGS,
+     "Splits string into 3-tuple: before, first match, after."},
+    {"rfind", (PyCFunction)Str_rfind, SZ_FASTCALL_FLAGS, "Find the last occurrence of a substring."},
+    {"rindex", (PyCFunction)Str_rindex, SZ_FASTCALL_FLAGS,
+     "Find the last occurrence of a substring or raise error if missing."},
+    {"rpartition", (PyCFunction)Str_rpartition, SZ_FASTCALL_FLAGS,
+     "Splits string into 3-tuple: before, last match, after."},
 
     // Edit distance extensions
     {"hamming_distance", Str_hamming_distance, SZ_METHOD_FLAGS,
@@ -1823,13 +2816,13 @@ static PyMethodDef Str_methods[] = {
      "Needleman-Wunsch alignment score given a substitution cost matrix."},
 
     // Character search extensions
-    {"find_first_of", Str_find_first_of, SZ_METHOD_FLAGS,
+    {"find_first_of", (PyCFunction)Str_find_first_of, SZ_FASTCALL_FLAGS,
      "Finds the first occurrence of a character from another string."},
-    {"find_last_of", Str_find_last_of, SZ_METHOD_FLAGS,
+    {"find_last_of", (PyCFunction)Str_find_last_of, SZ_FASTCALL_FLAGS,
      "Finds the last occurrence of a character from another string."},
-    {"find_first_not_of", Str_find_first_not_of, SZ_METHOD_FLAGS,
+    {"find_first_not_of", (PyCFunction)Str_find_first_not_of, SZ_FASTCALL_FLAGS,
      "Finds the first occurrence of a character not present in another string."},
-    {"find_last_not_of", Str_find_last_not_of, SZ_METHOD_FLAGS,
+    {"find_last_not_of", (PyCFunction)Str_find_last_not_of, SZ_FASTCALL_FLAGS,
      "Finds the last occurrence of a character not present in another string."},
 
     // Dealing with larger-than-memory datasets
@@ -1903,79 +2896,170 @@ static PyObject *Strs_shuffle(Strs *self, PyObject *args, PyObject *kwargs) {
     }
 
     // Change the layout
-    if (!prepare_strings_for_reordering(self)) {
+    sz_bool_t prepared;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    prepared = prepare_strings_for_reordering(self);
+    if (prepared) {
+        // Get the parts and their count
+        struct reordered_slices_t *reordered = &self->data.reordered;
+        sz_string_view_t *parts = reordered->parts;
+        size_t count = reordered->count;
+
+        // Fisher-Yates Shuffle Algorithm
+        srand(seed);
+        for (size_t i = count; i > 1; --i) {
+            size_t j = rand() % i;
+            // Swap parts[i - 1] and parts[j]
+            sz_string_view_t temp = parts[i - 1];
+            parts[i - 1] = parts[j];
+            parts[j] = temp;
+        }
+        strs_lookup_reset(self);
+    }
+    SZ_END_CRITICAL_SECTION();
+    if (!prepared) {
         PyErr_Format(PyExc_TypeError, "Failed to prepare the sequence for shuffling");
         return NULL;
     }
 
-    // Get the parts and their count
-    struct reordered_slices_t *reordered = &self->data.reordered;
-    sz_string_view_t *parts = reordered->parts;
-    size_t count = reordered->count;
-
-    // Fisher-Yates Shuffle Algorithm
-    srand(seed);
-    for (size_t i = count - 1; i > 0; --i) {
-        size_t j = rand() % (i + 1);
-        // Swap parts[i] and parts[j]
-        sz_string_view_t temp = parts[i];
-        parts[i] = parts[j];
-        parts[j] = temp;
-    }
-
     Py_RETURN_NONE;
 }
 
-static sz_bool_t Strs_sort_(Strs *self, sz_string_view_t **parts_output, sz_sorted_idx_t **order_output,
-                            sz_size_t *count_output) {
-    // Change the layout
-    if (!prepare_strings_for_reordering(self)) {
-        PyErr_Format(PyExc_TypeError, "Failed to prepare the sequence for sorting");
-        return 0;
-    }
+/**
+ *  @brief  Private copy of the offsets or slices of a `Strs`, that other threads can't reorder or free,
+ *          while the GIL is released. The strings themselves are owned by the `parent`, which the snapshot
+ *          references, in case another thread re-initializes the `Strs`.
+ */
+typedef struct {
+    sz_sequence_t sequence;
+    union {
+        struct consecutive_slices_32bit_t consecutive_32bit;
+        struct consecutive_slices_64bit_t consecutive_64bit;
+    } data;
+    void *buffer;
+    PyObject *parent;
+    sz_bool_t is_multi_source;
+} strs_snapshot_t;
+
+/** @brief  Frees the copied layout and releases the parent, which requires holding the GIL. */
+static void strs_snapshot_release(strs_snapshot_t *snapshot) {
+    free(snapshot->buffer);
+    Py_XDECREF(snapshot->parent);
+}
 
-    // Get the parts and their count
-    // The only possible `self->type` by now is the `STRS_REORDERED`
-    sz_string_view_t *parts = self->data.reordered.parts;
-    size_t count = self->data.reordered.count;
+static sz_bool_t strs_snapshot_init(Strs *self, strs_snapshot_t *snapshot) {
+    void const *source = NULL;
+    void *source_buffer;
+    size_t buffer_size = 0;
+    memset(snapshot, 0, sizeof(*snapshot));
+    switch (self->type) {
+    case STRS_CONSECUTIVE_32:
+        snapshot->data.consecutive_32bit = self->data.consecutive_32bit;
+        snapshot->sequence.count = self->data.consecutive_32bit.count;
+        snapshot->sequence.handle = &snapshot->data.consecutive_32bit;
+        snapshot->sequence.get_start = consecutive_32bit_get_start;
+        snapshot->sequence.get_length = consecutive_32bit_get_length;
+        source = self->data.consecutive_32bit.end_offsets;
+        buffer_size = snapshot->sequence.count * sizeof(uint32_t);
+        break;
+    case STRS_CONSECUTIVE_64:
+        snapshot->data.consecutive_64bit = self->data.consecutive_64bit;
+        snapshot->sequence.count = self->data.consecutive_64bit.count;
+        snapshot->sequence.handle = &snapshot->data.consecutive_64bit;
+        snapshot->sequence.get_start = consecutive_64bit_get_start;
+        snapshot->sequence.get_length = consecutive_64bit_get_length;
+        source = self->data.consecutive_64bit.end_offsets;
+        buffer_size = snapshot->sequence.count * sizeof(uint64_t);
+        break;
+    case STRS_REORDERED:
+    case STRS_MULTI_SOURCE:
+        snapshot->sequence.count = self->data.reordered.count;
+        snapshot->sequence.get_start = parts_get_start;
+        snapshot->sequence.get_length = parts_get_length;
+        source = self->data.reordered.parts;
+        buffer_size = snapshot->sequence.count * sizeof(sz_string_view_t);
+        break;
+    default: PyErr_SetString(PyExc_TypeError, "Failed to prepare the sequence for sorting"); return 0;
+    }
 
-    // Allocate temporary memory to store the ordering offsets
-    size_t memory_needed = sizeof(sz_sorted_idx_t) * count;
-    if (temporary_memory.length < memory_needed) {
-        temporary_memory.start = realloc(temporary_memory.start, memory_needed);
-        temporary_memory.length = memory_needed;
+    snapshot->buffer = malloc(buffer_size ? buffer_size : 1);
+    if (!snapshot->buffer) {
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate memory for a copy of the sequence");
+        return 0;
     }
-    if (!temporary_memory.start) {
-        PyErr_Format(PyExc_MemoryError, "Unable to allocate memory for the Levenshtein matrix");
+    if (buffer_size) memcpy(snapshot->buffer, source, buffer_size);
+    strs_layout_detach(self, &source_buffer, &snapshot->parent);
+    Py_XINCREF(snapshot->parent);
+    snapshot->is_multi_source = self->type == STRS_MULTI_SOURCE;
+    switch (self->type) {
+    case STRS_CONSECUTIVE_32: snapshot->data.consecutive_32bit.end_offsets = (uint32_t *)snapshot->buffer; break;
+    case STRS_CONSECUTIVE_64: snapshot->data.consecutive_64bit.end_offsets = (uint64_t *)snapshot->buffer; break;
+    default: snapshot->sequence.handle = snapshot->buffer; break;
+    }
+    return 1;
+}
+
+/**
+ *  @brief  Computes the sorted order of the strings, without changing the layout of `self`.
+ *          The consecutive layouts are sorted through their offsets, without materializing the slices.
+ *          The GIL is released for the duration of the sort, so it runs on a private `snapshot` of the layout,
+ *          which a concurrent `shuffle` or `sort` of the same object can't invalidate.
+ *
+ *  @param[out] order_output    Newly allocated array of `snapshot->sequence.count` indices, freed by the caller.
+ *  @param[out] snapshot        Copy of the layout the `order_output` refers to, freed by the caller.
+ */
+static sz_bool_t Strs_sort_(Strs *self, sz_size_t partial_order_length, size_t threads,
+                            sz_sorted_idx_t **order_output, strs_snapshot_t *snapshot) {
+
+    sz_bool_t copied;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    copied = strs_snapshot_init(self, snapshot);
+    SZ_END_CRITICAL_SECTION();
+    if (!copied) return 0;
+    sz_sequence_t *sequence = &snapshot->sequence;
+
+    // Allocate memory to store the ordering offsets, separate from the thread's `temporary_memory`,
+    // as other threads may use the latter, while this one has released the GIL.
+    sequence->order = (sz_sorted_idx_t *)malloc(sizeof(sz_sorted_idx_t) * (sequence->count ? sequence->count : 1));
+    if (!sequence->order) {
+        strs_snapshot_release(snapshot);
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate memory for the sorted order");
         return 0;
     }
+    for (sz_sorted_idx_t i = 0; i != sequence->count; ++i) sequence->order[i] = i;
 
     // Call our sorting algorithm
-    sz_sequence_t sequence;
-    memset(&sequence, 0, sizeof(sequence));
-    sequence.order = (sz_sorted_idx_t *)temporary_memory.start;
-    sequence.count = count;
-    sequence.handle = parts;
-    sequence.get_start = parts_get_start;
-    sequence.get_length = parts_get_length;
-    for (sz_sorted_idx_t i = 0; i != sequence.count; ++i) sequence.order[i] = i;
-    sz_sort(&sequence);
+    sz_bool_t success;
+    Py_BEGIN_ALLOW_THREADS;
+    success = sort_sequence(sequence, partial_order_length, threads);
+    Py_END_ALLOW_THREADS;
+    if (!success) {
+        free(sequence->order);
+        strs_snapshot_release(snapshot);
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate memory for merging the sorted chunks");
+        return 0;
+    }
 
     // Export results
-    *parts_output = parts;
-    *order_output = sequence.order;
-    *count_output = sequence.count;
+    *order_output = sequence->order;
     return 1;
 }
 
-static PyObject *Strs_sort(Strs *self, PyObject *args, PyObject *kwargs) {
+/**
+ *  @brief  Parses the `reverse`, `top_k`, and `threads` arguments shared by `Strs.sort` and `Strs.order`.
+ *          The partial sort selects the smallest elements, so it's only used for the ascending order.
+ */
+static sz_bool_t Strs_sort_arguments_(char const *name, PyObject *args, PyObject *kwargs, sz_bool_t *reverse,
+                                      sz_size_t *top_k, size_t *threads) {
     PyObject *reverse_obj = NULL; // Default is not reversed
+    PyObject *top_k_obj = NULL;   // Default is the full sort
+    PyObject *threads_obj = NULL; // Default is the single-threaded sort
 
     // Check for positional arguments
     Py_ssize_t nargs = PyTuple_Size(args);
     if (nargs > 1) {
-        PyErr_SetString(PyExc_TypeError, "sort() takes at most 1 positional argument");
-        return NULL;
+        PyErr_Format(PyExc_TypeError, "%s() takes at most 1 positional argument", name);
+        return 0;
     }
     else if (nargs == 1) { reverse_obj = PyTuple_GET_ITEM(args, 0); }
 
@@ -1987,86 +3071,124 @@ static PyObject *Strs_sort(Strs *self, PyObject *args, PyObject *kwargs) {
             if (PyUnicode_CompareWithASCIIString(key, "reverse") == 0) {
                 if (reverse_obj) {
                     PyErr_SetString(PyExc_TypeError, "Received reverse both as positional and keyword argument");
-                    return NULL;
+                    return 0;
                 }
                 reverse_obj = value;
             }
+            else if (PyUnicode_CompareWithASCIIString(key, "top_k") == 0) { top_k_obj = value; }
+            else if (PyUnicode_CompareWithASCIIString(key, "threads") == 0) { threads_obj = value; }
             else {
                 PyErr_Format(PyExc_TypeError, "Received an unexpected keyword argument '%U'", key);
-                return NULL;
+                return 0;
             }
         }
     }
 
-    sz_bool_t reverse = 0; // Default is False
+    *reverse = 0; // Default is False
     if (reverse_obj) {
         if (!PyBool_Check(reverse_obj)) {
             PyErr_SetString(PyExc_TypeError, "The reverse must be a boolean");
-            return NULL;
+            return 0;
         }
-        reverse = PyObject_IsTrue(reverse_obj);
+        *reverse = PyObject_IsTrue(reverse_obj);
     }
 
-    sz_string_view_t *parts = NULL;
-    sz_size_t *order = NULL;
-    sz_size_t count = 0;
-    if (!Strs_sort_(self, &parts, &order, &count)) return NULL;
-
-    // Apply the sorting algorithm here, considering the `reverse` value
-    if (reverse) reverse_offsets(order, count);
-
-    // Apply the new order.
-    apply_order(parts, order, count);
+    *top_k = SZ_SIZE_MAX;
+    if (top_k_obj && top_k_obj != Py_None) {
+        if (!PyLong_Check(top_k_obj)) {
+            PyErr_SetString(PyExc_TypeError, "The top_k must be an integer");
+            return 0;
+        }
+        Py_ssize_t signed_top_k = PyLong_AsSsize_t(top_k_obj);
+        if (signed_top_k < 0) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError, "The top_k must be non-negative");
+            return 0;
+        }
+        *top_k = (sz_size_t)signed_top_k;
+    }
 
-    Py_RETURN_NONE;
+    // Zero threads stand for all the available cores.
+    *threads = 1;
+    if (threads_obj && threads_obj != Py_None) {
+        if (!PyLong_Check(threads_obj)) {
+            PyErr_SetString(PyExc_TypeError, "The threads must be an integer");
+            return 0;
+        }
+        Py_ssize_t signed_threads = PyLong_AsSsize_t(threads_obj);
+        if (signed_threads < 0) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError, "The threads must be non-negative");
+            return 0;
+        }
+        *threads = signed_threads ? (size_t)signed_threads : hardware_concurrency();
+    }
+    return 1;
 }
 
-static PyObject *Strs_order(Strs *self, PyObject *args, PyObject *kwargs) {
-    PyObject *reverse_obj = NULL; // Default is not reversed
+static PyObject *Strs_sort(Strs *self, PyObject *args, PyObject *kwargs) {
+    sz_bool_t reverse;
+    sz_size_t top_k;
+    size_t threads;
+    if (!Strs_sort_arguments_("sort", args, kwargs, &reverse, &top_k, &threads)) return NULL;
 
-    // Check for positional arguments
-    Py_ssize_t nargs = PyTuple_Size(args);
-    if (nargs > 1) {
-        PyErr_SetString(PyExc_TypeError, "order() takes at most 1 positional argument");
+    sz_sorted_idx_t *order = NULL;
+    strs_snapshot_t snapshot;
+    if (!Strs_sort_(self, reverse ? SZ_SIZE_MAX : top_k, threads, &order, &snapshot)) return NULL;
+    sz_sequence_t *sequence = &snapshot.sequence;
+    sz_size_t count = sequence->count;
+
+    // Apply the sorting algorithm here, considering the `reverse` value
+    if (reverse) reverse_offsets(order, count);
+
+    // Gather the slices of the snapshot in the new order, directly into the reordered layout.
+    sz_string_view_t *parts = (sz_string_view_t *)malloc(sizeof(sz_string_view_t) * (count ? count : 1));
+    if (!parts) {
+        free(order);
+        strs_snapshot_release(&snapshot);
+        PyErr_SetString(PyExc_MemoryError, "Unable to allocate memory for reordered slices");
         return NULL;
     }
-    else if (nargs == 1) { reverse_obj = PyTuple_GET_ITEM(args, 0); }
+    for (sz_size_t i = 0; i != count; ++i) {
+        parts[i].start = sequence->get_start(sequence, order[i]);
+        parts[i].length = sequence->get_length(sequence, order[i]);
+    }
+    free(order);
+    free(snapshot.buffer);
+
+    // Replace the layout, which another thread might have also changed in the meantime.
+    // The new slices point into the parent of the snapshot, so its reference is passed to the layout.
+    void *old_buffer;
+    PyObject *old_parent;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    strs_layout_detach(self, &old_buffer, &old_parent);
+    // Strings from many sources remain referenced by the same tuple of sources
+    self->type = snapshot.is_multi_source ? STRS_MULTI_SOURCE : STRS_REORDERED;
+    self->data.reordered.count = count;
+    self->data.reordered.parts = parts;
+    self->data.reordered.parent = snapshot.parent;
+    self->borrows_offsets = 0;
+    strs_lookup_reset(self);
+    SZ_END_CRITICAL_SECTION();
+    free(old_buffer);
+    Py_XDECREF(old_parent);
 
-    // Check for keyword arguments
-    if (kwargs) {
-        PyObject *key, *value;
-        Py_ssize_t pos = 0;
-        while (PyDict_Next(kwargs, &pos, &key, &value)) {
-            if (PyUnicode_CompareWithASCIIString(key, "reverse") == 0) {
-                if (reverse_obj) {
-                    PyErr_SetString(PyExc_TypeError, "Received reverse both as positional and keyword argument");
-                    return NULL;
-                }
-                reverse_obj = value;
-            }
-            else {
-                PyErr_Format(PyExc_TypeError, "Received an unexpected keyword argument '%U'", key);
-                return NULL;
-            }
-        }
-    }
+    Py_RETURN_NONE;
+}
 
-    sz_bool_t reverse = 0; // Default is False
-    if (reverse_obj) {
-        if (!PyBool_Check(reverse_obj)) {
-            PyErr_SetString(PyExc_TypeError, "The reverse must be a boolean");
-            return NULL;
-        }
-        reverse = PyObject_IsTrue(reverse_obj);
-    }
+static PyObject *Strs_order(Strs *self, PyObject *args, PyObject *kwargs) {
+    sz_bool_t reverse;
+    sz_size_t top_k;
+    size_t threads;
+    if (!Strs_sort_arguments_("order", args, kwargs, &reverse, &top_k, &threads)) return NULL;
 
-    sz_string_view_t *parts = NULL;
     sz_sorted_idx_t *order = NULL;
-    sz_size_t count = 0;
-    if (!Strs_sort_(self, &parts, &order, &count)) return NULL;
+    strs_snapshot_t snapshot;
+    if (!Strs_sort_(self, reverse ? SZ_SIZE_MAX : top_k, threads, &order, &snapshot)) return NULL;
+    sz_size_t count = snapshot.sequence.count;
+    strs_snapshot_release(&snapshot);
 
     // Apply the sorting algorithm here, considering the `reverse` value
     if (reverse) reverse_offsets(order, count);
+    if (top_k < count) count = top_k;
 
     // Here, instead of applying the order, we want to return the copy of the
     // order as a NumPy array of 64-bit unsigned integers.
@@ -2085,21 +3207,908 @@ static PyObject *Strs_order(Strs *self, PyObject *args, PyObject *kwargs) {
     // So instead of NumPy, let's produce a tuple of integers.
     PyObject *tuple = PyTuple_New(count);
     if (!tuple) {
+        free(order);
         PyErr_SetString(PyExc_RuntimeError, "Failed to create a tuple");
         return NULL;
     }
     for (sz_size_t i = 0; i < count; ++i) {
         PyObject *index = PyLong_FromUnsignedLong(order[i]);
         if (!index) {
+            free(order);
             PyErr_SetString(PyExc_RuntimeError, "Failed to create a tuple element");
             Py_DECREF(tuple);
             return NULL;
         }
         PyTuple_SET_ITEM(tuple, i, index);
     }
+    free(order);
     return tuple;
 }
 
+#pragma region Batch Operations
+
+typedef enum {
+    batch_find_k,
+    batch_count_k,
+    batch_startswith_k,
+    batch_endswith_k,
+    batch_hash_k,
+    batch_length_k,
+    batch_edit_distance_k,
+} batch_operation_t;
+
+/**
+ *  @brief  Range of a `Strs` snapshot, to which a batch operation is applied in one thread.
+ *          The results are written into the `output` at the same indices, as `int64_t` for `find`,
+ *          `sz_bool_t`-sized bytes for the prefix and suffix checks, and `uint64_t` for the rest.
+ */
+typedef struct {
+    sz_sequence_t const *sequence;
+    batch_operation_t operation;
+    sz_string_view_t argument;
+    int allowoverlap;
+    sz_size_t bound;
+    void *output;
+    sz_size_t first;
+    sz_size_t last;
+    sz_bool_t failed;
+} batch_chunk_t;
+
+static void batch_chunk(batch_chunk_t *chunk) {
+    sz_sequence_t const *sequence = chunk->sequence;
+    sz_string_view_t const argument = chunk->argument;
+    int64_t *signed_output = (int64_t *)chunk->output;
+    uint64_t *unsigned_output = (uint64_t *)chunk->output;
+    uint8_t *boolean_output = (uint8_t *)chunk->output;
+
+    // Every thread reuses its own scratch space for the edit distances
+    sz_string_view_t scratch = {NULL, 0};
+    sz_memory_allocator_t reusing_allocator;
+    reusing_allocator.allocate = &temporary_memory_allocate;
+    reusing_allocator.free = &temporary_memory_free;
+    reusing_allocator.handle = &scratch;
+
+    for (sz_size_t i = chunk->first; i != chunk->last; ++i) {
+        sz_string_view_t text;
+        text.start = sequence->get_start(sequence, i);
+        text.length = sequence->get_length(sequence, i);
+        switch (chunk->operation) {
+        case batch_find_k: {
+            sz_cptr_t match = sz_find(text.start, text.length, argument.start, argument.length);
+            signed_output[i] = match ? (int64_t)(match - text.start) : -1;
+        } break;
+        case batch_count_k: unsigned_output[i] = count_occurrences(text, argument, chunk->allowoverlap); break;
+        case batch_startswith_k:
+            boolean_output[i] = text.length >= argument.length && sz_equal(text.start, argument.start, argument.length);
+            break;
+        case batch_endswith_k:
+            boolean_output[i] = text.length >= argument.length &&
+                                sz_equal(text.start + text.length - argument.length, argument.start, argument.length);
+            break;
+        case batch_hash_k: unsigned_output[i] = sz_hash(text.start, text.length); break;
+        case batch_length_k: unsigned_output[i] = text.length; break;
+        case batch_edit_distance_k:
+            unsigned_output[i] = sz_edit_distance(text.start, text.length, argument.start, argument.length,
+                                                  chunk->bound, &reusing_allocator);
+            chunk->failed |= unsigned_output[i] == SZ_SIZE_MAX;
+            break;
+        }
+    }
+    free((void *)scratch.start);
+}
+
+static void batch_chunk_callback(void *chunks, size_t chunk) { batch_chunk((batch_chunk_t *)chunks + chunk); }
+
+/**
+ *  @brief  Applies the `task` to the whole range of its sequence, splitting it between `threads` equal chunks.
+ *          Doesn't touch any Python objects, so can be called without holding the GIL.
+ *  @return Whether all the chunks succeeded, and the memory allocations didn't fail.
+ */
+static sz_bool_t batch_sequence(batch_chunk_t task, size_t threads) {
+    // Small inputs aren't worth the overhead of spawning threads.
+    size_t const min_chunk_length = 4096;
+    sz_size_t const count = task.sequence->count;
+    if (threads > count / min_chunk_length) threads = count / min_chunk_length;
+    task.first = 0, task.last = count;
+    if (threads <= 1) {
+        batch_chunk(&task);
+        return !task.failed;
+    }
+
+    batch_chunk_t *chunks = (batch_chunk_t *)malloc(threads * sizeof(batch_chunk_t));
+    if (!chunks) return 0;
+    for (size_t i = 0; i != threads; ++i) {
+        chunks[i] = task;
+        chunks[i].first = count * i / threads;
+        chunks[i].last = count * (i + 1) / threads;
+    }
+    sz_bool_t success = parallel_for(batch_chunk_callback, chunks, threads);
+    for (size_t i = 0; i != threads && success; ++i) success = !chunks[i].failed;
+    free(chunks);
+    return success;
+}
+
+/**
+ *  @brief  Shared implementation of the `Strs` batch methods, that apply a `Str` method to every element,
+ *          without creating Python objects for them. The results are exported as a `memoryview`, that can
+ *          be wrapped into a NumPy array without copies, or converted into a list with `tolist()`.
+ *          The GIL is released for the duration of the batch, which runs on a private snapshot of the layout.
+ */
+static PyObject *Strs_batch_(Strs *self, batch_operation_t operation, PyObject *const *args, Py_ssize_t nargs,
+                             PyObject *kwnames) {
+    int const takes_argument = operation != batch_hash_k && operation != batch_length_k;
+    if (nargs != takes_argument) {
+        PyErr_SetString(PyExc_TypeError, "Invalid number of arguments");
+        return NULL;
+    }
+
+    PyObject *threads_obj = NULL;
+    PyObject *allowoverlap_obj = NULL;
+    PyObject *bound_obj = NULL;
+    Py_ssize_t kwargs_count = kwnames ? PyTuple_GET_SIZE(kwnames) : 0;
+    for (Py_ssize_t i = 0; i != kwargs_count; ++i) {
+        PyObject *key = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (keyword_is(key, interned_keywords.threads)) { threads_obj = value; }
+        else if (operation == batch_count_k && keyword_is(key, interned_keywords.allowoverlap)) {
+            allowoverlap_obj = value;
+        }
+        else if (operation == batch_edit_distance_k && keyword_is(key, interned_keywords.bound)) { bound_obj = value; }
+        else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key))
+            return NULL;
+    }
+
+    batch_chunk_t task;
+    memset(&task, 0, sizeof(task));
+    task.operation = operation;
+    if (takes_argument && !export_string_like(args[0], &task.argument.start, &task.argument.length)) {
+        PyErr_SetString(PyExc_TypeError, "The argument must be string-like");
+        return NULL;
+    }
+    if (allowoverlap_obj && (task.allowoverlap = PyObject_IsTrue(allowoverlap_obj)) == -1) return NULL;
+    if (bound_obj) {
+        Py_ssize_t bound = PyLong_AsSsize_t(bound_obj);
+        if (bound < 0) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError, "Bound must be a non-negative integer");
+            return NULL;
+        }
+        task.bound = (sz_size_t)bound;
+    }
+
+    // Zero threads stand for all the available cores.
+    size_t threads = 1;
+    if (threads_obj && threads_obj != Py_None) {
+        Py_ssize_t signed_threads = PyLong_AsSsize_t(threads_obj);
+        if (signed_threads < 0) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_ValueError, "The threads must be non-negative");
+            return NULL;
+        }
+        threads = signed_threads ? (size_t)signed_threads : hardware_concurrency();
+    }
+
+    strs_snapshot_t snapshot;
+    sz_bool_t copied;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    copied = strs_snapshot_init(self, &snapshot);
+    SZ_END_CRITICAL_SECTION();
+    if (!copied) return NULL;
+    task.sequence = &snapshot.sequence;
+
+    // The output is allocated as `bytes`, that will be viewed as an array of the right type
+    int const is_boolean = operation == batch_startswith_k || operation == batch_endswith_k;
+    char const *format = operation == batch_find_k ? "q" : (is_boolean ? "?" : "Q");
+    size_t const item_size = is_boolean ? 1 : 8;
+    PyObject *output = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(snapshot.sequence.count * item_size));
+    if (!output) {
+        strs_snapshot_release(&snapshot);
+        return NULL;
+    }
+    task.output = PyBytes_AS_STRING(output);
+
+    sz_bool_t success;
+    Py_BEGIN_ALLOW_THREADS;
+    success = batch_sequence(task, threads);
+    Py_END_ALLOW_THREADS;
+    strs_snapshot_release(&snapshot);
+    if (!success) {
+        Py_DECREF(output);
+        return PyErr_NoMemory();
+    }
+
+    PyObject *view = PyMemoryView_FromObject(output);
+    Py_DECREF(output);
+    if (!view) return NULL;
+    PyObject *typed_view = PyObject_CallMethod(view, "cast", "s", format);
+    Py_DECREF(view);
+    return typed_view;
+}
+
+static PyObject *Strs_find(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_find_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_count(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_count_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_startswith(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_startswith_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_endswith(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_endswith_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_hash(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_hash_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_lengths(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_length_k, args, nargs, kwnames);
+}
+
+static PyObject *Strs_edit_distance(Strs *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames) {
+    return Strs_batch_(self, batch_edit_distance_k, args, nargs, kwnames);
+}
+
+/**
+ *  @brief  Looks up the index of the first occurrence of one or many strings, or -1 for the missing ones.
+ *          A single string-like argument produces an integer. Any other sequence of strings, including
+ *          another `Strs`, produces a `memoryview` of 64-bit signed integers, like the other batch methods.
+ */
+static PyObject *Strs_index_of(Strs *self, PyObject *queries_obj) {
+    sz_string_view_t query;
+    Py_ssize_t index;
+    if (export_string_like(queries_obj, &query.start, &query.length)) {
+        SZ_BEGIN_CRITICAL_SECTION(self);
+        index = strs_lookup_find(self, query);
+        SZ_END_CRITICAL_SECTION();
+        return index == -2 ? PyErr_NoMemory() : PyLong_FromSsize_t(index);
+    }
+    // A `str` that failed to encode into UTF-8 must not be iterated as a sequence of characters
+    if (PyErr_Occurred()) return NULL;
+
+    // Other `Strs` are accessed through a private snapshot, to avoid locking two objects at once
+    strs_snapshot_t snapshot;
+    PyObject *queries = NULL;
+    sz_size_t count;
+    sz_bool_t copied = 1;
+    if (PyObject_TypeCheck(queries_obj, &StrsType)) {
+        SZ_BEGIN_CRITICAL_SECTION(queries_obj);
+        copied = strs_snapshot_init((Strs *)queries_obj, &snapshot);
+        SZ_END_CRITICAL_SECTION();
+        if (!copied) return NULL;
+        count = snapshot.sequence.count;
+    }
+    else {
+        queries = PySequence_Fast(queries_obj, "The queries must be a string or a sequence of strings");
+        if (!queries) return NULL;
+        count = (sz_size_t)PySequence_Fast_GET_SIZE(queries);
+    }
+
+    PyObject *output = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(count * sizeof(int64_t)));
+    if (!output) {
+        if (queries) Py_DECREF(queries);
+        else strs_snapshot_release(&snapshot);
+        return NULL;
+    }
+    int64_t *indices = (int64_t *)PyBytes_AS_STRING(output);
+
+    sz_bool_t is_string_like = 1;
+    index = 0;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    for (sz_size_t i = 0; i != count && index != -2 && is_string_like; ++i) {
+        if (queries) {
+            is_string_like =
+                export_string_like(PySequence_Fast_GET_ITEM(queries, (Py_ssize_t)i), &query.start, &query.length);
+        }
+        else {
+            query.start = snapshot.sequence.get_start(&snapshot.sequence, i);
+            query.length = snapshot.sequence.get_length(&snapshot.sequence, i);
+        }
+        if (is_string_like) indices[i] = index = strs_lookup_find(self, query);
+    }
+    SZ_END_CRITICAL_SECTION();
+    if (queries) Py_DECREF(queries);
+    else strs_snapshot_release(&snapshot);
+
+    if (!is_string_like || index == -2) {
+        Py_DECREF(output);
+        if (!is_string_like && !PyErr_Occurred())
+            PyErr_SetString(PyExc_TypeError, "All the queries must be string-like");
+        return is_string_like ? PyErr_NoMemory() : NULL;
+    }
+
+    PyObject *view = PyMemoryView_FromObject(output);
+    Py_DECREF(output);
+    if (!view) return NULL;
+    PyObject *typed_view = PyObject_CallMethod(view, "cast", "s", "q");
+    Py_DECREF(view);
+    return typed_view;
+}
+
+#pragma endregion
+
+static void Strs_dealloc(Strs *self) {
+    void *buffer;
+    PyObject *parent;
+    strs_lookup_reset(self);
+    strs_layout_detach(self, &buffer, &parent);
+    free(buffer);
+    Py_XDECREF(parent);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+/**
+ *  @brief  Builds a `Strs` from an iterable of `str`, `bytes`, `Str`, or `File` objects.
+ *          By default, the strings are packed one after another into a single `bytes` allocation, that starts
+ *          with their 32-bit or 64-bit end offsets, depending on the total size, like the tapes of `Strs.load`.
+ *          With `copy=False`, the strings are referenced in their sources without copies, forming the
+ *          `STRS_MULTI_SOURCE` layout.
+ *
+ *  The strings are visited twice: once to size the allocation, and once to copy them. Growing the buffer
+ *  in a single pass would copy the strings again on every reallocation, and Python strings report their
+ *  lengths in constant time. The sources are referenced from a temporary tuple, which for lists and tuples
+ *  only copies the pointers, so that the two passes see the same objects, even if the iterable changes.
+ */
+static int Strs_init(Strs *self, PyObject *args, PyObject *kwargs) {
+
+    // Parse all arguments into PyObjects first
+    Py_ssize_t nargs = PyTuple_Size(args);
+    if (nargs > 2) {
+        PyErr_SetString(PyExc_TypeError, "Invalid number of arguments");
+        return -1;
+    }
+    PyObject *strings_obj = nargs >= 1 ? PyTuple_GET_ITEM(args, 0) : NULL;
+    PyObject *copy_obj = nargs >= 2 ? PyTuple_GET_ITEM(args, 1) : NULL;
+    if (kwargs) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (PyUnicode_CompareWithASCIIString(key, "strings") == 0) {
+                if (strings_obj) {
+                    PyErr_SetString(PyExc_TypeError, "Received `strings` both as positional and keyword argument");
+                    return -1;
+                }
+                strings_obj = value;
+            }
+            else if (PyUnicode_CompareWithASCIIString(key, "copy") == 0) {
+                if (copy_obj) {
+                    PyErr_SetString(PyExc_TypeError, "Received `copy` both as positional and keyword argument");
+                    return -1;
+                }
+                copy_obj = value;
+            }
+            else if (!PyErr_Format(PyExc_TypeError, "Received an unexpected keyword argument '%U'", key))
+                return -1;
+        }
+    }
+    int copy = 1;
+    if (copy_obj && (copy = PyObject_IsTrue(copy_obj)) == -1) return -1;
+
+    // An empty collection needs no allocations
+    Strs fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    fresh.type = STRS_CONSECUTIVE_32;
+
+    // The tuple holds references to the sources, even if the iterable is modified by another thread
+    PyObject *sources = strings_obj ? PySequence_Tuple(strings_obj) : NULL;
+    if (strings_obj && !sources) return -1;
+    size_t const count = sources ? (size_t)PyTuple_GET_SIZE(sources) : 0;
+
+    // Find the total length of all strings, to size the tape
+    size_t total_length = 0;
+    for (size_t i = 0; i != count; ++i) {
+        sz_cptr_t start;
+        sz_size_t length;
+        PyObject *source = PyTuple_GET_ITEM(sources, (Py_ssize_t)i);
+        if (!export_string_like(source, &start, &length)) {
+            Py_DECREF(sources);
+            PyErr_Format(PyExc_TypeError, "Strs can only contain `str`, `bytes`, `Str`, or `File`, got '%s' at %zu",
+                         Py_TYPE(source)->tp_name, i);
+            return -1;
+        }
+        total_length += length;
+    }
+
+    if (count && !copy) {
+        sz_string_view_t *parts = (sz_string_view_t *)malloc(count * sizeof(sz_string_view_t));
+        if (!parts) {
+            Py_DECREF(sources);
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (size_t i = 0; i != count; ++i)
+            export_string_like(PyTuple_GET_ITEM(sources, (Py_ssize_t)i), &parts[i].start, &parts[i].length);
+        fresh.type = STRS_MULTI_SOURCE;
+        fresh.data.reordered.count = count;
+        fresh.data.reordered.parts = parts;
+        fresh.data.reordered.parent = sources;
+        sources = NULL; // The reference is now owned by the layout
+    }
+    else if (count) {
+        // Allocate the offsets and the tape at once, padding the offsets to 8 bytes, and pack the strings into it
+        sz_bool_t const is_32bit = total_length < UINT32_MAX;
+        size_t const offsets_length = (count * (is_32bit ? sizeof(uint32_t) : sizeof(uint64_t)) + 7) / 8 * 8;
+        PyObject *tape = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(offsets_length + total_length));
+        if (!tape) {
+            Py_DECREF(sources);
+            return -1;
+        }
+        void *end_offsets = PyBytes_AS_STRING(tape);
+        char *tape_start = PyBytes_AS_STRING(tape) + offsets_length;
+        size_t running_offset = 0;
+        for (size_t i = 0; i != count; ++i) {
+            sz_cptr_t start;
+            sz_size_t length;
+            export_string_like(PyTuple_GET_ITEM(sources, (Py_ssize_t)i), &start, &length);
+            // A `Str` can be re-initialized by another thread, so guard against outgrowing the tape
+            if (length > total_length - running_offset) {
+                Py_DECREF(tape);
+                Py_DECREF(sources);
+                PyErr_SetString(PyExc_RuntimeError, "The strings have changed during the construction");
+                return -1;
+            }
+            memcpy(tape_start + running_offset, start, length);
+            running_offset += length;
+            if (is_32bit) ((uint32_t *)end_offsets)[i] = (uint32_t)running_offset;
+            else ((uint64_t *)end_offsets)[i] = (uint64_t)running_offset;
+        }
+        if (is_32bit) {
+            fresh.type = STRS_CONSECUTIVE_32;
+            fresh.data.consecutive_32bit.count = count;
+            fresh.data.consecutive_32bit.parent = tape;
+            fresh.data.consecutive_32bit.start = tape_start;
+            fresh.data.consecutive_32bit.end_offsets = (uint32_t *)end_offsets;
+        }
+        else {
+            fresh.type = STRS_CONSECUTIVE_64;
+            fresh.data.consecutive_64bit.count = count;
+            fresh.data.consecutive_64bit.parent = tape;
+            fresh.data.consecutive_64bit.start = tape_start;
+            fresh.data.consecutive_64bit.end_offsets = (uint64_t *)end_offsets;
+        }
+        fresh.borrows_offsets = 1;
+    }
+    Py_XDECREF(sources);
+
+    // Swap the layouts, releasing the previous one, if the object is re-initialized
+    void *old_buffer;
+    PyObject *old_parent;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    strs_layout_detach(self, &old_buffer, &old_parent);
+    strs_lookup_reset(self);
+    self->type = fresh.type;
+    self->data = fresh.data;
+    self->borrows_offsets = fresh.borrows_offsets;
+    SZ_END_CRITICAL_SECTION();
+    free(old_buffer);
+    Py_XDECREF(old_parent);
+    return 0;
+}
+
+#pragma region Apache Arrow Interoperability
+
+/**
+ *  @brief  Memory owned by an exported Arrow array: the buffer pointers, the offsets, and, unless
+ *          the strings are referenced in the `parent` without copies, the compacted string contents.
+ */
+typedef struct {
+    void const *buffers[3];
+    void *offsets;
+    void *values;
+    PyObject *parent;
+} strs_arrow_private_t;
+
+static void strs_arrow_release_schema(struct ArrowSchema *schema) { schema->release = NULL; }
+
+static void strs_arrow_release_array(struct ArrowArray *array) {
+    strs_arrow_private_t *private_data = (strs_arrow_private_t *)array->private_data;
+    free(private_data->offsets);
+    free(private_data->values);
+    // Consumers may release the array from any thread, even without the GIL
+    if (private_data->parent) {
+        PyGILState_STATE gil_state = PyGILState_Ensure();
+        Py_DECREF(private_data->parent);
+        PyGILState_Release(gil_state);
+    }
+    free(private_data);
+    array->release = NULL;
+}
+
+static void strs_arrow_schema_capsule_destructor(PyObject *capsule) {
+    struct ArrowSchema *schema = (struct ArrowSchema *)PyCapsule_GetPointer(capsule, "arrow_schema");
+    if (schema->release) schema->release(schema);
+    free(schema);
+}
+
+static void strs_arrow_array_capsule_destructor(PyObject *capsule) {
+    struct ArrowArray *array = (struct ArrowArray *)PyCapsule_GetPointer(capsule, "arrow_array");
+    if (array->release) array->release(array);
+    free(array);
+}
+
+/**
+ *  @brief  Fills the Arrow offsets and values for a `Strs`, which the caller must lock. Consecutive slices
+ *          without separators between them are exported without copying the strings, referencing the `parent`.
+ *          Other layouts are compacted into a new values buffer.
+ */
+static sz_bool_t Strs_export_arrow_(Strs *self, sz_bool_t large, strs_arrow_private_t *private_data,
+                                    size_t *count_output) {
+    get_string_at_offset_t getter = str_at_offset_getter(self);
+    if (!getter) {
+        PyErr_SetString(PyExc_TypeError, "Unknown Strs kind");
+        return 0;
+    }
+    size_t const count = (size_t)Strs_len(self);
+    size_t const offset_size = large ? sizeof(int64_t) : sizeof(int32_t);
+    private_data->offsets = malloc((count + 1) * offset_size);
+    if (!private_data->offsets) {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    // The consecutive layouts without separators are already shaped like Arrow values
+    sz_cptr_t consecutive_start = NULL;
+    PyObject *parent = NULL;
+    if (self->type == STRS_CONSECUTIVE_32 && !self->data.consecutive_32bit.separator_length)
+        consecutive_start = self->data.consecutive_32bit.start, parent = self->data.consecutive_32bit.parent;
+    else if (self->type == STRS_CONSECUTIVE_64 && !self->data.consecutive_64bit.separator_length)
+        consecutive_start = self->data.consecutive_64bit.start, parent = self->data.consecutive_64bit.parent;
+
+    // Otherwise, compute the total length of the strings to compact them
+    size_t total_length = 0;
+    char *values = NULL;
+    if (!parent) {
+        for (size_t i = 0; i != count; ++i) {
+            PyObject *part_parent;
+            char const *start;
+            size_t length;
+            getter(self, (Py_ssize_t)i, (Py_ssize_t)count, &part_parent, &start, &length);
+            total_length += length;
+        }
+        if (!large && total_length > INT32_MAX) {
+            PyErr_SetString(PyExc_OverflowError, "The strings don't fit into 32-bit offsets, use `large_string`");
+            return 0;
+        }
+        values = (char *)malloc(total_length ? total_length : 1);
+        if (!values) {
+            PyErr_NoMemory();
+            return 0;
+        }
+        private_data->values = values;
+    }
+
+    size_t running_offset = 0;
+    if (large) ((int64_t *)private_data->offsets)[0] = 0;
+    else ((int32_t *)private_data->offsets)[0] = 0;
+    for (size_t i = 0; i != count; ++i) {
+        PyObject *part_parent;
+        char const *start;
+        size_t length;
+        getter(self, (Py_ssize_t)i, (Py_ssize_t)count, &part_parent, &start, &length);
+        if (parent) { running_offset = (size_t)(start - consecutive_start) + length; }
+        else {
+            memcpy(values + running_offset, start, length);
+            running_offset += length;
+        }
+        if (!large && running_offset > INT32_MAX) {
+            PyErr_SetString(PyExc_OverflowError, "The strings don't fit into 32-bit offsets, use `large_string`");
+            return 0;
+        }
+        if (large) ((int64_t *)private_data->offsets)[i + 1] = (int64_t)running_offset;
+        else ((int32_t *)private_data->offsets)[i + 1] = (int32_t)running_offset;
+    }
+
+    private_data->buffers[0] = NULL; // No validity bitmap, as there are no nulls
+    private_data->buffers[1] = private_data->offsets;
+    private_data->buffers[2] = parent ? (void const *)consecutive_start : (void const *)values;
+    if (parent) {
+        Py_INCREF(parent);
+        private_data->parent = parent;
+    }
+    *count_output = count;
+    return 1;
+}
+
+/**
+ *  @brief  Implements the Arrow PyCapsule Interface, exporting the strings as a `string` array with 32-bit offsets,
+ *          or `large_string` with 64-bit ones, if they don't fit. The `requested_schema` may ask for either,
+ *          or for their `binary` and `large_binary` counterparts.
+ *  https://arrow.apache.org/docs/format/CDataInterface/PyCapsuleInterface.html
+ */
+static PyObject *Strs_arrow_c_array(Strs *self, PyObject *args, PyObject *kwargs) {
+    PyObject *requested_schema_obj = PyTuple_Size(args) ? PyTuple_GET_ITEM(args, 0) : NULL;
+    if (PyTuple_Size(args) > 1) {
+        PyErr_SetString(PyExc_TypeError, "__arrow_c_array__() takes at most 1 positional argument");
+        return NULL;
+    }
+    if (kwargs) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (PyUnicode_CompareWithASCIIString(key, "requested_schema") == 0) { requested_schema_obj = value; }
+            else {
+                PyErr_Format(PyExc_TypeError, "Received an unexpected keyword argument '%U'", key);
+                return NULL;
+            }
+        }
+    }
+
+    // The requested schema is a hint, so unsupported formats are ignored, as the protocol allows
+    char const *requested_format = NULL;
+    if (requested_schema_obj && requested_schema_obj != Py_None) {
+        struct ArrowSchema *requested_schema =
+            (struct ArrowSchema *)PyCapsule_GetPointer(requested_schema_obj, "arrow_schema");
+        if (!requested_schema) return NULL;
+        requested_format = requested_schema->format;
+    }
+    sz_bool_t is_binary = requested_format && (!strcmp(requested_format, "z") || !strcmp(requested_format, "Z"));
+    sz_bool_t is_large = requested_format && (!strcmp(requested_format, "U") || !strcmp(requested_format, "Z"));
+    sz_bool_t is_small = requested_format && (!strcmp(requested_format, "u") || !strcmp(requested_format, "z"));
+
+    struct ArrowSchema *schema = (struct ArrowSchema *)calloc(1, sizeof(struct ArrowSchema));
+    struct ArrowArray *array = (struct ArrowArray *)calloc(1, sizeof(struct ArrowArray));
+    strs_arrow_private_t *private_data = (strs_arrow_private_t *)calloc(1, sizeof(strs_arrow_private_t));
+    if (!schema || !array || !private_data) {
+        free(schema), free(array), free(private_data);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // Without a preference, prefer 32-bit offsets, unless the strings don't fit into them
+    size_t count = 0;
+    sz_bool_t exported;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    exported = Strs_export_arrow_(self, is_large, private_data, &count);
+    if (!exported && !is_large && !is_small && PyErr_ExceptionMatches(PyExc_OverflowError)) {
+        PyErr_Clear();
+        free(private_data->offsets), free(private_data->values);
+        memset(private_data, 0, sizeof(strs_arrow_private_t));
+        is_large = 1;
+        exported = Strs_export_arrow_(self, is_large, private_data, &count);
+    }
+    SZ_END_CRITICAL_SECTION();
+    if (!exported) {
+        free(private_data->offsets), free(private_data->values);
+        free(schema), free(array), free(private_data);
+        return NULL;
+    }
+
+    schema->format = is_binary ? (is_large ? "Z" : "z") : (is_large ? "U" : "u");
+    schema->name = "";
+    schema->flags = ARROW_FLAG_NULLABLE;
+    schema->release = &strs_arrow_release_schema;
+
+    array->length = (int64_t)count;
+    array->n_buffers = 3;
+    array->buffers = private_data->buffers;
+    array->private_data = private_data;
+    array->release = &strs_arrow_release_array;
+
+    PyObject *schema_capsule = PyCapsule_New(schema, "arrow_schema", &strs_arrow_schema_capsule_destructor);
+    if (!schema_capsule) {
+        array->release(array);
+        free(array), free(schema);
+        return NULL;
+    }
+    PyObject *array_capsule = PyCapsule_New(array, "arrow_array", &strs_arrow_array_capsule_destructor);
+    if (!array_capsule) {
+        array->release(array);
+        free(array);
+        Py_DECREF(schema_capsule);
+        return NULL;
+    }
+    return Py_BuildValue("NN", schema_capsule, array_capsule);
+}
+
+/**
+ *  @brief  Imports any object, implementing the Arrow PyCapsule Interface, like a `pyarrow.Array`, if its type is
+ *          `string`, `large_string`, `binary`, or `large_binary`. The strings aren't copied, only the offsets,
+ *          and the imported array is kept alive until the last `Strs` or `Str` referencing it is gone.
+ */
+static PyObject *Strs_from_arrow(PyObject *cls, PyObject *source) {
+    if (!PyObject_HasAttrString(source, "__arrow_c_array__")) {
+        PyErr_SetString(PyExc_TypeError, "The source must implement the Arrow PyCapsule Interface");
+        return NULL;
+    }
+    PyObject *capsules = PyObject_CallMethod(source, "__arrow_c_array__", NULL);
+    if (!capsules) return NULL;
+    if (!PyTuple_Check(capsules) || PyTuple_GET_SIZE(capsules) != 2) {
+        Py_DECREF(capsules);
+        PyErr_SetString(PyExc_TypeError, "The __arrow_c_array__ must return a pair of capsules");
+        return NULL;
+    }
+    PyObject *schema_capsule = PyTuple_GET_ITEM(capsules, 0);
+    PyObject *array_capsule = PyTuple_GET_ITEM(capsules, 1);
+    struct ArrowSchema *schema = (struct ArrowSchema *)PyCapsule_GetPointer(schema_capsule, "arrow_schema");
+    struct ArrowArray *array = (struct ArrowArray *)PyCapsule_GetPointer(array_capsule, "arrow_array");
+    if (!schema || !array) {
+        Py_DECREF(capsules);
+        return NULL;
+    }
+
+    char const *format = schema->format;
+    sz_bool_t is_small = !strcmp(format, "u") || !strcmp(format, "z");
+    sz_bool_t is_large = !strcmp(format, "U") || !strcmp(format, "Z");
+    if (!is_small && !is_large) {
+        PyErr_Format(PyExc_TypeError, "Only the Arrow string and binary arrays are supported, not '%s'", format);
+        Py_DECREF(capsules);
+        return NULL;
+    }
+    if (array->null_count != 0 && array->buffers[0]) {
+        PyErr_SetString(PyExc_ValueError, "Arrow arrays with nulls can't be imported into Strs");
+        Py_DECREF(capsules);
+        return NULL;
+    }
+
+    Strs *result = (Strs *)StrsType.tp_alloc(&StrsType, 0);
+    if (!result) {
+        Py_DECREF(capsules);
+        return NULL;
+    }
+
+    // Rebase the offsets to the first string, as the array may be a slice of a bigger one
+    size_t const count = (size_t)array->length;
+    char const *values = (char const *)array->buffers[2];
+    if (is_small) {
+        int32_t const *offsets = (int32_t const *)array->buffers[1] + array->offset;
+        uint32_t *end_offsets = (uint32_t *)malloc(sizeof(uint32_t) * (count ? count : 1));
+        if (!end_offsets) {
+            Py_DECREF(result);
+            Py_DECREF(capsules);
+            return PyErr_NoMemory();
+        }
+        for (size_t i = 0; i != count; ++i) end_offsets[i] = (uint32_t)(offsets[i + 1] - offsets[0]);
+        result->type = STRS_CONSECUTIVE_32;
+        result->data.consecutive_32bit.count = count;
+        result->data.consecutive_32bit.separator_length = 0;
+        result->data.consecutive_32bit.start = values ? values + offsets[0] : NULL;
+        result->data.consecutive_32bit.end_offsets = end_offsets;
+        result->data.consecutive_32bit.parent = array_capsule;
+    }
+    else {
+        int64_t const *offsets = (int64_t const *)array->buffers[1] + array->offset;
+        uint64_t *end_offsets = (uint64_t *)malloc(sizeof(uint64_t) * (count ? count : 1));
+        if (!end_offsets) {
+            Py_DECREF(result);
+            Py_DECREF(capsules);
+            return PyErr_NoMemory();
+        }
+        for (size_t i = 0; i != count; ++i) end_offsets[i] = (uint64_t)(offsets[i + 1] - offsets[0]);
+        result->type = STRS_CONSECUTIVE_64;
+        result->data.consecutive_64bit.count = count;
+        result->data.consecutive_64bit.separator_length = 0;
+        result->data.consecutive_64bit.start = values ? values + offsets[0] : NULL;
+        result->data.consecutive_64bit.end_offsets = end_offsets;
+        result->data.consecutive_64bit.parent = array_capsule;
+    }
+
+    // The array capsule releases the imported memory once its last reference is gone
+    Py_INCREF(array_capsule);
+    Py_DECREF(capsules);
+    return (PyObject *)result;
+}
+
+#pragma endregion
+
+#pragma region Persistence
+
+/**
+ *  @brief  Callback for `sz_tape_write`, appending the bytes to the `FILE` passed as @p user.
+ */
+static sz_bool_t strs_save_write(sz_cptr_t data, sz_size_t length, void *user) {
+    return (sz_bool_t)(fwrite(data, 1, length, (FILE *)user) == length);
+}
+
+static PyObject *Strs_save(Strs *self, PyObject *path_obj) {
+    char const *path = PyUnicode_Check(path_obj) ? PyUnicode_AsUTF8(path_obj) : NULL;
+    if (!path) {
+        if (!PyErr_Occurred()) PyErr_SetString(PyExc_TypeError, "The path must be a string");
+        return NULL;
+    }
+
+    strs_snapshot_t snapshot;
+    sz_bool_t copied;
+    SZ_BEGIN_CRITICAL_SECTION(self);
+    copied = strs_snapshot_init(self, &snapshot);
+    SZ_END_CRITICAL_SECTION();
+    if (!copied) return NULL;
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        strs_snapshot_release(&snapshot);
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+    sz_bool_t saved;
+    int error;
+    Py_BEGIN_ALLOW_THREADS;
+    saved = sz_tape_write(&snapshot.sequence, strs_save_write, file);
+    saved = (fclose(file) == 0) && saved;
+    error = errno;
+    Py_END_ALLOW_THREADS;
+    strs_snapshot_release(&snapshot);
+    if (!saved) {
+        errno = error;
+        return PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    }
+    Py_RETURN_NONE;
+}
+
+/**
+ *  @brief  Maps a file written by `Strs.save` into memory, referencing both the strings and their offsets
+ *          in the mapping, without parsing or copying them. Unless `validate` is false, checks that the
+ *          offsets never decrease in a single pass without the GIL, so a corrupted file can't be read out of bounds.
+ */
+static PyObject *Strs_load(PyObject *cls, PyObject *args, PyObject *kwargs) {
+    Py_ssize_t args_count = PyTuple_Size(args);
+    if (args_count < 1 || args_count > 2) {
+        PyErr_SetString(PyExc_TypeError, "Expects a path and an optional `validate` flag");
+        return NULL;
+    }
+    PyObject *path_obj = PyTuple_GET_ITEM(args, 0);
+    PyObject *validate_obj = args_count > 1 ? PyTuple_GET_ITEM(args, 1) : NULL;
+    if (kwargs) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(kwargs, &pos, &key, &value)) {
+            if (PyUnicode_CompareWithASCIIString(key, "validate") == 0) {
+                if (validate_obj) {
+                    PyErr_SetString(PyExc_TypeError, "Received `validate` both as positional and keyword argument");
+                    return NULL;
+                }
+                validate_obj = value;
+            }
+            else if (!PyErr_Format(PyExc_TypeError, "Got an unexpected keyword argument '%U'", key)) { return NULL; }
+        }
+    }
+    int validate = validate_obj ? PyObject_IsTrue(validate_obj) : 1;
+    if (validate == -1) return NULL;
+
+    File *file = (File *)PyObject_CallFunctionObjArgs((PyObject *)&FileType, path_obj, NULL);
+    if (!file) return NULL;
+    sz_tape_t tape;
+    sz_bool_t is_valid = sz_tape_view(&tape, file->start, file->length);
+    if (is_valid && validate) {
+        Py_BEGIN_ALLOW_THREADS;
+        is_valid = sz_tape_validate(&tape);
+        Py_END_ALLOW_THREADS;
+    }
+    if (!is_valid) {
+        Py_DECREF(file);
+        PyErr_Format(PyExc_ValueError, "The file '%S' wasn't written by `Strs.save` or is corrupted", path_obj);
+        return NULL;
+    }
+
+    Strs *result = (Strs *)StrsType.tp_alloc(&StrsType, 0);
+    if (!result) {
+        Py_DECREF(file);
+        return NULL;
+    }
+
+    // The offsets in the file start with a zero, while `Strs` only keeps the end offsets
+    if (tape.offset_size == 4) {
+        result->type = STRS_CONSECUTIVE_32;
+        result->data.consecutive_32bit.count = tape.count;
+        result->data.consecutive_32bit.separator_length = 0;
+        result->data.consecutive_32bit.parent = (PyObject *)file;
+        result->data.consecutive_32bit.start = tape.data;
+        result->data.consecutive_32bit.end_offsets = (uint32_t *)tape.offsets + 1;
+    }
+    else {
+        result->type = STRS_CONSECUTIVE_64;
+        result->data.consecutive_64bit.count = tape.count;
+        result->data.consecutive_64bit.separator_length = 0;
+        result->data.consecutive_64bit.parent = (PyObject *)file;
+        result->data.consecutive_64bit.start = tape.data;
+        result->data.consecutive_64bit.end_offsets = (uint64_t *)tape.offsets + 1;
+    }
+    result->borrows_offsets = 1;
+    return (PyObject *)result;
+}
+
+#pragma endregion
+
 static PySequenceMethods Strs_as_sequence = {
     .sq_length = Strs_len,        //
     .sq_item = Strs_getitem,      //
@@ -2113,17 +4122,47 @@ static PyMappingMethods Strs_as_mapping = {
 
 static PyMethodDef Strs_methods[] = {
     {"shuffle", Strs_shuffle, SZ_METHOD_FLAGS, "Shuffle the elements of the Strs object."},  //
-    {"sort", Strs_sort, SZ_METHOD_FLAGS, "Sort the elements of the Strs object."},           //
-    {"order", Strs_order, SZ_METHOD_FLAGS, "Provides the indexes to achieve sorted order."}, //
+    {"sort", Strs_sort, SZ_METHOD_FLAGS,
+     "Sort the elements of the Strs object. With `top_k`, only the first `top_k` are guaranteed to be sorted. "
+     "With `threads`, sorts in that many threads, all cores if zero."},
+    {"order", Strs_order, SZ_METHOD_FLAGS,
+     "Provides the indexes to achieve sorted order. With `top_k`, only the first `top_k` indexes are returned. "
+     "With `threads`, sorts in that many threads, all cores if zero."},
+    {"find", (PyCFunction)Strs_find, SZ_FASTCALL_FLAGS,
+     "Find the first occurrence of a substring in every string, returning offsets or -1. "
+     "With `threads`, runs in that many threads, all cores if zero."},
+    {"count", (PyCFunction)Strs_count, SZ_FASTCALL_FLAGS,
+     "Count the occurrences of a substring in every string, optionally `allowoverlap`."},
+    {"startswith", (PyCFunction)Strs_startswith, SZ_FASTCALL_FLAGS, "Check if every string starts with a prefix."},
+    {"endswith", (PyCFunction)Strs_endswith, SZ_FASTCALL_FLAGS, "Check if every string ends with a suffix."},
+    {"hash", (PyCFunction)Strs_hash, SZ_FASTCALL_FLAGS, "Hash every string, like the `sz.hash`."},
+    {"lengths", (PyCFunction)Strs_lengths, SZ_FASTCALL_FLAGS, "Get the length of every string in bytes."},
+    {"edit_distance", (PyCFunction)Strs_edit_distance, SZ_FASTCALL_FLAGS,
+     "Compute the Levenshtein distance between every string and another one, optionally limited by a `bound`."},
+    {"index_of", (PyCFunction)Strs_index_of, METH_O,
+     "Find the index of the first occurrence of a string, or of every string in a sequence, or -1 if missing. "
+     "Builds a hash index on the first lookup, reused until the collection is reordered."},
+    {"__arrow_c_array__", (PyCFunction)Strs_arrow_c_array, SZ_METHOD_FLAGS,
+     "Export the strings as an Apache Arrow `string` array, following the Arrow PyCapsule Interface."},
+    {"from_arrow", Strs_from_arrow, METH_O | METH_CLASS,
+     "Import an Apache Arrow string or binary array, without copying the strings."},
+    {"save", (PyCFunction)Strs_save, METH_O,
+     "Write the strings and their offsets into a file, that `Strs.load` can memory-map without parsing."},
+    {"load", (PyCFunction)Strs_load, SZ_METHOD_FLAGS | METH_CLASS,
+     "Memory-map a file written by `Strs.save`, referencing the strings and the offsets in place. "
+     "Unless `validate` is false, checks all of the offsets in linear time."},
     {NULL, NULL, 0, NULL}};
 
 static PyTypeObject StrsType = {
     PyVarObject_HEAD_INIT(NULL, 0).tp_name = "stringzilla.Strs",
-    .tp_doc = "Space-efficient container for large collections of strings and their slices",
+    .tp_doc = "Space-efficient container for large collections of strings and their slices. "
+              "Build it from an iterable of strings, packed into one buffer, or referenced in place with `copy=False`",
     .tp_basicsize = sizeof(Strs),
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)Strs_init,
+    .tp_dealloc = (destructor)Strs_dealloc,
     .tp_methods = Strs_methods,
     .tp_as_sequence = &Strs_as_sequence,
     .tp_as_mapping = &Strs_as_mapping,
@@ -2132,27 +4171,36 @@ static PyTypeObject StrsType = {
 #pragma endregion
 
 static void stringzilla_cleanup(PyObject *m) {
-    if (temporary_memory.start) free(temporary_memory.start);
-    temporary_memory.start = NULL;
-    temporary_memory.length = 0;
+    temporary_memory_key_delete();
+    Py_CLEAR(interned_keywords.start);
+    Py_CLEAR(interned_keywords.end);
+    Py_CLEAR(interned_keywords.allowoverlap);
+    Py_CLEAR(interned_keywords.threads);
+    Py_CLEAR(interned_keywords.bound);
 }
 
 static PyMethodDef stringzilla_methods[] = {
     // Basic `str`-like functionality
-    {"contains", Str_contains, SZ_METHOD_FLAGS, "Check if a string contains a substring."},
-    {"count", Str_count, SZ_METHOD_FLAGS, "Count the occurrences of a substring."},
+    {"contains", (PyCFunction)Str_contains, SZ_FASTCALL_FLAGS, "Check if a string contains a substring."},
+    {"count", (PyCFunction)Str_count, SZ_FASTCALL_FLAGS, "Count the occurrences of a substring."},
     {"splitlines", Str_splitlines, SZ_METHOD_FLAGS, "Split a string by line breaks."},
-    {"startswith", Str_startswith, SZ_METHOD_FLAGS, "Check if a string starts with a given prefix."},
-    {"endswith", Str_endswith, SZ_METHOD_FLAGS, "Check if a string ends with a given suffix."},
+    {"startswith", (PyCFunction)Str_startswith, SZ_FASTCALL_FLAGS, "Check if a string starts with a given prefix."},
+    {"endswith", (PyCFunction)Str_endswith, SZ_FASTCALL_FLAGS, "Check if a string ends with a given suffix."},
     {"split", Str_split, SZ_METHOD_FLAGS, "Split a string by a separator."},
+    {"split_iter", Str_split_iter, SZ_METHOD_FLAGS,
+     "Lazily split a string by a separator, yielding `Strs` batches of up to `batch_size` parts."},
 
     // Bidirectional operations
-    {"find", Str_find, SZ_METHOD_FLAGS, "Find the first occurrence of a substring."},
-    {"index", Str_index, SZ_METHOD_FLAGS, "Find the first occurrence of a substring or raise error if missing."},
-    {"partition", Str_partition, SZ_METHOD_FLAGS, "Splits string into 3-tuple: before, first match, after."},
-    {"rfind", Str_rfind, SZ_METHOD_FLAGS, "Find the last occurrence of a substring."},
-    {"rindex", Str_rindex, SZ_METHOD_FLAGS, "Find the last occurrence of a substring or raise error if missing."},
-    {"rpartition", Str_rpartition, SZ_METHOD_FLAGS, "Splits string into 3-tuple: before, last match, after."},
+    {"find", (PyCFunction)Str_find, SZ_FASTCALL_FLAGS, "Find the first occurrence of a substring."},
+    {"index", (PyCFunction)Str_index, SZ_FASTCALL_FLAGS,
+     "Find the first occurrence of a substring or raise error if missing."},
+    {"partition", (PyCFunction)Str_partition, SZ_FASTCALL_FLAGS,
+     "Splits string into 3-tuple: before, first match, after."},
+    {"rfind", (PyCFunction)Str_rfind, SZ_FASTCALL_FLAGS, "Find the last occurrence of a substring."},
+    {"rindex", (PyCFunction)Str_rindex, SZ_FASTCALL_FLAGS,
+     "Find the last occurrence of a substring or raise error if missing."},
+    {"rpartition", (PyCFunction)Str_rpartition, SZ_FASTCALL_FLAGS,
+     "Splits string into 3-tuple: before, last match, after."},
 
     // Edit distance extensions
     {"hamming_distance", Str_hamming_distance, SZ_METHOD_FLAGS,
@@ -2167,17 +4215,17 @@ static PyMethodDef stringzilla_methods[] = {
      "Needleman-Wunsch alignment score given a substitution cost matrix."},
 
     // Character search extensions
-    {"find_first_of", Str_find_first_of, SZ_METHOD_FLAGS,
+    {"find_first_of", (PyCFunction)Str_find_first_of, SZ_FASTCALL_FLAGS,
      "Finds the first occurrence of a character from another string."},
-    {"find_last_of", Str_find_last_of, SZ_METHOD_FLAGS,
+    {"find_last_of", (PyCFunction)Str_find_last_of, SZ_FASTCALL_FLAGS,
      "Finds the last occurrence of a character from another string."},
-    {"find_first_not_of", Str_find_first_not_of, SZ_METHOD_FLAGS,
+    {"find_first_not_of", (PyCFunction)Str_find_first_not_of, SZ_FASTCALL_FLAGS,
      "Finds the first occurrence of a character not present in another string."},
-    {"find_last_not_of", Str_find_last_not_of, SZ_METHOD_FLAGS,
+    {"find_last_not_of", (PyCFunction)Str_find_last_not_of, SZ_FASTCALL_FLAGS,
      "Finds the last occurrence of a character not present in another string."},
 
     // Global unary extensions
-    {"hash", Str_like_hash, SZ_METHOD_FLAGS, "Hash a string or a byte-array."},
+    {"hash", (PyCFunction)Str_like_hash, SZ_FASTCALL_FLAGS, "Hash a string or a byte-array."},
 
     {NULL, NULL, 0, NULL}};
 
@@ -2199,10 +4247,17 @@ PyMODINIT_FUNC PyInit_stringzilla(void) {
     if (PyType_Ready(&StrType) < 0) return NULL;
     if (PyType_Ready(&FileType) < 0) return NULL;
     if (PyType_Ready(&StrsType) < 0) return NULL;
+    if (PyType_Ready(&SplitIteratorType) < 0) return NULL;
 
     m = PyModule_Create(&stringzilla_module);
     if (m == NULL) return NULL;
 
+#ifdef Py_GIL_DISABLED
+    // The scratch space is per-thread and the mutable `Strs` are guarded by critical sections,
+    // so the interpreter doesn't need to re-enable the GIL when importing this module.
+    PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+#endif
+
     // Add version metadata
     {
         char version_str[50];
@@ -2222,9 +4277,11 @@ PyMODINIT_FUNC PyInit_stringzilla(void) {
         char const *avx512f = (caps & sz_cap_x86_avx512f_k) ? "avx512f," : "";
         char const *avx512vl = (caps & sz_cap_x86_avx512vl_k) ? "avx512vl," : "";
         char const *avx512bw = (caps & sz_cap_x86_avx512bw_k) ? "avx512bw," : "";
+        char const *avx512dq = (caps & sz_cap_x86_avx512dq_k) ? "avx512dq," : "";
         char const *avx512vbmi = (caps & sz_cap_x86_avx512vbmi_k) ? "avx512vbmi," : "";
         char const *gfni = (caps & sz_cap_x86_gfni_k) ? "gfni," : "";
-        sprintf(caps_str, "%s%s%s%s%s%s%s%s%s", serial, neon, sve, avx2, avx512f, avx512vl, avx512bw, avx512vbmi, gfni);
+        sprintf(caps_str, "%s%s%s%s%s%s%s%s%s%s", serial, neon, sve, avx2, avx512f, avx512vl, avx512bw, avx512dq,
+                avx512vbmi, gfni);
         PyModule_AddStringConstant(m, "__capabilities__", caps_str);
     }
 
@@ -2252,8 +4309,23 @@ PyMODINIT_FUNC PyInit_stringzilla(void) {
         return NULL;
     }
 
-    // Initialize temporary_memory, if needed
-    temporary_memory.start = malloc(4096);
-    temporary_memory.length = 4096 * (temporary_memory.start != NULL);
+    // Intern the keyword argument names for the `METH_FASTCALL` methods
+    interned_keywords.start = PyUnicode_InternFromString("start");
+    interned_keywords.end = PyUnicode_InternFromString("end");
+    interned_keywords.allowoverlap = PyUnicode_InternFromString("allowoverlap");
+    interned_keywords.threads = PyUnicode_InternFromString("threads");
+    interned_keywords.bound = PyUnicode_InternFromString("bound");
+    if (!interned_keywords.start || !interned_keywords.end || !interned_keywords.allowoverlap ||
+        !interned_keywords.threads || !interned_keywords.bound) {
+        Py_XDECREF(m);
+        return NULL;
+    }
+
+    // Initialize the per-thread `temporary_memory`, allocated lazily on first use
+    if (!temporary_memory_key_create()) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create the thread-local storage key");
+        Py_XDECREF(m);
+        return NULL;
+    }
     return m;
 }
@@ -0,0 +1,59 @@
+import time
+import random
+from typing import List
+
+import fire
+
+import stringzilla as sz
+from stringzilla import Str
+
+
+def log(name: str, tokens: List, operator: callable, repetitions: int):
+    a = time.perf_counter_ns()
+    for _ in range(repetitions):
+        for token in tokens:
+            operator(token)
+    b = time.perf_counter_ns()
+    calls = len(tokens) * repetitions
+    print(f"{name}: {(b - a) / calls:.1f} ns per call")
+
+
+def log_functionality(pythonic_tokens: List[str], stringzilla_tokens: List[Str], repetitions: int):
+    log("str.find", pythonic_tokens, lambda t: t.find("e"), repetitions)
+    log("Str.find", stringzilla_tokens, lambda t: t.find("e"), repetitions)
+    log("sz.find", pythonic_tokens, lambda t: sz.find(t, "e"), repetitions)
+    log("str.find(start=)", pythonic_tokens, lambda t: t.find("e", 1), repetitions)
+    log("Str.find(start=)", stringzilla_tokens, lambda t: t.find("e", start=1), repetitions)
+    log("str.count", pythonic_tokens, lambda t: t.count("e"), repetitions)
+    log("Str.count", stringzilla_tokens, lambda t: t.count("e"), repetitions)
+    log("str.startswith", pythonic_tokens, lambda t: t.startswith("th"), repetitions)
+    log("Str.startswith", stringzilla_tokens, lambda t: t.startswith("th"), repetitions)
+    log("str.endswith", pythonic_tokens, lambda t: t.endswith("ing"), repetitions)
+    log("Str.endswith", stringzilla_tokens, lambda t: t.endswith("ing"), repetitions)
+    log("str.partition", pythonic_tokens, lambda t: t.partition("e"), repetitions)
+    log("Str.partition", stringzilla_tokens, lambda t: t.partition("e"), repetitions)
+
+
+def bench(
+    haystack_path: str = None,
+    haystack_pattern: str = "the quick brown fox jumps over the lazy dog while singing ",
+    haystack_length: int = 1e6,
+    tokens_count: int = 1000,
+    repetitions: int = 100,
+):
+    """Measures the per-call latency of methods on short strings, where the call overhead dominates."""
+    if haystack_path:
+        pythonic_str: str = open(haystack_path, "r").read()
+    else:
+        haystack_length = int(haystack_length)
+        pythonic_str: str = haystack_pattern * (haystack_length // len(haystack_pattern))
+
+    tokens = pythonic_str.split()
+    tokens = random.sample(tokens, min(int(tokens_count), len(tokens)))
+    print(f"Sampled {len(tokens):,} tokens of {sum(len(t) for t in tokens) / len(tokens):.2f} mean length!")
+
+    log_functionality(tokens, [Str(t) for t in tokens], int(repetitions))
+
+
+if __name__ == "__main__":
+    fire.Fire(bench)
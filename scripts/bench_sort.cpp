@@ -222,6 +222,18 @@ int main(int argc, char const **argv) {
             [](strings_t const &strings, permute_t &permute) { hybrid_stable_sort_cpp(strings, permute.data()); });
         expect_sorted(strings, permute_new);
         expect_same(permute_base, permute_new);
+
+        bench_permute("sz_sort_stable", strings, permute_new, [](strings_t const &strings, permute_t &permute) {
+            sz_sequence_t array;
+            array.order = permute.data();
+            array.count = strings.size();
+            array.handle = &strings;
+            array.get_start = get_start;
+            array.get_length = get_length;
+            sz_sort_stable(&array, nullptr);
+        });
+        expect_sorted(strings, permute_new);
+        expect_same(permute_base, permute_new);
     }
 
     return 0;
@@ -22,11 +22,17 @@
 #include <cstdio>    // `std::printf`
 #include <cstring>   // `std::memcpy`
 #include <iterator>  // `std::distance`
+#include <map>       // `std::map`
 #include <memory>    // `std::allocator`
+#include <numeric>   // `std::iota`
 #include <random>    // `std::random_device`
 #include <sstream>   // `std::ostringstream`
 #include <vector>    // `std::vector`
 
+#if !defined(_WIN32)
+#include <unistd.h> // `pipe`
+#endif
+
 #include <string>      // Baseline
 #include <string_view> // Baseline
 
@@ -277,6 +283,8 @@ static void test_api_readonly() {
     assert(str("b") > str("a"));
     assert(str("b") >= str("a"));
     assert(str("a") < str("aa"));
+    assert(str("f|feed", 1) < str("feed")); // The bytes past the end of the prefix must be ignored
+    assert(str("feed") > str("f|feed", 1));
 
 #if SZ_DETECT_CPP20 && __cpp_lib_three_way_comparison
     // Spaceship operator instead of conventional comparions.
@@ -1224,6 +1232,381 @@ static void test_levenshtein_distances() {
     }
 }
 
+/**
+ *  @brief  Tests batched hashing of strings in an Arrow-like tape against hashing them one by one.
+ */
+static void test_hashing() {
+    std::mt19937 &generator = global_random_generator();
+    std::uniform_int_distribution<std::size_t> length_distribution(0, 70);
+    for (std::size_t count = 0; count != 40; ++count) {
+        std::string tape;
+        std::vector<sz_u32_t> offsets(1, 0);
+        for (std::size_t i = 0; i != count; ++i) {
+            tape += sz::scripts::random_string(length_distribution(generator), "abcdefghijklmnopqrstuvwxyz", 26);
+            offsets.push_back(static_cast<sz_u32_t>(tape.size()));
+        }
+
+        std::vector<sz_u64_t> expected(count), received(count);
+        for (std::size_t i = 0; i != count; ++i)
+            expected[i] = sz_hash(tape.data() + offsets[i], offsets[i + 1] - offsets[i]);
+
+        sz_hash_tape(tape.data(), offsets.data(), count, received.data());
+        assert(received == expected);
+        sz_hash_tape_serial(tape.data(), offsets.data(), count, received.data());
+        assert(received == expected);
+#if SZ_USE_X86_AVX2
+        sz_hash_tape_avx2(tape.data(), offsets.data(), count, received.data());
+        assert(received == expected);
+#endif
+#if SZ_USE_X86_AVX512
+        sz_hash_tape_avx512(tape.data(), offsets.data(), count, received.data());
+        assert(received == expected);
+#endif
+#if SZ_USE_ARM_NEON
+        sz_hash_tape_neon(tape.data(), offsets.data(), count, received.data());
+        assert(received == expected);
+#endif
+    }
+
+    // Rolling hashes of all backends must match, and be the same as hashing every window separately.
+    using window_hashes_t = std::vector<std::pair<std::size_t, sz_u64_t>>;
+    struct window_hashes_handle_t {
+        char const *text;
+        window_hashes_t hashes;
+    };
+    auto collect = [](sz_cptr_t start, sz_size_t, sz_u64_t hash, void *handle) {
+        window_hashes_handle_t &collected = *reinterpret_cast<window_hashes_handle_t *>(handle);
+        collected.hashes.emplace_back(static_cast<std::size_t>(start - collected.text), hash);
+    };
+    auto rolling_hashes = [&](sz_hashes_t function, std::string const &text, std::size_t window, std::size_t step) {
+        window_hashes_handle_t collected {text.data(), {}};
+        function(text.data(), text.size(), window, step, collect, &collected);
+        std::sort(collected.hashes.begin(), collected.hashes.end());
+        return collected.hashes;
+    };
+    for (sz_hash_family_t family : {sz_hash_family_prime_k, sz_hash_family_mersenne_k}) {
+        bool const is_mersenne = family == sz_hash_family_mersenne_k;
+        sz_hashes_t serial = is_mersenne ? sz_hashes_mersenne_serial : sz_hashes_serial;
+        sz_hashes_t dispatched = is_mersenne ? sz_hashes_mersenne : sz_hashes;
+        for (std::size_t length : {0, 1, 7, 33, 100, 1000}) {
+            std::string text = sz::scripts::random_string(length, "ACGT", 4);
+            for (std::size_t window : {1, 3, 4, 8, 31, 64}) {
+                for (std::size_t step : {1, 2, 8}) {
+                    window_hashes_t expected = rolling_hashes(serial, text, window, step);
+                    assert(expected.size() == (length >= window ? (length - window) / step + 1 : 0));
+                    for (auto const &offset_and_hash : expected) {
+                        window_hashes_handle_t single {text.data(), {}};
+                        serial(text.data() + offset_and_hash.first, window, window, 1, collect, &single);
+                        assert(single.hashes.size() == 1 && single.hashes[0] == offset_and_hash);
+                    }
+                    assert(rolling_hashes(dispatched, text, window, step) == expected);
+#if SZ_USE_X86_AVX2
+                    assert(rolling_hashes(is_mersenne ? sz_hashes_mersenne_avx2 : sz_hashes_avx2, text, window,
+                                          step) == expected);
+#endif
+#if SZ_USE_X86_AVX512
+                    assert(rolling_hashes(is_mersenne ? sz_hashes_mersenne_avx512 : sz_hashes_avx512, text, window,
+                                          step) == expected);
+#endif
+
+                    // Buffered exports must preserve the order of windows, even if split into blocks.
+                    auto exported_hashes = [&](sz_hashes_into_t function, std::size_t block) {
+                        std::vector<sz_u64_t> hashes(expected.size());
+                        std::vector<sz_size_t> positions(expected.size());
+                        window_hashes_t exported;
+                        for (std::size_t offset = 0; exported.size() != expected.size();) {
+                            std::size_t count = function(text.data() + offset, length - offset, window, step, family,
+                                                         hashes.data(), positions.data(), block);
+                            assert(count != 0 && count <= block);
+                            for (std::size_t i = 0; i != count; ++i)
+                                exported.emplace_back(offset + positions[i], hashes[i]);
+                            offset += count * step;
+                        }
+                        return exported;
+                    };
+                    for (std::size_t block : {std::size_t(1), std::size_t(37), expected.size() + 1}) {
+                        assert(exported_hashes(sz_hashes_into, block) == expected);
+                        assert(exported_hashes(sz_hashes_into_serial, block) == expected);
+#if SZ_USE_X86_AVX2
+                        assert(exported_hashes(sz_hashes_into_avx2, block) == expected);
+#endif
+#if SZ_USE_X86_AVX512
+                        assert(exported_hashes(sz_hashes_into_avx512, block) == expected);
+#endif
+                    }
+                }
+
+                // Winnowing must match the brute-force selection of minimums in every run of windows.
+                window_hashes_t all = rolling_hashes(serial, text, window, 1);
+                for (std::size_t winnow : {1, 4, 16, 100}) {
+                    window_hashes_t expected;
+                    std::size_t const runs = std::min(winnow, all.size());
+                    std::size_t selected = all.size();
+                    for (std::size_t last = runs ? runs - 1 : 0; last < all.size(); ++last) {
+                        std::size_t const first = last + 1 - runs;
+                        auto min_hash = std::min_element(
+                            all.begin() + first, all.begin() + last + 1,
+                            [](std::pair<std::size_t, sz_u64_t> const &a, std::pair<std::size_t, sz_u64_t> const &b) {
+                                return a.second < b.second;
+                            });
+                        if (selected < all.size() && selected >= first && all[selected].second == min_hash->second)
+                            continue;
+                        for (std::size_t i = last + 1; i-- != first;)
+                            if (all[i].second == min_hash->second) {
+                                selected = i;
+                                break;
+                            }
+                        expected.push_back(all[selected]);
+                    }
+
+                    std::vector<sz_u64_t> hashes(all.size());
+                    std::vector<sz_size_t> positions(all.size());
+                    std::size_t count = sz_hashes_winnow(text.data(), length, window, winnow, family, hashes.data(),
+                                                         positions.data(), hashes.size(), NULL);
+                    window_hashes_t received;
+                    for (std::size_t i = 0; i != count; ++i) received.emplace_back(positions[i], hashes[i]);
+                    assert(received == expected);
+                }
+            }
+        }
+    }
+
+    // The fingerprints are filled in blocks, but must match setting a bit for every window.
+    for (std::size_t fingerprint_bytes : {64, 60}) {
+        std::string text = sz::scripts::random_string(3000, "ACGT", 4);
+        std::vector<sz_u8_t> expected(fingerprint_bytes), received(fingerprint_bytes);
+        for (auto const &offset_and_hash : rolling_hashes(sz_hashes_serial, text, 7, 1))
+            expected[(offset_and_hash.second / 8) % fingerprint_bytes] |= 1 << (offset_and_hash.second & 7);
+        sz_hashes_fingerprint(text.data(), text.size(), 7, (sz_ptr_t)received.data(), fingerprint_bytes);
+        assert(received == expected);
+    }
+
+    // Content-defined chunks must respect the length limits, and not depend on how the stream is split.
+    std::string stream = sz::scripts::random_string(1 << 18, "abcdefghijklmnopqrstuvwxyz", 26);
+    auto chunk_ends = [&](std::string const &data, std::size_t min_length, std::size_t part_length,
+                          std::size_t capacity) {
+        sz_chunker_t chunker;
+        sz_chunker_init(&chunker, min_length, 1024, 4096, 2);
+        std::vector<std::size_t> ends, boundaries(capacity);
+        for (std::size_t offset = 0; offset != data.size();) {
+            std::size_t length = std::min(part_length, data.size() - offset);
+            std::size_t count =
+                sz_chunk_boundaries(&chunker, data.data() + offset, length, boundaries.data(), capacity);
+            for (std::size_t i = 0; i != count; ++i) ends.push_back(offset + boundaries[i]);
+            offset += count == capacity ? boundaries[count - 1] : length;
+        }
+        ends.push_back(data.size() - chunker.chunk_length);
+        return ends;
+    };
+    for (std::size_t min_length : {1, 64, 256}) {
+        std::vector<std::size_t> expected = chunk_ends(stream, min_length, stream.size(), stream.size());
+        assert(expected.size() > 1);
+        for (std::size_t i = 0; i + 1 < expected.size(); ++i) {
+            std::size_t chunk_length = expected[i] - (i ? expected[i - 1] : 0);
+            assert(chunk_length >= min_length && chunk_length <= 4096);
+        }
+        assert(chunk_ends(stream, min_length, 1000, stream.size()) == expected);
+        assert(chunk_ends(stream, min_length, 3, stream.size()) == expected);
+        assert(chunk_ends(stream, min_length, stream.size(), 1) == expected);
+    }
+
+    // Inserting a byte should only move the boundaries around it.
+    {
+        std::string edited = stream;
+        edited.insert(edited.begin() + stream.size() / 2, 'z');
+        std::vector<std::size_t> original = chunk_ends(stream, 256, stream.size(), stream.size());
+        std::vector<std::size_t> shifted = chunk_ends(edited, 256, stream.size(), stream.size());
+        std::size_t common_suffix = 0;
+        while (common_suffix < std::min(original.size(), shifted.size()) &&
+               original[original.size() - 1 - common_suffix] + 1 == shifted[shifted.size() - 1 - common_suffix])
+            ++common_suffix;
+        assert(common_suffix > original.size() / 4);
+    }
+}
+
+/**
+ *  @brief  Tests MinHash and SimHash document sketches, built on top of rolling hashes.
+ */
+static void test_sketches() {
+    std::string document = sz::scripts::random_string(5000, "abcdefghijklmnopqrstuvwxyz", 26);
+    std::string similar = document;
+    for (std::size_t i = 0; i < similar.size(); i += 50) similar[i] = '_';
+    std::string different = sz::scripts::random_string(5000, "abcdefghijklmnopqrstuvwxyz", 26);
+
+    constexpr std::size_t signature_length = 67;
+    using signature_t = std::vector<sz_u64_t>;
+    auto minhash = [](sz_hashes_minhash_t function, std::string const &text) {
+        signature_t signature(signature_length, SZ_U64_MAX);
+        function(text.data(), text.size(), 5, sz_hash_family_mersenne_k, signature.data(), signature_length);
+        return signature;
+    };
+
+    // All backends must produce identical sketches.
+    signature_t expected = minhash(sz_hashes_minhash_serial, document);
+    sz_u64_t expected_simhash = sz_hashes_simhash_serial(document.data(), document.size(), 5, sz_hash_family_prime_k);
+    assert(minhash(sz_hashes_minhash, document) == expected);
+    assert(sz_hashes_simhash(document.data(), document.size(), 5, sz_hash_family_prime_k) == expected_simhash);
+#if SZ_USE_X86_AVX512
+    assert(minhash(sz_hashes_minhash_avx512, document) == expected);
+    assert(sz_hashes_simhash_avx512(document.data(), document.size(), 5, sz_hash_family_prime_k) == expected_simhash);
+#endif
+
+    // Sketching a document in parts is the same as sketching the whole, if the parts overlap by the window.
+    signature_t parts(signature_length, SZ_U64_MAX);
+    sz_hashes_minhash(document.data(), 3000, 5, sz_hash_family_mersenne_k, parts.data(), signature_length);
+    sz_hashes_minhash(document.data() + 2996, 2004, 5, sz_hash_family_mersenne_k, parts.data(), signature_length);
+    assert(parts == expected);
+
+    // The number of matching slots should reflect the similarity of documents.
+    signature_t batch;
+    for (std::string const *text : {&document, &similar, &different}) {
+        signature_t signature = minhash(sz_hashes_minhash, *text);
+        batch.insert(batch.end(), signature.begin(), signature.end());
+    }
+    std::vector<sz_size_t> matches(3), received(3);
+    sz_minhash_matches_serial(expected.data(), batch.data(), 3, signature_length, matches.data());
+    assert(matches[0] == signature_length && matches[1] > matches[2] && matches[1] < signature_length);
+    sz_minhash_matches(expected.data(), batch.data(), 3, signature_length, received.data());
+    assert(received == matches);
+#if SZ_USE_X86_AVX512
+    sz_minhash_matches_avx512(expected.data(), batch.data(), 3, signature_length, received.data());
+    assert(received == matches);
+#endif
+
+    // Bands of equal signatures must be equal, and differ between unrelated documents.
+    std::vector<sz_u64_t> bands(signature_length / 8), other_bands(signature_length / 8);
+    sz_minhash_bands(expected.data(), signature_length, 8, bands.data());
+    sz_minhash_bands(batch.data(), signature_length, 8, other_bands.data());
+    assert(bands == other_bands);
+    sz_minhash_bands(batch.data() + 2 * signature_length, signature_length, 8, other_bands.data());
+    for (std::size_t i = 0; i != bands.size(); ++i) assert(bands[i] != other_bands[i]);
+
+    // Similar documents should have closer SimHashes, than unrelated ones.
+    sz_u64_t similar_simhash = sz_hashes_simhash(similar.data(), similar.size(), 5, sz_hash_family_prime_k);
+    sz_u64_t different_simhash = sz_hashes_simhash(different.data(), different.size(), 5, sz_hash_family_prime_k);
+    assert(sz_u64_popcount(expected_simhash ^ similar_simhash) < sz_u64_popcount(expected_simhash ^ different_simhash));
+}
+
+/**
+ *  @brief  Tests k-mer extraction, counting, and minimizers for DNA sequences.
+ */
+static void test_kmers() {
+    auto reverse_complement = [](std::string const &dna) {
+        std::string result(dna.rbegin(), dna.rend());
+        for (char &c : result) c = c == 'A' ? 'T' : c == 'C' ? 'G' : c == 'G' ? 'C' : c == 'T' ? 'A' : c;
+        return result;
+    };
+
+    // Packing and canonical forms on a tiny example.
+    {
+        std::vector<sz_u64_t> kmers(8);
+        std::vector<sz_size_t> positions(8);
+        assert(sz_kmers("ACGTnA", 6, 2, sz_false_k, kmers.data(), positions.data(), 8) == 3);
+        assert(kmers[0] == 0b0001 && kmers[1] == 0b0110 && kmers[2] == 0b1011);
+        assert(positions[0] == 0 && positions[1] == 1 && positions[2] == 2);
+        assert(sz_kmers("ttt", 3, 3, sz_true_k, kmers.data(), NULL, 8) == 1 && kmers[0] == 0); // "AAA"
+    }
+
+    for (std::size_t length : {10, 100, 5000}) {
+        std::string dna = sz::scripts::random_string(length, "ACGTN", 5);
+        std::string rc = reverse_complement(dna);
+        for (std::size_t k : {1, 5, 15, 32}) {
+            // Compare k-mer counts against a brute-force count of canonical substrings.
+            std::map<std::string, std::size_t> expected;
+            for (std::size_t i = 0; i + k <= length; ++i) {
+                std::string kmer = dna.substr(i, k);
+                if (kmer.find_first_not_of("ACGT") != std::string::npos) continue;
+                expected[std::min(kmer, reverse_complement(kmer))]++;
+            }
+            std::vector<sz_u64_t> kmers(length), rc_kmers(length);
+            std::vector<sz_size_t> counts(length), rc_counts(length);
+            std::size_t distinct = sz_kmers_count(dna.data(), length, k, sz_true_k, kmers.data(), counts.data(),
+                                                  length, NULL);
+            assert(distinct == expected.size());
+            std::map<sz_u64_t, std::size_t> received, received_rc;
+            for (std::size_t i = 0; i != distinct; ++i) received[kmers[i]] = counts[i];
+            std::size_t rc_distinct = sz_kmers_count(rc.data(), length, k, sz_true_k, rc_kmers.data(),
+                                                     rc_counts.data(), length, NULL);
+            for (std::size_t i = 0; i != rc_distinct; ++i) received_rc[rc_kmers[i]] = rc_counts[i];
+            assert(received == received_rc);
+            std::size_t expected_total = 0, received_total = 0;
+            for (auto const &kmer_and_count : expected) expected_total += kmer_and_count.second;
+            for (auto const &kmer_and_count : received) received_total += kmer_and_count.second;
+            assert(expected_total == received_total);
+
+            // Canonical minimizers of a sequence and its reverse complement must match.
+            for (std::size_t w : {1, 4, 10}) {
+                std::vector<sz_u64_t> hashes(length), rc_hashes(length);
+                std::vector<sz_size_t> positions(length);
+                std::size_t count = sz_minimizers(dna.data(), length, k, w, sz_true_k, hashes.data(), positions.data(),
+                                                  length, NULL);
+                std::size_t rc_count =
+                    sz_minimizers(rc.data(), length, k, w, sz_true_k, rc_hashes.data(), NULL, length, NULL);
+                std::sort(hashes.begin(), hashes.begin() + count);
+                std::sort(rc_hashes.begin(), rc_hashes.begin() + rc_count);
+                hashes.resize(count), rc_hashes.resize(rc_count);
+                hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+                rc_hashes.erase(std::unique(rc_hashes.begin(), rc_hashes.end()), rc_hashes.end());
+                assert(hashes == rc_hashes);
+                if (w == 1) assert(count == expected_total);
+            }
+        }
+    }
+
+    // Packed nucleotides must round-trip, and support search, distances, and reverse complements.
+    for (std::size_t length : {1, 3, 31, 32, 33, 100, 1000}) {
+        std::string dna = sz::scripts::random_string(length, "ACGTacgtN", 9);
+        std::string upper = dna;
+        for (char &c : upper) c = c == 'N' || c == '\0' ? 'N' : (char)std::toupper(c);
+        std::vector<char> packed((length + 3) / 4), n_mask((length + 7) / 8);
+        std::size_t unknowns = sz_nucleotides_pack(dna.data(), length, packed.data(), n_mask.data());
+        assert(unknowns == static_cast<std::size_t>(std::count(upper.begin(), upper.end(), 'N')));
+        std::string unpacked(length, ' ');
+        sz_nucleotides_unpack(packed.data(), n_mask.data(), length, &unpacked[0]);
+        assert(unpacked == upper);
+
+        // Reverse complement without unknowns treats them as 'A', complemented into 'T'.
+        std::string without_unknowns(length, ' ');
+        sz_nucleotides_unpack(packed.data(), NULL, length, &without_unknowns[0]);
+        std::vector<char> complement(packed.size());
+        sz_nucleotides_reverse_complement(packed.data(), length, complement.data());
+        std::string complement_unpacked(length, ' ');
+        sz_nucleotides_unpack(complement.data(), NULL, length, &complement_unpacked[0]);
+        assert(complement_unpacked == reverse_complement(without_unknowns));
+
+        // Hamming distance against the reverse complement, compared to the unpacked one.
+        std::size_t expected_distance = 0;
+        for (std::size_t i = 0; i != length; ++i) expected_distance += without_unknowns[i] != complement_unpacked[i];
+        assert(sz_nucleotides_hamming(packed.data(), complement.data(), length) == expected_distance);
+
+        // Search for substrings of different lengths, skipping the ones with unknowns.
+        for (std::size_t needle_length : {1, 5, 32, 40}) {
+            if (needle_length > length) continue;
+            std::size_t needle_offset = length - needle_length;
+            std::string needle = upper.substr(needle_offset, needle_length);
+            if (needle.find('N') != std::string::npos) continue;
+            std::vector<char> packed_needle((needle_length + 3) / 4);
+            sz_nucleotides_pack(needle.data(), needle_length, packed_needle.data(), NULL);
+            std::size_t found = sz_nucleotides_find(packed.data(), length, n_mask.data(), packed_needle.data(),
+                                                    needle_length);
+            assert(found == upper.find(needle));
+        }
+    }
+}
+
+static sz_cptr_t get_start_from_strings(sz_sequence_t const *sequence, sz_size_t i) {
+    return reinterpret_cast<std::vector<std::string> const *>(sequence->handle)->at(i).data();
+}
+
+static sz_size_t get_length_from_strings(sz_sequence_t const *sequence, sz_size_t i) {
+    return reinterpret_cast<std::vector<std::string> const *>(sequence->handle)->at(i).size();
+}
+
+static sz_bool_t is_less_in_strings(sz_sequence_t const *sequence, sz_size_t i, sz_size_t j) {
+    std::vector<std::string> const &strings = *reinterpret_cast<std::vector<std::string> const *>(sequence->handle);
+    return strings[i] < strings[j] ? sz_true_k : sz_false_k;
+}
+
 /**
  *  @brief  Tests sorting functionality.
  */
@@ -1248,6 +1631,393 @@ static void test_sequence_algorithms() {
             auto order = sz::sorted_order(dataset);
             for (std::size_t i = 1; i != dataset_size; ++i) { assert(dataset[order[i - 1]] <= dataset[order[i]]); }
         }
+
+        // Partial sorting must produce the same head, as the full one.
+        strs_t sorted_dataset = dataset;
+        std::sort(sorted_dataset.begin(), sorted_dataset.end());
+        for (std::size_t partial_order_length : {0, 1, 7, 100, 5000, 20000}) {
+            auto head = sz::partial_sorted_order(dataset, partial_order_length);
+            assert(head.size() == std::min(partial_order_length, dataset_size));
+            for (std::size_t i = 0; i != head.size(); ++i) assert(dataset[head[i]] == sorted_dataset[i]);
+        }
+    }
+
+    // Partial sorting with many equal prefixes must leave a valid permutation in the tail.
+    strs_t prefixed;
+    for (std::size_t i = 0; i != 1000; ++i)
+        prefixed.push_back("abcd" + sz::scripts::random_string(i % 8, "abcdefghijklmnopqrstuvwxyz", 3));
+    std::vector<sz::sorted_idx_t> order(prefixed.size());
+    sz::partial_sorted_order(prefixed.data(), prefixed.data() + prefixed.size(), order.data(), 10,
+                             [](std::string const &s) -> sz::string_view { return s; });
+    std::vector<sz::sorted_idx_t> permutation = order;
+    std::sort(permutation.begin(), permutation.end());
+    for (std::size_t i = 0; i != permutation.size(); ++i) assert(permutation[i] == i);
+    for (std::size_t i = 1; i != 10; ++i) assert(prefixed[order[i - 1]] <= prefixed[order[i]]);
+    for (std::size_t i = 10; i != order.size(); ++i) assert(prefixed[order[9]] <= prefixed[order[i]]);
+
+    // Stable sorting must match `std::stable_sort`, even with lots of duplicates sharing long prefixes.
+    assert_scoped(strs_t x({"b", "a", "b", "a"}), (void)0, sz::stable_sorted_order(x) == order_t({1u, 3u, 0u, 2u}));
+    for (std::size_t cardinality : {1, 2, 26}) {
+        strs_t duplicates;
+        for (std::size_t i = 0; i != 3000; ++i)
+            duplicates.push_back("prefix" + sz::scripts::random_string(i % 5, "abcdefghijklmnopqrstuvwxyz", cardinality));
+        order_t expected(duplicates.size());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(expected.begin(), expected.end(), [&](sz::sorted_idx_t a, sz::sorted_idx_t b) {
+            return duplicates[static_cast<std::size_t>(a)] < duplicates[static_cast<std::size_t>(b)];
+        });
+        assert(sz::stable_sorted_order(duplicates) == expected);
+    }
+
+    // Stable sorting must keep the ties in their incoming order, even if it isn't `iota`, like in multi-column sorts.
+    for (std::size_t count : {0, 1, 2, 3, 1000}) {
+        std::vector<std::string> strings;
+        for (std::size_t i = 0; i != count; ++i)
+            strings.push_back(sz::scripts::random_string(i % 3, "abcdefghijklmnopqrstuvwxyz", 2));
+        order_t order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), global_random_generator());
+        order_t expected = order;
+        std::stable_sort(expected.begin(), expected.end(), [&](sz::sorted_idx_t a, sz::sorted_idx_t b) {
+            return strings[static_cast<std::size_t>(a)] < strings[static_cast<std::size_t>(b)];
+        });
+
+        sz_sequence_t sequence;
+        std::memset(&sequence, 0, sizeof(sequence));
+        sequence.order = order.data();
+        sequence.count = count;
+        sequence.handle = &strings;
+        sequence.get_start = get_start_from_strings;
+        sequence.get_length = get_length_from_strings;
+        assert(sz_sort_stable(&sequence, NULL));
+        assert(order == expected);
+    }
+
+    // Collated sorting must agree with the collated comparison of neighbors and with the normalized copies.
+    sz_u8_t case_fold[256], reversed[256], digits_mixed[256];
+    sz_collation_ranks_case_fold(case_fold);
+    for (std::size_t i = 0; i != 256; ++i) reversed[i] = static_cast<sz_u8_t>(255 - i);
+    for (std::size_t i = 0; i != 256; ++i) digits_mixed[i] = static_cast<sz_u8_t>(i == 'b' ? '5' : i);
+    auto case_folded = [](std::string s) {
+        for (char &c : s) c = static_cast<char>(sz_u8_tolower(static_cast<sz_u8_t>(c)));
+        return s;
+    };
+    assert_scoped(strs_t x({"file10", "file2", "File1", "file02b", "file", "a"}), (void)0,
+                  sz::collated_sorted_order(x, {SZ_NULL, sz_true_k}) == order_t({2u, 5u, 4u, 1u, 3u, 0u}));
+    sz_collation_t const case_insensitive = {case_fold, sz_false_k}, natural = {case_fold, sz_true_k};
+    assert(sz_order_collated("x007", 4, "x7", 2, nullptr) == sz_less_k);
+    assert(sz_order_collated("x007", 4, "x7", 2, &natural) == sz_equal_k);
+    assert(sz_order_collated("x9", 2, "X10", 3, &natural) == sz_less_k);
+    assert(sz_order_collated("ABC", 3, "abd", 3, &case_insensitive) == sz_less_k);
+    assert(sz_order_collated("ABC", 3, "abc", 3, &case_insensitive) == sz_equal_k);
+    for (sz_collation_t collation : {sz_collation_t {case_fold, sz_false_k}, sz_collation_t {reversed, sz_false_k},
+                                     sz_collation_t {SZ_NULL, sz_true_k}, sz_collation_t {case_fold, sz_true_k},
+                                     sz_collation_t {digits_mixed, sz_true_k}}) {
+        strs_t dataset;
+        for (std::size_t i = 0; i != 3000; ++i)
+            dataset.push_back(sz::scripts::random_string(i % 9, " aAbB_[0019:/", 12));
+        order_t order = sz::collated_sorted_order(dataset, collation);
+        order_t permutation = order;
+        std::sort(permutation.begin(), permutation.end());
+        for (std::size_t i = 0; i != permutation.size(); ++i) assert(permutation[i] == i);
+        for (std::size_t i = 1; i != order.size(); ++i) {
+            std::string const &previous = dataset[static_cast<std::size_t>(order[i - 1])];
+            std::string const &next = dataset[static_cast<std::size_t>(order[i])];
+            assert(sz_order_collated(previous.data(), previous.size(), next.data(), next.size(), &collation) !=
+                   sz_greater_k);
+            if (collation.ranks == case_fold && !collation.natural) assert(case_folded(previous) <= case_folded(next));
+        }
+    }
+}
+
+/**
+ *  @brief  Tests two-way and k-way merges of sorted chunks, checking the stability.
+ */
+static void test_merging() {
+    using order_t = std::vector<sz_sorted_idx_t>;
+
+    for (std::size_t count : {0, 1, 2, 10, 1000}) {
+        std::vector<std::string> strings;
+        for (std::size_t i = 0; i != count; ++i)
+            strings.push_back(sz::scripts::random_string(i % 3, "abcdefghijklmnopqrstuvwxyz", 4));
+        auto is_less = [&](sz_sorted_idx_t a, sz_sorted_idx_t b) { return strings[a] < strings[b]; };
+
+        // The stable order of all the strings, used as a baseline.
+        order_t expected(count);
+        for (std::size_t i = 0; i != count; ++i) expected[i] = i;
+        std::stable_sort(expected.begin(), expected.end(), is_less);
+
+        sz_sequence_t sequence;
+        std::memset(&sequence, 0, sizeof(sequence));
+        sequence.count = count;
+        sequence.handle = &strings;
+        sequence.get_start = get_start_from_strings;
+        sequence.get_length = get_length_from_strings;
+
+        // Two-way merges with chunks of different proportions.
+        for (std::size_t partition : {std::size_t(0), count / 10, count / 2, count - count / 10, count}) {
+            order_t order(count);
+            for (std::size_t i = 0; i != count; ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.begin() + partition, is_less);
+            std::stable_sort(order.begin() + partition, order.end(), is_less);
+            order_t copy = order;
+            sequence.order = order.data();
+            sz_merge(&sequence, partition, is_less_in_strings);
+            assert(order == expected);
+            sequence.order = copy.data();
+            order_t buffer(count);
+            assert(sz_merge_buffered(&sequence, partition, is_less_in_strings, buffer.data(), NULL));
+            assert(copy == expected);
+        }
+
+        // K-way merges of chunks of random lengths, including empty ones.
+        for (std::size_t chunks : {1, 3, 17}) {
+            std::vector<sz_size_t> offsets(1, 0);
+            for (std::size_t i = 1; i != chunks; ++i) offsets.push_back(global_random_generator()() % (count + 1));
+            offsets.push_back(count);
+            std::sort(offsets.begin(), offsets.end());
+            order_t order(count), merged(count);
+            for (std::size_t i = 0; i != count; ++i) order[i] = i;
+            for (std::size_t i = 0; i != chunks; ++i)
+                std::stable_sort(order.begin() + offsets[i], order.begin() + offsets[i + 1], is_less);
+            sequence.order = order.data();
+            assert(sz_merge_many(&sequence, offsets.data(), chunks, is_less_in_strings, merged.data(), NULL));
+            assert(merged == expected);
+        }
+    }
+}
+
+/**
+ *  @brief  Tests the external-memory sort with tiny runs, forcing multiple merge passes.
+ */
+static void test_external_sort() {
+    auto sort_file = [](std::FILE *input_file, std::size_t memory_limit, std::size_t expected_size) {
+        std::FILE *output_file = std::tmpfile();
+        sz::external_sort_config config;
+        config.memory_limit = memory_limit;
+        config.io_buffer_size = 16;
+        config.max_merge_width = 3;
+        config.separator = '|';
+        sz::external_sort(input_file, output_file, config);
+
+        std::string output(expected_size + 1, '\0');
+        std::rewind(output_file);
+        output.resize(std::fread(&output[0], 1, output.size(), output_file));
+        std::fclose(output_file);
+        return output;
+    };
+
+    for (std::size_t count : {0, 1, 10, 3000}) {
+        std::vector<std::string> lines;
+        std::string input;
+        for (std::size_t i = 0; i != count; ++i) {
+            lines.push_back(sz::scripts::random_string(i % 40, "abcdefghijklmnopqrstuvwxyz", 5));
+            input += lines.back() + (i + 1 == count && i % 2 ? "" : "|");
+        }
+        std::sort(lines.begin(), lines.end());
+        std::string expected;
+        for (std::string const &line : lines) expected += line + "|";
+
+        // The limit must fit the longest record with its separator, and records longer than it are rejected.
+        for (std::size_t memory_limit : {40, 100, 1000000}) {
+            std::FILE *input_file = std::tmpfile();
+            std::fwrite(input.data(), 1, input.size(), input_file);
+            std::rewind(input_file);
+            assert(sort_file(input_file, memory_limit, expected.size()) == expected);
+            std::fclose(input_file);
+        }
+        if (count > 20) {
+            std::FILE *input_file = std::tmpfile();
+            std::fwrite(input.data(), 1, input.size(), input_file);
+            std::rewind(input_file);
+            assert_throws(sort_file(input_file, 20, expected.size()), std::runtime_error);
+            std::fclose(input_file);
+        }
+
+#if !defined(_WIN32)
+        // Pipes aren't seekable, so the block starts at the I/O buffer size, and grows up to the limit.
+        if (input.size() < 512) {
+            int pipe_ends[2];
+            assert(pipe(pipe_ends) == 0);
+            assert(write(pipe_ends[1], input.data(), input.size()) == static_cast<ssize_t>(input.size()));
+            close(pipe_ends[1]);
+            std::FILE *input_file = fdopen(pipe_ends[0], "rb");
+            assert(sort_file(input_file, 1000000, expected.size()) == expected);
+            std::fclose(input_file);
+        }
+#endif
+    }
+}
+
+/**
+ *  @brief  Tests suffix array and LCP construction against naive suffix sorting.
+ */
+static void test_suffix_arrays() {
+
+    auto check_text = [](std::string const &text) {
+        std::size_t const length = text.size();
+        std::vector<sz_size_t> suffixes(length), lcp(length);
+        assert(sz_suffix_array(text.data(), length, suffixes.data(), lcp.data(), NULL));
+
+        std::vector<sz_size_t> expected(length);
+        for (std::size_t i = 0; i != length; ++i) expected[i] = i;
+        std::sort(expected.begin(), expected.end(), [&](sz_size_t a, sz_size_t b) {
+            return text.compare(a, std::string::npos, text, b, std::string::npos) < 0;
+        });
+        assert(suffixes == expected);
+        for (std::size_t i = 0; i != length; ++i) {
+            std::size_t common = 0;
+            if (i)
+                while (suffixes[i] + common < length && suffixes[i - 1] + common < length &&
+                       text[suffixes[i] + common] == text[suffixes[i - 1] + common])
+                    ++common;
+            assert(lcp[i] == common);
+        }
+    };
+
+    check_text("");
+    check_text("a");
+    check_text("banana");
+    check_text("mississippi");
+    check_text(std::string(1000, 'a'));
+    std::string periodic;
+    for (std::size_t i = 0; i != 200; ++i) periodic += "abcabd";
+    check_text(periodic);
+    for (std::size_t length : {2, 3, 10, 100, 1000, 3000}) {
+        check_text(sz::scripts::random_string(length, "abcd", 2));
+        check_text(sz::scripts::random_string(length, "abcd", 4));
+        check_text(sz::scripts::random_string(length, "abcdefghijklmnopqrstuvwxyz", 26));
+    }
+
+    // Generalized suffix arrays over tapes only compare suffixes until the ends of their strings.
+    for (std::size_t count : {1, 2, 10, 300}) {
+        std::vector<std::string> strings(count);
+        std::vector<sz_u32_t> offsets(1, 0);
+        std::string tape;
+        for (std::size_t i = 0; i != count; ++i) {
+            strings[i] = sz::scripts::random_string(i % 13, "abc", 2);
+            tape += strings[i];
+            offsets.push_back(static_cast<sz_u32_t>(tape.size()));
+        }
+        std::size_t const length = tape.size();
+        std::vector<sz_size_t> suffixes(length), lcp(length);
+        assert(sz_suffix_array_u32tape(tape.data(), offsets.data(), count, suffixes.data(), lcp.data(), NULL));
+
+        auto truncated_suffix = [&](sz_size_t position) {
+            std::size_t end = *std::upper_bound(offsets.begin(), offsets.end(), static_cast<sz_u32_t>(position));
+            return tape.substr(position, end - position);
+        };
+        std::vector<bool> seen(length, false);
+        for (std::size_t i = 0; i != length; ++i) {
+            assert(suffixes[i] < length && !seen[suffixes[i]]);
+            seen[suffixes[i]] = true;
+            if (!i) continue;
+            std::string previous = truncated_suffix(suffixes[i - 1]), current = truncated_suffix(suffixes[i]);
+            assert(previous <= current);
+            std::size_t common = 0;
+            while (common < previous.size() && common < current.size() && previous[common] == current[common])
+                ++common;
+            assert(lcp[i] == common);
+        }
+    }
+}
+
+/**
+ *  @brief  Tests FM-index queries and serialization against naive substring search.
+ */
+static void test_fm_index() {
+    for (std::size_t length : {0, 1, 100, 5000, 70000}) {
+        std::string text = sz::scripts::random_string(length, "abcd", 4);
+        for (std::size_t sample_rate : {1, 7, 0}) {
+            sz::fm_index index;
+            index.build(text, sample_rate);
+            assert(index.size() == length);
+            assert(index.count("") == length + 1);
+
+            // Reopen the index from a copy of its serialized representation, aligned to 8 bytes.
+            sz::string_view blob = index.blob();
+            std::vector<sz_u64_t> copy((blob.size() + 7) / 8);
+            std::memcpy(copy.data(), blob.data(), blob.size());
+            sz::fm_index reopened;
+            assert(reopened.try_view({reinterpret_cast<char const *>(copy.data()), blob.size()}));
+            assert(!reopened.try_view({reinterpret_cast<char const *>(copy.data()), blob.size() - 1}));
+            assert(reopened.try_view({reinterpret_cast<char const *>(copy.data()), blob.size()}));
+
+            // Corrupted headers, counters, and samples must be rejected, rather than read out of bounds.
+            auto rejects = [&](std::size_t word, sz_u64_t value) {
+                std::vector<sz_u64_t> corrupted = copy;
+                corrupted[word] = value;
+                sz::fm_index broken;
+                return !broken.try_view({reinterpret_cast<char const *>(corrupted.data()), blob.size()});
+            };
+            assert(rejects(2, length + 1));        // Primary row past the end
+            assert(rejects(8 + 256, length + 2));  // Last character counter
+            assert(rejects(8 + 100, length + 10)); // Non-monotonic character counters
+            sz_fm_index_t raw;
+            assert(sz_fm_index_view(&raw, reinterpret_cast<char const *>(copy.data()), blob.size()));
+            if (length) assert(rejects(static_cast<std::size_t>(raw.samples - copy.data()), length)); // Sample
+
+            for (std::size_t pattern_length : {1, 2, 5, 12}) {
+                for (std::size_t experiment = 0; experiment != 10; ++experiment) {
+                    // Sample both, patterns that are present in the text, and the random ones.
+                    std::string pattern = sz::scripts::random_string(pattern_length, "abcd", 4);
+                    if (experiment % 2 && length >= pattern_length)
+                        pattern = text.substr(global_random_generator()() % (length - pattern_length + 1),
+                                              pattern_length);
+                    std::vector<std::size_t> expected;
+                    for (std::size_t offset = text.find(pattern); offset != std::string::npos;
+                         offset = text.find(pattern, offset + 1))
+                        expected.push_back(offset);
+
+                    assert(index.count(pattern) == expected.size());
+                    assert(reopened.count(pattern) == expected.size());
+                    std::vector<std::size_t> located = reopened.locate(pattern);
+                    std::sort(located.begin(), located.end());
+                    assert(located == expected);
+                }
+            }
+        }
+    }
+}
+
+/**
+ *  @brief  Tests the persisted tapes of strings, written into a file and reopened without parsing.
+ */
+static void test_tapes() {
+    for (std::size_t count : {0, 1, 2, 3, 1000}) {
+        std::vector<std::string> strings;
+        for (std::size_t i = 0; i != count; ++i)
+            strings.push_back(sz::scripts::random_string(i % 17, "abcdefghijklmnopqrstuvwxyz", 5));
+
+        std::FILE *file = std::tmpfile();
+        sz::save_tape(file, strings);
+        std::size_t const blob_length = static_cast<std::size_t>(std::ftell(file));
+        std::vector<sz_u64_t> blob((blob_length + 7) / 8);
+        std::rewind(file);
+        assert(std::fread(blob.data(), 1, blob_length, file) == blob_length);
+        std::fclose(file);
+
+        sz::tape_view tape;
+        char const *blob_start = reinterpret_cast<char const *>(blob.data());
+        assert(!tape.try_view({blob_start, blob_length - 1}));
+        assert(tape.try_view({blob_start, blob_length}));
+        assert(tape.size() == count && tape.offset_size() == 4 && tape.blob().size() == blob_length);
+        for (std::size_t i = 0; i != count; ++i) assert(tape[i] == strings[i]);
+
+        // Swap two neighboring offsets, which only the linear-time validation catches
+        if (count >= 3 && !tape[1].empty()) {
+            sz_u32_t *offsets = reinterpret_cast<sz_u32_t *>(blob.data() + 8);
+            sz_u32_t const first = offsets[1];
+            offsets[1] = offsets[2], offsets[2] = first;
+            assert(!tape.try_view({blob_start, blob_length}) && tape.empty());
+            assert(tape.try_view({blob_start, blob_length}, false) && tape.size() == count);
+            offsets[2] = offsets[1], offsets[1] = first;
+            assert(tape.try_view({blob_start, blob_length}));
+        }
+
+        // Corrupt the magic number
+        blob[0] ^= 1;
+        assert(!tape.try_view({blob_start, blob_length}) && tape.empty());
     }
 }
 
@@ -1297,9 +2067,17 @@ int main(int argc, char const **argv) {
 
     // Similarity measures and fuzzy search
     test_levenshtein_distances();
+    test_hashing();
+    test_sketches();
+    test_kmers();
 
     // Sequences of strings
     test_sequence_algorithms();
+    test_merging();
+    test_external_sort();
+    test_suffix_arrays();
+    test_fm_index();
+    test_tapes();
 
     std::printf("All tests passed... Unbelievable!\n");
     return 0;
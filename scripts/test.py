@@ -1,3 +1,5 @@
+import sys
+from concurrent.futures import ThreadPoolExecutor
 from random import choice, randint
 from string import ascii_lowercase
 from typing import Optional
@@ -82,6 +84,67 @@ def test_unit_split():
     assert str(parts[2]) == "token3"
 
 
+@pytest.mark.parametrize("batch_size", [1, 2, 3, 1000])
+def test_unit_split_iter(batch_size: int, tmp_path):
+    """Lazy splits must yield the same parts as the eager ones, just in `Strs` batches of bounded size."""
+
+    native = "\n".join(get_random_string(variability=3, length=i % 5) for i in range(100)) + "\n"
+    big = Str(native)
+    for separator in ["\n", "ab", "\n\n"]:
+        for keepseparator in [False, True]:
+            batches = list(big.split_iter(separator, keepseparator=keepseparator, batch_size=batch_size))
+            assert all(0 < len(batch) <= batch_size for batch in batches)
+            expected = [str(part) for part in big.split(separator, keepseparator=keepseparator)]
+            assert [str(part) for batch in batches for part in batch] == expected
+
+    assert [list(map(str, batch)) for batch in sz.split_iter("", batch_size=batch_size)] == [[""]]
+    with pytest.raises(ValueError):
+        big.split_iter("")
+
+    path = tmp_path / "lines.txt"
+    path.write_text(native)
+    file = sz.File(str(path))
+    for keeplinebreaks in [False, True]:
+        lines = [str(line) for batch in file.lines(keeplinebreaks, batch_size=batch_size) for line in batch]
+        assert lines == [str(line) for line in Str(file).splitlines(keeplinebreaks)]
+
+
+def test_unit_file_options(tmp_path):
+    """Mapping hints must not change the contents, and writable mappings must persist the in-place edits."""
+
+    path = tmp_path / "mapped.txt"
+    path.write_bytes(b"hello world\n" * 100)
+    for advice in ["normal", "sequential", "random", "willneed"]:
+        file = sz.File(str(path), populate=True, huge_pages=True, advice=advice)
+        assert str(Str(file)) == path.read_text()
+        file.advise(advice)
+        assert memoryview(file).readonly
+
+    file = sz.File(str(path), writable=True)
+    view = memoryview(file)
+    view[:5] = b"HELLO"
+    file.flush()
+    assert bytes(view[:11]) == b"HELLO world"
+    del view
+    assert path.read_bytes().startswith(b"HELLO world")
+    assert str(Str(sz.File(str(path)))).startswith("HELLO world")
+
+    # Strings assume immutable contents, so writable mappings are only exposed as buffers
+    with pytest.raises(ValueError):
+        Str(file)
+    with pytest.raises(ValueError):
+        file.lines()
+    with pytest.raises(TypeError):
+        sz.find(file, "world")
+
+    with pytest.raises(ValueError):
+        sz.File(str(path), advice="sometimes")
+    with pytest.raises(TypeError):
+        sz.File(str(path), writeable=True)
+    with pytest.raises(OSError):
+        sz.File(str(tmp_path / "missing.txt"))
+
+
 def test_unit_sequence():
     native = "p3\np2\np1"
     big = Str(native)
@@ -98,6 +161,312 @@ def test_unit_sequence():
     lines.sort(reverse=True)
     assert ["p3", "p2", "p1"] == list(lines)
 
+    # Partial order
+    assert [2, 1] == list(lines.order(top_k=2))
+    lines.sort(top_k=1)
+    assert "p1" == str(lines[0])
+    assert ["p1", "p2", "p3"] == sorted(str(line) for line in lines)
+
+
+@pytest.mark.parametrize("threads", [0, 1, 3, 4])
+def test_unit_sequence_threads(threads: int):
+    native_list = [get_random_string(variability=4, length=i % 7) for i in range(100_000)]
+    native_sorted = sorted(native_list)
+    lines = Str("\n".join(native_list)).splitlines()
+
+    # The consecutive layout is sorted through its offsets, then gathered in order.
+    assert native_sorted == [native_list[i] for i in lines.order(threads=threads)]
+    assert native_sorted[:1000] == [native_list[i] for i in lines.order(top_k=1000, threads=threads)]
+    lines.sort(threads=threads)
+    assert native_sorted == [str(line) for line in lines]
+
+    # The reordered layout is sorted through its slices.
+    lines.shuffle(seed=42)
+    lines.sort(reverse=True, threads=threads)
+    assert native_sorted[::-1] == [str(line) for line in lines]
+
+    with pytest.raises(ValueError):
+        lines.order(threads=-1)
+
+
+def test_unit_fastcall_keywords():
+    """Keyword arguments of the `METH_FASTCALL` methods, including names built at runtime, which aren't interned."""
+
+    big = Str("abcabcabc")
+    assert big.find("abc", start=1) == 3
+    assert big.find("abc", **{"".join(["st", "art"]): 1, "end": 5}) == -1
+    assert big.count("aa", allowoverlap=True) == 0
+    assert Str("aaaa").count("aa", allowoverlap=True) == 3
+    assert big.startswith("bc", start=1) and not big.startswith("bc", 1, 2)
+    assert big.endswith("ab", end=-1) and not big.endswith("ab", start=8)
+    assert big.startswith("abc", start=-3) and not big.startswith("abc", start=100)
+    assert sz.startswith("a\0b", "a\0c") is False
+
+    # Empty affixes match only within the interval, like in CPython, even if it is empty or inverted.
+    native = "abc"
+    for start, end in [(0, None), (3, None), (4, None), (100, None), (-100, None), (2, 1), (1, 1), (-1, -2)]:
+        bounds = (start,) if end is None else (start, end)
+        assert Str(native).startswith("", *bounds) == native.startswith("", *bounds)
+        assert Str(native).endswith("", *bounds) == native.endswith("", *bounds)
+
+    with pytest.raises(TypeError):
+        big.find("abc", begin=1)
+    with pytest.raises(TypeError):
+        sz.hash("abc", seed=1)
+    for method in [big.count, big.startswith, big.endswith]:
+        with pytest.raises(TypeError):
+            method("abc", begin=1)
+    with pytest.raises(TypeError):
+        sz.count("abc", "a", overlap=True)
+
+
+def test_unit_gil_released_concurrency():
+    """Runs long operations from several threads, which release the GIL and use per-thread scratch space."""
+
+    haystack = "abc" * 1_000_000 + "xyz"
+    first = "".join(choice("ab") for _ in range(1200))
+    second = "".join(choice("ab") for _ in range(1100))
+    expected_distance = sz.edit_distance(first, second)
+
+    def work(_):
+        return (
+            sz.find(haystack, "xyz"),
+            sz.count(haystack, "abc"),
+            len(sz.split(haystack, "c")),
+            sz.edit_distance(first, second),
+        )
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        for result in pool.map(work, range(8)):
+            assert result == (3_000_000, 1_000_000, 1_000_001, expected_distance)
+
+
+def test_unit_shared_strs_concurrency():
+    """Sorts, shuffles, and reads the same `Strs` from several threads, which must never observe a torn layout."""
+
+    native_list = [get_random_string(variability=4, length=i % 7) for i in range(10_000)]
+    lines = Str("\n".join(native_list)).splitlines()
+    native_set = set(native_list)
+
+    def work(i):
+        if i % 4 == 0:
+            lines.sort(reverse=i % 8 == 4)
+        elif i % 4 == 1:
+            lines.shuffle(seed=i)
+        elif i % 4 == 2:
+            lines.__init__(native_list, copy=i % 8 == 2)
+        return all(str(line) in native_set for line in lines[: len(lines) // 2])
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        assert all(pool.map(work, range(16)))
+    assert sorted(native_list) == sorted(str(line) for line in lines)
+
+    # Re-initializing a `Str` could free its parent under concurrent readers, so it's rejected
+    s = Str("hello world")
+    with pytest.raises(TypeError):
+        s.__init__("goodbye", 0, 4)
+    assert str(s) == "hello world"
+    empty = Str()
+    empty.__init__("goodbye", 0, 4)
+    assert str(empty) == "good"
+
+
+@pytest.mark.parametrize("threads", [1, 3])
+def test_unit_strs_batch(threads: int):
+    """Batch operations over every element of `Strs` must match the loops over `Str` methods."""
+
+    native_list = [get_random_string(variability=3, length=i % 9) for i in range(20_000)]
+    lines = Str("\n".join(native_list)).splitlines()
+    for layout in ["consecutive", "reordered"]:
+        if layout == "reordered":
+            lines.shuffle(seed=7)
+            native_list = [str(line) for line in lines]
+
+        assert lines.find("ab", threads=threads).tolist() == [s.find("ab") for s in native_list]
+        assert lines.count("a", threads=threads).tolist() == [s.count("a") for s in native_list]
+        assert lines.count("aa", allowoverlap=True).tolist() == [
+            sz.count(s, "aa", allowoverlap=True) for s in native_list
+        ]
+        assert lines.startswith("a", threads=threads).tolist() == [s.startswith("a") for s in native_list]
+        assert lines.endswith("ba").tolist() == [s.endswith("ba") for s in native_list]
+        assert lines.hash(threads=threads).tolist() == [sz.hash(s) for s in native_list]
+        assert lines.lengths().tolist() == [len(s) for s in native_list]
+        assert lines.edit_distance("abc", threads=threads).tolist() == [sz.edit_distance(s, "abc") for s in native_list]
+        assert lines.edit_distance("abc", bound=2).tolist() == [
+            sz.edit_distance(s, "abc", bound=2) for s in native_list
+        ]
+
+    assert lines.find("a").format == "q" and lines.hash().format == "Q" and lines.startswith("a").format == "?"
+    assert len(Strs().lengths()) == 0
+    with pytest.raises(TypeError):
+        lines.find()
+    with pytest.raises(TypeError):
+        lines.find("a", bound=2)
+
+
+def test_unit_strs_membership():
+    """Membership tests and lookups, scanning small collections, and building a hash index for larger ones."""
+
+    for count in [5, 10_000]:
+        native_list = [get_random_string(variability=3, length=i % 6) for i in range(count)]
+        lines = Str("\n".join(native_list)).splitlines()
+        missing = "".join(native_list) + "-missing"
+        queries = native_list[:100] + [missing, "x"]
+
+        assert all(query in lines for query in native_list)
+        assert missing not in lines and 42 not in lines
+        assert lines.index_of(native_list[-1]) == native_list.index(native_list[-1])
+        assert lines.index_of(missing) == -1
+
+        expected = [native_list.index(q) if q in native_list else -1 for q in queries]
+        assert lines.index_of(queries).tolist() == expected
+        assert lines.index_of(Str("\n".join(queries)).splitlines()).tolist() == expected
+        assert lines.index_of([q.encode() for q in queries]).tolist() == expected
+
+        # The index is rebuilt after reordering
+        lines.shuffle(seed=1)
+        shuffled = [str(line) for line in lines]
+        assert lines.index_of(queries).tolist() == [shuffled.index(q) if q in shuffled else -1 for q in queries]
+        lines.sort()
+        native_sorted = sorted(native_list)
+        assert lines.index_of(queries).tolist() == [native_sorted.index(q) if q in shuffled else -1 for q in queries]
+
+    with pytest.raises(TypeError):
+        lines.index_of([1, 2])
+
+    # Lone surrogates can't be encoded into UTF-8, and the error must surface right away
+    for lookup in [lambda q: q in lines, lines.index_of, lambda q: lines.index_of([q])]:
+        with pytest.raises(UnicodeEncodeError):
+            lookup("\udc80")
+    assert lines.index_of(missing) == -1 and missing not in lines
+
+
+def test_unit_strs_from_sequence():
+    """Builds `Strs` from Python sequences, packing the strings into one buffer, or referencing them in place."""
+
+    native = ["beta", "", "alpha", "\u0434\u0435\u043b\u044c\u0442\u0430", "gamma"]
+    sources = [native[0], native[1].encode(), Str(native[2]), native[3], native[4].encode()]
+    for copy in [True, False]:
+        strs = Strs(sources, copy=copy)
+        assert len(strs) == len(native)
+        assert [str(s) for s in strs] == native
+        assert [str(s) for s in strs[1:4]] == native[1:4]
+        assert [str(s) for s in Strs.from_arrow(strs)] == native
+        assert strs.lengths().tolist() == [len(s.encode()) for s in native]
+        assert strs.index_of("alpha") == 2 and "gamma" in strs
+        assert list(strs.order()) == sorted(range(len(native)), key=lambda i: native[i].encode())
+        strs.sort()
+        assert [str(s) for s in strs] == sorted(native)
+        strs.shuffle(seed=42)
+        assert sorted(str(s) for s in strs) == sorted(native)
+
+    # Generators, empty inputs, and re-initialization
+    assert len(Strs()) == 0 and len(Strs([])) == 0 and len(Strs([], copy=False)) == 0
+    strs = Strs(s for s in native)
+    strs.__init__(native[:2], copy=False)
+    assert [str(s) for s in strs] == native[:2]
+
+    # Referenced strings outlive the sequence they came from
+    strs = Strs([get_random_string(length=100) for _ in range(1000)], copy=False)
+    native_list = [str(s) for s in strs]
+    strs.sort()
+    assert [str(s) for s in strs] == sorted(native_list)
+
+    with pytest.raises(TypeError):
+        Strs(["a", 1])
+    with pytest.raises(TypeError):
+        Strs(["a"], unknown=True)
+
+
+def test_unit_strs_save_load(tmp_path):
+    """Persists `Strs` in every layout, and maps them back without parsing."""
+
+    native = ["alpha", "", "beta", "gamma", "\u0434\u0435\u043b\u044c\u0442\u0430", ""]
+    layouts = {
+        "consecutive": Str("\n".join(native)).splitlines(),
+        "separated": Str(", ".join(native)).split(", "),
+        "sliced": Str("\n".join(native)).splitlines()[1:4],
+        "multi-source": Strs(native, copy=False),
+        "empty": Strs(),
+    }
+    for name, strs in layouts.items():
+        expected = [str(s) for s in strs]
+        path = str(tmp_path / f"{name}.strs")
+        strs.save(path)
+        loaded = Strs.load(path)
+        assert [str(s) for s in loaded] == expected
+        assert [str(s) for s in loaded[1:]] == expected[1:]
+        assert [str(s) for s in Strs.from_arrow(loaded)] == expected
+
+        # The offsets are borrowed from the mapping, so reordering must leave them untouched
+        loaded.sort()
+        assert [str(s) for s in loaded] == sorted(expected)
+        assert [str(s) for s in Strs.load(path)] == expected
+        loaded.__init__(["replaced"])
+        assert [str(s) for s in loaded] == ["replaced"]
+
+    not_strs = tmp_path / "not.strs"
+    not_strs.write_bytes(b"not a collection of strings" * 10)
+    with pytest.raises(ValueError):
+        Strs.load(str(not_strs))
+
+    # A decreasing offset in the middle is only caught by the linear-time validation
+    corrupted = tmp_path / "corrupted.strs"
+    Strs(["a", "bb", "ccc", "dddd"]).save(str(corrupted))
+    blob = bytearray(corrupted.read_bytes())
+    blob[64 + 4 * 2 : 64 + 4 * 3] = (1000).to_bytes(4, sys.byteorder)
+    corrupted.write_bytes(bytes(blob))
+    with pytest.raises(ValueError):
+        Strs.load(str(corrupted))
+    with pytest.raises(ValueError):
+        Strs.load(str(corrupted), True)
+    assert len(Strs.load(str(corrupted), validate=False)) == 4
+    with pytest.raises(TypeError):
+        Strs.load(str(corrupted), validate=False, unknown=True)
+    with pytest.raises(OSError):
+        Strs().save(str(tmp_path / "missing" / "directory.strs"))
+
+
+def test_unit_arrow_round_trip():
+    """Exports `Strs` through the Arrow PyCapsule Interface, and imports them back without copies."""
+
+    native = ["alpha", "", "beta", "gamma", "\u0434\u0435\u043b\u044c\u0442\u0430"]
+    for separator in ["\n", ", ", "\n\n\n"]:
+        lines = Str(separator.join(native)).split(separator)
+        assert [str(s) for s in Strs.from_arrow(lines)] == native
+        assert [str(s) for s in Strs.from_arrow(lines[1:4])] == native[1:4]
+        assert [str(s) for s in lines[1:4]] == native[1:4]
+
+        # Reordered layouts are compacted on export
+        lines.sort()
+        imported = Strs.from_arrow(lines)
+        del lines
+        assert [str(s) for s in imported] == sorted(native)
+
+    # Separators, kept in the strings, allow exporting them in-place
+    lines = Str("a\nbb\nccc").split("\n", keepseparator=True)
+    assert [str(s) for s in Strs.from_arrow(lines)] == ["a\n", "bb\n", "ccc"]
+    assert len(Strs.from_arrow(Str("").split("\n"))) == 1
+
+    with pytest.raises(TypeError):
+        Strs.from_arrow("not an array")
+
+
+def test_unit_arrow_pyarrow():
+    try:
+        import pyarrow as pa
+    except ImportError:
+        pytest.skip("PyArrow is not installed")
+
+    native = ["alpha", "", "beta", "gamma"]
+    lines = Str("\n".join(native)).split("\n")
+    array = pa.array(lines)
+    assert array.type == pa.string()
+    assert array.to_pylist() == native
+    assert pa.array(lines, type=pa.large_string()).to_pylist() == native
+    assert [str(s) for s in Strs.from_arrow(pa.array(native)[1:])] == native[1:]
+    assert [str(s) for s in Strs.from_arrow(pa.array(native, type=pa.large_binary()))] == native
+
 
 def test_unit_globals():
     """Validates that the previously unit-tested member methods are also visible as global functions."""
@@ -414,6 +783,10 @@ def test_fuzzy_sorting(list_length: int, part_length: int, variability: int):
             big_list[int(native_order[i])]
         ), "Split is wrong?!"
 
+    top_k = list_length // 3
+    top_order = big_list.order(top_k=top_k)
+    assert native_ordered[:top_k] == [native_list[i] for i in top_order]
+
     native_list.sort()
     big_list.sort()
 
@@ -39,9 +39,11 @@ def linux_settings() -> Tuple[List[str], List[str], List[Tuple[str]]]:
         "-Wno-incompatible-pointer-types",  # like: passing argument 4 of ‘sz_export_prefix_u32’ from incompatible pointer type
         "-Wno-discarded-qualifiers",  # like: passing argument 1 of ‘free’ discards ‘const’ qualifier from pointer target type
         "-fPIC",  # to enable dynamic dispatch
+        "-pthread",  # for multi-threaded sorting
     ]
     link_args = [
         "-fPIC",  # to enable dynamic dispatch
+        "-pthread",  # for multi-threaded sorting
     ]
 
     # GCC is our primary compiler, so when packaging the library, even if the current machine